@@ -0,0 +1,105 @@
+#include "anim.h"
+#include "charset.h"
+#include "display.h"
+#include "resultlog.h"
+#include "sched.h"
+#include "settings.h"
+#include "uart.h"
+
+static struct {
+  PGM_P pgm;          /* NULL when playing from the serial port */
+  bool failed;
+} in;
+
+
+static uint8_t nextByte(void) {
+  if (in.pgm) { return pgm_read_byte(in.pgm++); }
+  if (in.failed) { return 0; }
+  uint16_t start = schedMillis();
+  int16_t c;
+  while ((c = uartGetc()) < 0) {
+    if ((uint16_t)(schedMillis() - start) > ANIM_TIMEOUT_MS) {
+      in.failed = true;
+      return 0;
+    }
+  }
+  return c;
+}
+
+
+static void udcUpdate(void) {
+  uint8_t idx = nextByte();
+  uint8_t packed[ANIM_UDC_BYTES+1];
+  for (uint8_t i = 0; i < ANIM_UDC_BYTES; i++) { packed[i] = nextByte(); }
+  packed[ANIM_UDC_BYTES] = 0;
+  if (!disp.quirks.has_udc || idx > 0xF) { return; }
+  /* rows are 5 bits each, packed LSB-first */
+  uint8_t rows[7];
+  uint8_t bit = 0;
+  for (uint8_t row = 0; row < 7; row++) {
+    uint16_t pair = packed[bit >> 3] | (packed[(bit >> 3) + 1] << 8);
+    rows[row] = (pair >> (bit & 7)) & 0b00011111;
+    bit += 5;
+  }
+  setUserDefinedChar(idx, rows);
+}
+
+
+static void cell(uint8_t digit, uint8_t c) {
+  if (digit < disp.num_digits) { displayChar(digit, c); }
+}
+
+
+static bool playFrames(void) {
+  in.failed = false;
+  if (nextByte() != ANIM_MAGIC || nextByte() != ANIM_VERSION) { return false; }
+  uint8_t digits = nextByte();
+  uint8_t default_ms = nextByte();
+  uint16_t frames = nextByte();
+  frames |= nextByte() << 8;
+
+  uint16_t deadline = schedMillis();
+  while (frames-- && !in.failed) {
+    uint8_t flags = nextByte();
+    uint8_t ms = (flags & ANIM_FLAG_DURATION) ? nextByte() : default_ms;
+    if (flags & ANIM_FLAG_UDC) {
+      for (uint8_t n = nextByte(); n; n--) { udcUpdate(); }
+    }
+    if (flags & ANIM_FLAG_KEY) {
+      for (uint8_t digit = 0; digit < digits; digit++) { cell(digit, nextByte()); }
+    } else {
+      for (uint8_t n = flags & ANIM_CELLS_MASK; n; n--) {
+        uint8_t digit = nextByte();
+        cell(digit, nextByte());
+      }
+    }
+    /* hold the frame */
+    deadline += ms;
+    while ((int16_t)(deadline - (uint16_t)schedMillis()) > 0) {
+      settingsPoll();
+      resultlogPoll();
+      if (in.pgm && uartGetc() >= 0) { return false; }
+    }
+  }
+  return !in.failed;
+}
+
+
+static bool play(void) {
+  bool ok = playFrames();
+  /* the animation may have used UDCs 8-15 */
+  charsetLoadGlyphs();
+  return ok;
+}
+
+
+bool animPlay_P(PGM_P anim) {
+  in.pgm = anim;
+  return play();
+}
+
+
+bool animPlaySerial(void) {
+  in.pgm = NULL;
+  return play();
+}
@@ -0,0 +1,38 @@
+/**
+ * Animation player.
+ *
+ * Plays animations in the format written by tools/animenc.py (see there
+ * for the layout): a header, then per frame an optional duration, UDC
+ * bitmap updates, and either a keyframe of every digit or a list of just
+ * the cells that changed. Frames are decoded straight onto the display;
+ * frame deadlines come from the scheduler tick and accumulate, so decode
+ * time doesn't make playback drift.
+ *
+ * UDC updates are skipped on parts without user-defined characters, and
+ * digits beyond the display's width are dropped. An animation may use all
+ * 16 UDCs, so the fallback glyphs (charset.h, UDCs 8-15) are loaded again
+ * when it ends, however it ends.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <avr/pgmspace.h>
+
+#define ANIM_MAGIC          'A'
+#define ANIM_VERSION        1
+#define ANIM_FLAG_KEY       0b10000000
+#define ANIM_FLAG_UDC       0b01000000
+#define ANIM_FLAG_DURATION  0b00100000
+#define ANIM_CELLS_MASK     0b00011111
+#define ANIM_UDC_BYTES      5   /* 7 rows of 5 bits */
+
+/* a serial stream that stalls this long is abandoned */
+#define ANIM_TIMEOUT_MS     500
+
+/* Plays once; returns false if the data is not a valid animation or */
+/* a byte arrived from the host (which is consumed) */
+bool animPlay_P(PGM_P anim);
+/* Plays an animation sent over the serial port; returns false if it is */
+/* invalid or the stream stalls */
+bool animPlaySerial(void);
@@ -0,0 +1,295 @@
+#include "bitmap.h"
+#include "console.h"
+#include "display.h"
+#include "profile.h"
+#include "sched.h"
+
+#include <string.h>
+
+#define CELLS       (PANEL_ROWS*PANEL_COLS)
+#define CHIPS       (PANEL_ROWS*PANEL_CHIPS_PER_ROW)
+#define ALL_CHIPS   0xFFFF
+#define CHIP_WIDTH  (PANEL_CHIP_DIGITS*FONT_WIDTH)
+#define TILE_MASK   0b00011111
+/* what a cell shows for a blank tile */
+#define CODE_BLANK  ' '
+
+/* benchmark: size of the digits, and how much the counter steps by */
+#define BENCH_SCALE  4
+#define BENCH_STEP   37
+
+uint8_t bitmap_fb[BITMAP_HEIGHT][BITMAP_STRIDE];
+struct bitmap_stats bitmap_stats;
+
+/* what each cell shows: a code, and the tile that code draws */
+static uint8_t code[CELLS];
+static uint8_t shown[CELLS][FONT_ROWS];
+static uint16_t dirty_chips;
+/* where a flush that ran out of budget carries on */
+static uint8_t next_chip;
+
+
+/* Marks the chips under the rectangle (x0, y0)..(x1, y1) as changed */
+static void touch(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1) {
+  for (uint8_t row = y0/FONT_ROWS; row <= y1/FONT_ROWS; row++) {
+    for (uint8_t col = x0/CHIP_WIDTH; col <= x1/CHIP_WIDTH; col++) {
+      dirty_chips |= (uint16_t)1 << (row*PANEL_CHIPS_PER_ROW + col);
+    }
+  }
+}
+
+
+void bitmapBegin(void) {
+  /* the chips come out of reset showing spaces */
+  panelReset();
+  memset(code, CODE_BLANK, sizeof(code));
+  memset(shown, 0, sizeof(shown));
+  memset(&bitmap_stats, 0, sizeof(bitmap_stats));
+  bitmapClear();
+}
+
+
+void bitmapClear(void) {
+  memset(bitmap_fb, 0, sizeof(bitmap_fb));
+  dirty_chips = ALL_CHIPS;
+}
+
+
+void bitmapPixel(uint8_t x, uint8_t y, bool on) {
+  if (x >= BITMAP_WIDTH || y >= BITMAP_HEIGHT) { return; }
+  uint8_t bit = 0x80 >> (x & 7);
+  if (on) {
+    bitmap_fb[y][x >> 3] |= bit;
+  } else {
+    bitmap_fb[y][x >> 3] &= ~bit;
+  }
+  touch(x, y, x, y);
+}
+
+
+void bitmapFill(uint8_t x, uint8_t y, uint8_t w, uint8_t h, bool on) {
+  if (x >= BITMAP_WIDTH || y >= BITMAP_HEIGHT || !w || !h) { return; }
+  if (w > BITMAP_WIDTH - x) { w = BITMAP_WIDTH - x; }
+  if (h > BITMAP_HEIGHT - y) { h = BITMAP_HEIGHT - y; }
+  for (uint8_t row = y; row < y+h; row++) {
+    uint8_t *p = &bitmap_fb[row][x >> 3];
+    uint8_t from = x & 7;
+    uint8_t left = w;
+    /* a byte at a time */
+    while (left) {
+      uint8_t bits = 8 - from;
+      if (bits > left) { bits = left; }
+      uint8_t mask = (0xFF >> from) & ~(0xFF >> (from + bits));
+      if (on) {
+        *p |= mask;
+      } else {
+        *p &= ~mask;
+      }
+      p++;
+      left -= bits;
+      from = 0;
+    }
+  }
+  touch(x, y, x+w-1, y+h-1);
+}
+
+
+void bitmapScrollLeft(void) {
+  for (uint8_t y = 0; y < BITMAP_HEIGHT; y++) {
+    uint8_t *p = bitmap_fb[y];
+    for (uint8_t i = 0; i < BITMAP_STRIDE-1; i++) {
+      p[i] = (p[i] << 1) | (p[i+1] >> 7);
+    }
+    p[BITMAP_STRIDE-1] <<= 1;
+  }
+  dirty_chips = ALL_CHIPS;
+}
+
+
+void bitmapChar(uint8_t x, uint8_t y, uint8_t c, uint8_t scale) {
+  uint8_t rows[FONT_ROWS];
+  fontGlyph(c, rows);
+  bitmapFill(x, y, FONT_WIDTH*scale, FONT_ROWS*scale, false);
+  for (uint8_t row = 0; row < FONT_ROWS; row++) {
+    for (uint8_t col = 0; col < FONT_WIDTH; col++) {
+      if (rows[row] & (0x10 >> col)) {
+        bitmapFill(x + col*scale, y + row*scale, scale, scale, true);
+      }
+    }
+  }
+}
+
+
+/* The 5x7 tile of a cell, leftmost pixel in bit 4 (as UDCs take it) */
+static void tile(uint8_t cell, uint8_t rows[FONT_ROWS]) {
+  uint8_t x = (cell % PANEL_COLS)*FONT_WIDTH;
+  const uint8_t *p = &bitmap_fb[(cell / PANEL_COLS)*FONT_ROWS][x >> 3];
+  /* the tile's 5 bits end at bit "shift" of two bytes taken together */
+  uint8_t shift = 11 - (x & 7);
+  bool straddles = (x & 7) > 8 - FONT_WIDTH;
+  for (uint8_t row = 0; row < FONT_ROWS; row++) {
+    uint16_t w = p[0] << 8;
+    if (straddles) { w |= p[1]; }
+    rows[row] = (w >> shift) & TILE_MASK;
+    p += BITMAP_STRIDE;
+  }
+}
+
+
+static bool isBlank(const uint8_t rows[FONT_ROWS]) {
+  uint8_t any = 0;
+  for (uint8_t row = 0; row < FONT_ROWS; row++) { any |= rows[row]; }
+  return !any;
+}
+
+
+/* The code to show a tile with on digit "digit" of the chip whose first */
+/* cell is "first"; loads a UDC if no other digit of the chip has the tile */
+static uint8_t place(uint8_t first, uint8_t digit, const uint8_t rows[FONT_ROWS]) {
+  if (isBlank(rows)) {
+    bitmap_stats.blank++;
+    return CODE_BLANK;
+  }
+  uint16_t used = 0;
+  for (uint8_t d = 0; d < PANEL_CHIP_DIGITS; d++) {
+    uint8_t c = code[first + d];
+    if (!(c & CHAR_ATTR)) { continue; }
+    if (d != digit && !memcmp(shown[first + d], rows, FONT_ROWS)) {
+      bitmap_stats.shared++;
+      return c;
+    }
+    used |= (uint16_t)1 << (c & 0x0F);
+  }
+  /* at most 8 of the 16 UDCs are in use: load one nobody is showing */
+  uint8_t udc = 0;
+  while (used & 1) {
+    used >>= 1;
+    udc++;
+  }
+  setUserDefinedChar(udc, rows);
+  bitmap_stats.loaded++;
+  return CHAR_ATTR|udc;
+}
+
+
+/* Brings one chip up to date; false if the budget ran out first */
+static bool flushChip(uint8_t chip, uint8_t *budget) {
+  uint8_t first = (chip / PANEL_CHIPS_PER_ROW)*PANEL_COLS +
+                  (chip % PANEL_CHIPS_PER_ROW)*PANEL_CHIP_DIGITS;
+  bool selected = false;
+  for (uint8_t digit = 0; digit < PANEL_CHIP_DIGITS; digit++) {
+    uint8_t cell = first + digit;
+    uint8_t rows[FONT_ROWS];
+    tile(cell, rows);
+    if (!memcmp(rows, shown[cell], FONT_ROWS)) { continue; }
+    if (!*budget) { return false; }
+    (*budget)--;
+    if (!selected) {
+      panelSelect(chip);
+      selected = true;
+    }
+    code[cell] = place(first, digit, rows);
+    memcpy(shown[cell], rows, FONT_ROWS);
+    displayChar(digit, code[cell]);
+  }
+  return true;
+}
+
+
+bool bitmapFlush(uint8_t budget) {
+  if (!panelReady()) { return false; }
+  PROF_BEGIN();
+  for (uint8_t n = 0; n < CHIPS && dirty_chips; n++) {
+    uint16_t bit = (uint16_t)1 << next_chip;
+    if (dirty_chips & bit) {
+      if (!flushChip(next_chip, &budget)) { break; }
+      dirty_chips &= ~bit;
+    }
+    next_chip = (next_chip + 1) % CHIPS;
+  }
+  PROF_END(PROF_FLUSH);
+  return dirty_chips == 0;
+}
+
+
+/* --- benchmark --- */
+
+static uint8_t graph_y;
+static uint8_t graph_rand;
+static char counter[BITMAP_WIDTH/(FONT_WIDTH*BENCH_SCALE)];
+static char counter_drawn[sizeof(counter)];
+
+
+/* A random walk scrolling in from the right, one column a frame */
+static void graphFrame(void) {
+  /* 8-bit xorshift */
+  graph_rand ^= graph_rand << 3;
+  graph_rand ^= graph_rand >> 5;
+  graph_rand ^= graph_rand << 4;
+  uint8_t y = graph_y;
+  if (graph_rand & 0x01) {
+    if (y > 0) { y--; }
+  } else if (graph_rand & 0x02) {
+    if (y < BITMAP_HEIGHT-1) { y++; }
+  }
+  if (graph_rand & 0x04) {
+    /* an occasional jump */
+    y = (y + (graph_rand >> 4)) % BITMAP_HEIGHT;
+  }
+  bitmapScrollLeft();
+  uint8_t top = (y < graph_y) ? y : graph_y;
+  uint8_t bottom = (y < graph_y) ? graph_y : y;
+  bitmapFill(BITMAP_WIDTH-1, top, 1, bottom - top + 1, true);
+  graph_y = y;
+}
+
+
+/* An 8-digit counter at 4x size, only redrawing the digits that changed */
+static void numbersFrame(void) {
+  uint8_t carry = BENCH_STEP;
+  for (int8_t i = sizeof(counter)-1; i >= 0 && carry; i--) {
+    uint8_t d = counter[i] - '0' + carry;
+    carry = 0;
+    while (d >= 10) {
+      d -= 10;
+      carry++;
+    }
+    counter[i] = '0' + d;
+  }
+  for (uint8_t i = 0; i < sizeof(counter); i++) {
+    if (counter[i] != counter_drawn[i]) {
+      bitmapChar(i*FONT_WIDTH*BENCH_SCALE, 0, counter[i], BENCH_SCALE);
+      counter_drawn[i] = counter[i];
+    }
+  }
+}
+
+
+static void bench(void (*frame)(void), struct bitmap_bench *result) {
+  bitmapBegin();
+  while (!bitmapFlush(0xFF)) {}
+  uint32_t start = schedMillis();
+  for (uint16_t n = 0; n < BITMAP_BENCH_FRAMES; n++) {
+    frame();
+    while (!bitmapFlush(0xFF)) {}
+  }
+  result->ms = schedMillis() - start;
+  result->frames = BITMAP_BENCH_FRAMES;
+  result->stats = bitmap_stats;
+}
+
+
+void bitmapBenchmark(void) {
+  struct bitmap_bench results[2];
+  panelInit();
+  graph_y = BITMAP_HEIGHT/2;
+  graph_rand = 1;
+  bench(graphFrame, &results[0]);
+  memset(counter, '0', sizeof(counter));
+  memset(counter_drawn, 0, sizeof(counter_drawn));
+  bench(numbersFrame, &results[1]);
+  panelReset();
+  consoleFrameBegin('G', sizeof(results));
+  consoleFrameData(results, sizeof(results));
+  consoleFrameEnd();
+}
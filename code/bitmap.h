@@ -0,0 +1,77 @@
+/**
+ * Pixel graphics on the 4x4 PDSP1881 panel (see panel.h).
+ *
+ * The panel's 128 character cells are treated as one 160x28 monochrome
+ * bitmap (the gaps between characters are not part of it). Drawing goes
+ * into a 1-bit-per-pixel framebuffer; bitmapFlush() cuts it into 5x7
+ * tiles, one per cell, and shows each tile through a user-defined
+ * character of the cell's chip.
+ *
+ * Only tiles that differ from what the cell shows are written. A blank
+ * tile is shown as the ROM space and needs no UDC; a tile that another
+ * cell of the same chip already shows (a solid block, the same digit
+ * stroke, ...) shares that cell's UDC. Anything else is loaded into a UDC
+ * no cell is showing (a chip has 16 for its 8 cells, so there is always
+ * one) and the cell then switched over to it, so a cell never shows a
+ * half-loaded glyph. A new tile costs 9 bus writes, a shared or blank one
+ * a single write.
+ *
+ * Bitmap mode takes all 16 UDCs of every chip, including the fallback
+ * glyphs (see charset.h): call panelReset() before using the panel as
+ * text again.
+ *
+ * bitmapBenchmark() (console command 'G', tools/tester.py PORT bitmap)
+ * draws a scrolling graph and large-font numbers and reports the frame
+ * rates achieved.
+ */
+#pragma once
+
+#include "font.h"
+#include "panel.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define BITMAP_WIDTH   (PANEL_COLS*FONT_WIDTH)
+#define BITMAP_HEIGHT  (PANEL_ROWS*FONT_ROWS)
+#define BITMAP_STRIDE  (BITMAP_WIDTH/8)
+
+/* frames drawn by each part of the benchmark */
+#define BITMAP_BENCH_FRAMES  200
+
+/* Pixel (x, y) is bit 7-(x%8) of bitmap_fb[y][x/8]; (0, 0) is top left */
+extern uint8_t bitmap_fb[BITMAP_HEIGHT][BITMAP_STRIDE];
+
+/* How the changed tiles were shown, counted since bitmapBegin() */
+struct bitmap_stats {
+  uint16_t loaded;     /* into a UDC */
+  uint16_t shared;     /* with another cell's UDC */
+  uint16_t blank;      /* as the ROM space */
+};
+
+extern struct bitmap_stats bitmap_stats;
+
+/* Frame 'G' holds one of these for each part of the benchmark: the */
+/* scrolling graph, then the numbers */
+struct bitmap_bench {
+  uint16_t frames;
+  uint32_t ms;                 /* drawing and flushing them all */
+  struct bitmap_stats stats;
+};
+
+/* Takes over the panel (resetting it) with a blank bitmap */
+void bitmapBegin(void);
+void bitmapClear(void);
+void bitmapPixel(uint8_t x, uint8_t y, bool on);
+/* Sets or clears a w x h rectangle, clipped to the bitmap */
+void bitmapFill(uint8_t x, uint8_t y, uint8_t w, uint8_t h, bool on);
+/* Moves everything one pixel left; the rightmost column becomes blank */
+void bitmapScrollLeft(void);
+/* Draws character c of the 5x7 font at (x, y), each dot scale x scale */
+/* pixels, over a blank background */
+void bitmapChar(uint8_t x, uint8_t y, uint8_t c, uint8_t scale);
+/* Writes at most "budget" changed tiles; returns true if the panel shows */
+/* the whole bitmap */
+bool bitmapFlush(uint8_t budget);
+/* Runs the benchmark, then sends frame 'G' and resets the panel */
+void bitmapBenchmark(void);
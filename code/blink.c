@@ -0,0 +1,68 @@
+#include "blink.h"
+#include "console.h"
+#include "display.h"
+#include "pins.h"
+#include "resultlog.h"
+#include "sched.h"
+#include "settings.h"
+#include "pin_xmega.h"
+
+static uint16_t syncs;
+static uint32_t synced_at;
+
+
+void blinkSync(void) {
+  if (!disp.quirks.controlreg_pd2816 && !disp.quirks.controlreg_hdsp2xxx) {
+    return;
+  }
+  /* the reset clears all of it except the UDCs */
+  uint8_t chars[8];
+  for (uint8_t i = 0; i < sizeof(chars); i++) { chars[i] = disp_shadow.chars[i]; }
+  uint8_t control = disp_shadow.control;
+  uint8_t cursor = disp_shadow.cursor;
+  uint8_t flash = disp_shadow.flash;
+  /* EEPROM writes keep going during the ~CLR pulse */
+  resetStart(RESET_HARD);
+  while (!resetPoll()) {
+    settingsPoll();
+    resultlogPoll();
+  }
+  for (uint8_t pos = 0; pos < disp.num_digits; pos++) {
+    displayChar(pos, chars[pos]);
+  }
+  if (disp.quirks.controlreg_hdsp2xxx) {
+    setFlashMask(flash);
+    /* don't start another self test */
+    control &= ~(CR_HDSP_SELF_TEST_START|CR_HDSP_SELF_TEST_RESULT);
+  }
+  if (disp.quirks.has_cursor) {
+    setCursorMask(cursor);
+  }
+  /* blinking starts again here */
+  writeControlRegister(control);
+  syncs++;
+  synced_at = schedMillis();
+}
+
+
+void blinkReport(void) {
+  struct blink_status s;
+  s.syncs = syncs;
+  s.since_ms = syncs ? schedMillis() - synced_at : 0;
+  /* count rising edges of whichever clock is running */
+  uint16_t hdsp = 0, pd2816 = 0;
+  bool hdsp_was = pin_is_high(HDSPCLK), pd2816_was = pin_is_high(PD2816CLK);
+  uint32_t start = schedMillis();
+  while (schedMillis() - start < BLINK_MEASURE_MS) {
+    bool h = pin_is_high(HDSPCLK), p = pin_is_high(PD2816CLK);
+    if (h && !hdsp_was) { hdsp++; }
+    if (p && !pd2816_was) { pd2816++; }
+    hdsp_was = h;
+    pd2816_was = p;
+  }
+  uint16_t edges = (hdsp > pd2816) ? hdsp : pd2816;
+  s.clock_hz = (uint32_t)edges * (1000/BLINK_MEASURE_MS);
+  consoleFrameBegin('Y', sizeof(s));
+  consoleFrameData(&s, sizeof(s));
+  consoleFrameEnd();
+}
@@ -0,0 +1,45 @@
+/**
+ * Blink phase synchronization.
+ *
+ * Flashing characters (HDSP-2xxx/PDSP188x flash RAM, PD2816 character and
+ * underline blink, whole-display blink) are timed by
+ * counters in each part, and only a reset through ~CLR starts them from a
+ * known phase. The 16 chips of the panel already share one clock (DCLK:
+ * one chip has CLS high and drives it, the others run from it) and one
+ * ~DRST, so a single pulse puts them all in phase and they stay there;
+ * DCLK doesn't reach the panel header, so the tester can't drive it
+ * anyway. What drifts apart is separate boards on a ring, each with its
+ * own panel or part on its own clock.
+ *
+ * blinkSync() pulses ~CLR (~DRST on the panel) and puts back what the part
+ * was showing from disp_shadow: characters, control word, flash RAM and
+ * cursors. UDC RAM survives a reset. The display is dark for the
+ * datasheet reset pulse (RESET_PULSE_US) and nothing else is lost.
+ * panelSync() (panel.h) does the same for the panel. On a ring, the host
+ * broadcasts 'Y' with a delay, as for 'F' (net.h), so every board resets
+ * at the same moment; "tools/tester.py PORT sync --every S" repeats it.
+ *
+ * Drift is reported as frame 'Y' (console command 'Y'):
+ *   syncs (2 bytes), ms since the last sync (4 bytes),
+ *   part clock in Hz (4 bytes; 0 if no clock reaches the tester)
+ * The clock is counted on HDSPCLK/PD2816CLK for BLINK_MEASURE_MS against
+ * the tester's own (uncalibrated) oscillator; the difference between two
+ * boards' clocks, times the time since the last sync, is how far their
+ * blink phases have drifted apart.
+ */
+#pragma once
+
+#include <stdint.h>
+
+#define BLINK_MEASURE_MS  100
+
+struct blink_status {
+  uint16_t syncs;
+  uint32_t since_ms;
+  uint32_t clock_hz;
+};
+
+/* Parts without blinking are left alone */
+void blinkSync(void);
+/* Counts the part's clock and sends frame 'Y' */
+void blinkReport(void);
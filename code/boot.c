@@ -0,0 +1,61 @@
+#include "boot.h"
+#include "console.h"
+#include "pins.h"
+#include "sched.h"
+#include "settings.h"
+#include "pin_xmega.h"
+
+static struct boot_times times = { 0, BOOT_NO_TIME, BOOT_NO_TIME };
+
+
+/* Types that detection finds when they are inserted */
+static bool detectable(enum display_type type) {
+  return type == HDSP2xxx || type == PD2816;
+}
+
+
+static void showFrame(void) {
+  for (uint8_t pos = 0; pos < disp.num_digits; pos++) {
+    displayChar(pos, settings.last_frame[pos]);
+  }
+}
+
+
+bool bootInstantOn(void) {
+  if (!(settings.flags & SETTINGS_LAST_FRAME) ||
+      settings.display_type >= NUM_DISPLAY_TYPES) {
+    pin_output_low(nCLR);
+    return false;
+  }
+  pin_output_high(nCLR);
+  /* soft resets: through the control register where there is one */
+  /* (120us), otherwise just cursors and blanking; the frame covers */
+  /* every character */
+  setDisplayType(settings.display_type);
+  showFrame();
+  times.frame_us = schedMicros();
+  times.flags = BOOT_INSTANT;
+  return true;
+}
+
+
+bool bootConfirm(enum display_type found) {
+  times.detect_us = schedMicros();
+  enum display_type cached = settings.display_type;
+  if (found == cached || (found == NUM_DISPLAY_TYPES && !detectable(cached))) {
+    times.flags |= BOOT_CONFIRMED;
+    return true;
+  }
+  /* another part: its RAM was never cleared */
+  settings.flags &= ~SETTINGS_LAST_FRAME;
+  settingsSave();
+  hardResetDisplay();
+  return false;
+}
+
+
+void bootReport(void) {
+  consoleFrameBegin('B', sizeof(times));
+  consoleFrameData(&times, sizeof(times));
+  consoleFrameEnd();
+}
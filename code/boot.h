@@ -0,0 +1,57 @@
+/**
+ * Instant-on boot for boards deployed on a ring (see net.h).
+ *
+ * A board on a ring keeps the last frame committed to its display in the
+ * settings record (settings.last_frame, with the display type it was
+ * shown on in settings.display_type). At powerup that frame is shown on
+ * the cached type straight away: ~CLR is never pulsed (the control word,
+ * cursors and every character the frame covers are written instead), and
+ * nothing waits on a fixed delay. Detection runs afterwards and either
+ * confirms the type, or finds another part inserted, resets the display
+ * and forgets the frame. The board then keeps showing the frame (and the
+ * host's updates) until a button is pressed, and only then shows the
+ * detected part or the menu.
+ *
+ * The settings journal has only a few slots, so a frame is saved only
+ * once it has been shown for FRAME_IDLE_MS without a newer commit, and at
+ * most once per FRAME_SAVE_MS (net.c): a board that keeps getting frames
+ * boots with one that stayed up a while, not necessarily the newest. A
+ * bench test overwrites settings.display_type and so forgets the frame.
+ *
+ * Only the display's frame is kept. Panel frames (net.h) are not: they
+ * don't fit the settings record, and once a board has driven its panel
+ * its disp_shadow describes the last panel chip written, so nothing is
+ * saved after that and the board boots with the last display frame from
+ * before the panel was used.
+ *
+ * Boot times, in microseconds since the tick timer started (schedInit()),
+ * are sent as frame 'B' (console command 'B'):
+ *   flags (BOOT_*), frame shown (2 bytes), detection done (2 bytes)
+ * A time is 0xFFFF if that step didn't happen.
+ */
+#pragma once
+
+#include "display.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define BOOT_INSTANT    0b00000001  /* the last frame was shown */
+#define BOOT_CONFIRMED  0b00000010  /* detection didn't contradict the cached type */
+
+#define BOOT_NO_TIME    0xFFFF
+
+struct boot_times {
+  uint8_t flags;
+  uint16_t frame_us;
+  uint16_t detect_us;
+};
+
+/* Shows the cached frame if there is one; false if there isn't, and the */
+/* display must be hard reset as usual. Call once a0_a1_not_swapped is set. */
+bool bootInstantOn(void);
+/* Detection result (NUM_DISPLAY_TYPES for none): true if the frame is */
+/* still shown on the cached type, false if the display was reset */
+bool bootConfirm(enum display_type found);
+/* Sends frame 'B' */
+void bootReport(void);
@@ -0,0 +1,77 @@
+#include "capture.h"
+#include "console.h"
+#include "display.h"
+
+#include <string.h>
+
+
+bool captureRead(struct capture_device *d) {
+  d->control = disp_shadow.control;
+  d->cursor = disp.quirks.has_cursor ? disp_shadow.cursor : 0;
+  d->flash = disp.quirks.controlreg_hdsp2xxx ? disp_shadow.flash : 0;
+  memset(d->chars, ' ', sizeof(d->chars));
+  memcpy(d->chars, disp_shadow.chars, disp.num_digits);
+  if (disp.quirks.has_read) {
+    d->control = readControlRegister();
+    for (uint8_t pos = 0; pos < disp.num_digits; pos++) {
+      d->chars[pos] = readChar(pos);
+    }
+    if (disp.quirks.controlreg_hdsp2xxx) { d->flash = readFlashMask(); }
+  }
+  d->udcs = 0;
+  if (disp.quirks.has_udc) {
+    for (uint8_t pos = 0; pos < disp.num_digits; pos++) {
+      uint8_t c = d->chars[pos];
+      if (c & CHAR_ATTR) { d->udcs |= 1 << (c & 0x0F); }
+    }
+  }
+  return disp.quirks.has_read;
+}
+
+
+static uint8_t popcount16(uint16_t v) {
+  uint8_t n = 0;
+  for (; v; v &= v-1) { n++; }
+  return n;
+}
+
+
+void captureSend(const struct capture_device *devs, uint8_t ndevs, uint8_t flags,
+                 capture_udc_fn udc) {
+  uint8_t digits = disp.num_digits;
+  uint16_t len = 5;
+  for (uint8_t dev = 0; dev < ndevs; dev++) {
+    len += 3 + digits + 1 + popcount16(devs[dev].udcs)*8;
+  }
+  uint8_t hdr[5] = { CAPTURE_VERSION, disp_type, flags, ndevs, digits };
+  consoleFrameBegin('C', len);
+  consoleFrameData(hdr, sizeof(hdr));
+  for (uint8_t dev = 0; dev < ndevs; dev++) {
+    const struct capture_device *d = &devs[dev];
+    consoleFrameData(d, 3);
+    consoleFrameData(d->chars, digits);
+    uint8_t n = popcount16(d->udcs);
+    consoleFrameData(&n, 1);
+    for (uint8_t idx = 0; idx < 16; idx++) {
+      if (!(d->udcs & (1 << idx))) { continue; }
+      uint8_t rows[7];
+      udc(dev, idx, rows);
+      consoleFrameData(&idx, 1);
+      consoleFrameData(rows, sizeof(rows));
+    }
+  }
+  consoleFrameEnd();
+}
+
+
+static void shadowUdc(uint8_t dev, uint8_t idx, uint8_t rows[7]) {
+  (void)dev;
+  memcpy(rows, disp_shadow.udc[idx], 7);
+}
+
+
+void captureDisplay(void) {
+  struct capture_device d;
+  uint8_t flags = captureRead(&d) ? CAPTURE_READBACK : 0;
+  captureSend(&d, 1, flags, shadowUdc);
+}
@@ -0,0 +1,49 @@
+/**
+ * Snapshots: what a display is showing, sent to the host as frame 'C'.
+ *
+ * Parts that can be read (HDSP-2xxx, PD2816) have their character RAM and
+ * control word read back over the bus, and HDSP-2xxx their flash RAM, so
+ * the snapshot shows what the part really holds. Everything else (all of
+ * it on parts without a read line, and the UDC bitmaps and cursors on
+ * every part) comes from what the tester last wrote (disp_shadow).
+ *
+ * Frame 'C' payload:
+ *   version (1), display type, flags, device count, digits per device
+ *   per device, leftmost first:
+ *     control word, cursor mask, flash mask (bit n = digit n),
+ *     one character code per digit,
+ *     UDC count, then per UDC: index, 7 rows (leftmost pixel in bit 4)
+ * Only the UDCs that some digit shows are sent. Flags: bit 0 the
+ * characters and control word were read back, bit 1 the devices are the
+ * 16 chips of the panel (row-major, see panel.h).
+ *
+ * tools/snapshot.py renders a snapshot as text or a PNG image.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CAPTURE_VERSION    1
+#define CAPTURE_READBACK   0b00000001
+#define CAPTURE_PANEL      0b00000010
+
+struct capture_device {
+  uint8_t control;
+  uint8_t cursor;
+  uint8_t flash;
+  uint8_t chars[8];
+  uint16_t udcs;     /* bit n: UDC n is shown */
+};
+
+/* Rows of UDC idx of device dev */
+typedef void (*capture_udc_fn)(uint8_t dev, uint8_t idx, uint8_t rows[7]);
+
+/* Snapshot of the display under test */
+void captureDisplay(void);
+
+/* Building blocks for multi-device snapshots (panelCapture()): */
+/* reads the currently selected device; returns true if it was read back */
+bool captureRead(struct capture_device *d);
+void captureSend(const struct capture_device *devs, uint8_t ndevs, uint8_t flags,
+                 capture_udc_fn udc);
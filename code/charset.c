@@ -0,0 +1,89 @@
+#include "charset.h"
+#include "display.h"
+
+#include "charset_tables.h"
+
+_Static_assert(CHARSET_GLYPH_COUNT <= 16-CHARSET_UDC_FIRST,
+               "fallback glyphs must fit in UDCs 8-15");
+
+static PGM_P const tables[NUM_CHARSETS] = {
+  [CHARSET_SEG64] = (PGM_P)charset_seg64,
+  [CHARSET_SEG95] = (PGM_P)charset_seg95,
+  [CHARSET_DOT]   = (PGM_P)charset_dot,
+  [CHARSET_HDSP]  = (PGM_P)charset_hdsp,
+};
+
+PGM_P charset = (PGM_P)charset_seg64;
+
+
+void charsetSelect(enum charset_id id) {
+  charset = tables[id];
+}
+
+
+void charsetLoadGlyphs(void) {
+  if (!disp.quirks.controlreg_hdsp2xxx) { return; }
+  for (uint8_t i = 0; i < CHARSET_GLYPH_COUNT; i++) {
+    setUserDefinedChar_P(CHARSET_UDC_FIRST+i, charset_glyphs, i*7);
+  }
+}
+
+
+bool charsetGlyph(uint8_t code, uint8_t rows[7]) {
+  uint8_t i = code - CHARSET_UDC_CODE;
+  if (i >= CHARSET_GLYPH_COUNT) { return false; }
+  /* rows are 5 bits each, packed LSB-first */
+  uint16_t bit = i*7*5;
+  for (uint8_t row = 0; row < 7; row++) {
+    rows[row] = (pgm_read_word(charset_glyphs + (bit >> 3)) >> (bit & 7)) & 0b00011111;
+    bit += 5;
+  }
+  return true;
+}
+
+
+/* Latin-1 character for a code point above U+00FF */
+static uint8_t alias(uint16_t cp) {
+  for (uint8_t i = 0; i < CHARSET_ALIAS_COUNT; i++) {
+    uint16_t a = pgm_read_word(&charset_aliases[i].cp);
+    if (a == cp) { return pgm_read_byte(&charset_aliases[i].c); }
+    if (a > cp) { break; }
+  }
+  return CHARSET_UNKNOWN;
+}
+
+
+bool utf8Decode(struct utf8 *u, uint8_t b, uint8_t *c) {
+  if (b < 0x80) {
+    /* also ends an incomplete sequence, which is dropped */
+    u->need = 0;
+    *c = b;
+    return true;
+  }
+  if (b < 0xC0) {
+    if (u->need == 0) {
+      *c = CHARSET_UNKNOWN;
+      return true;
+    }
+    /* anything above U+FFFF is unknown; 0xFFFF marks it */
+    if (u->cp != 0xFFFF) { u->cp = (u->cp << 6) | (b & 0x3F); }
+    if (--u->need) { return false; }
+    *c = (u->cp < 0x100) ? u->cp : alias(u->cp);
+    return true;
+  }
+  if (b < 0xE0) {
+    u->cp = b & 0x1F;
+    u->need = 1;
+  } else if (b < 0xF0) {
+    u->cp = b & 0x0F;
+    u->need = 2;
+  } else if (b < 0xF8) {
+    u->cp = 0xFFFF;
+    u->need = 3;
+  } else {
+    u->need = 0;
+    *c = CHARSET_UNKNOWN;
+    return true;
+  }
+  return false;
+}
@@ -0,0 +1,62 @@
+/**
+ * Character-set translation: Latin-1 (and UTF-8) text to the codes each
+ * part displays (charset.def, built into charset_tables.h by
+ * tools/mkcharset.py).
+ *
+ * Every part has a 256-entry table, selected by setDisplayType(), that
+ * gives the code to write for each Latin-1 character: itself if the ROM
+ * has it, the uppercase letter on parts without lowercase, an unaccented
+ * or look-alike character, a fallback glyph in a user-defined character
+ * (HDSP-2xxx), or '?'. Mapping a character is one table read.
+ *
+ * The fallback glyphs live in UDCs 8-15, which the marquee and the panel
+ * leave alone (they use UDC n for digit n); charsetLoadGlyphs() loads them.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <avr/pgmspace.h>
+
+/* Code of the first fallback glyph (UDC 8) */
+#define CHARSET_UDC_FIRST  8
+#define CHARSET_UDC_CODE   (0x80|CHARSET_UDC_FIRST)
+/* Latin-1 character the UTF-8 decoder returns for anything it can't map */
+#define CHARSET_UNKNOWN    0x1A
+
+enum charset_id {
+  CHARSET_SEG64,  /* ' '..'_', lowercase folded to uppercase */
+  CHARSET_SEG95,  /* ' '..'~' */
+  CHARSET_DOT,    /* ' '..'~' (ROM characters below ' ' aren't used) */
+  CHARSET_HDSP,   /* ' '..'~' and fallback glyphs */
+  NUM_CHARSETS
+};
+
+struct charset_alias {
+  uint16_t cp;
+  uint8_t c;
+};
+
+/* UTF-8 decoder state; zero-initialize */
+struct utf8 {
+  uint16_t cp;
+  uint8_t need;   /* continuation bytes still expected */
+};
+
+/* Table for the display under test */
+extern PGM_P charset;
+
+static inline uint8_t charsetMap(uint8_t c) {
+  return pgm_read_byte(charset + c);
+}
+
+void charsetSelect(enum charset_id id);
+/* HDSP-2xxx: loads the fallback glyphs into UDCs 8-15 (of the selected */
+/* chip, on the panel); does nothing on other parts */
+void charsetLoadGlyphs(void);
+/* Fallback glyph for a code CHARSET_UDC_CODE..; false for other codes */
+bool charsetGlyph(uint8_t code, uint8_t rows[7]);
+
+/* Feeds one byte of UTF-8; returns true when a character is complete and */
+/* stores it in *c as Latin-1 (CHARSET_UNKNOWN if it has no equivalent) */
+bool utf8Decode(struct utf8 *u, uint8_t b, uint8_t *c);
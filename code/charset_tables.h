@@ -0,0 +1,113 @@
+/* Generated by tools/mkcharset.py from charset.def -- do not edit. */
+/*
+ *   seg64     64 direct,  14 Latin-1 unknown
+ *   seg95     95 direct,  13 Latin-1 unknown
+ *   dot       95 direct,  13 Latin-1 unknown
+ *   hdsp      95 direct,  13 Latin-1 unknown
+ *   8 glyphs, 11 aliases
+ */
+#pragma once
+
+#define CHARSET_GLYPH_COUNT 8
+#define CHARSET_ALIAS_COUNT 11
+
+/* seg64: 20-5F, fold */
+static const uint8_t charset_seg64[256] PROGMEM = {
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3F, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F,
+  0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0x3E, 0x3F,
+  0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4A, 0x4B, 0x4C, 0x4D, 0x4E, 0x4F,
+  0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x5B, 0x5C, 0x5D, 0x5E, 0x5F,
+  0x20, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4A, 0x4B, 0x4C, 0x4D, 0x4E, 0x4F,
+  0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x21, 0x43, 0x4C, 0x3F, 0x59, 0x3F, 0x3F, 0x3F, 0x43, 0x3F, 0x3C, 0x2D, 0x2D, 0x52, 0x3F,
+  0x4F, 0x2B, 0x32, 0x33, 0x3F, 0x55, 0x3F, 0x2E, 0x3F, 0x31, 0x3F, 0x3E, 0x3F, 0x3F, 0x3F, 0x3F,
+  0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x43, 0x45, 0x45, 0x45, 0x45, 0x49, 0x49, 0x49, 0x49,
+  0x44, 0x4E, 0x4F, 0x4F, 0x4F, 0x4F, 0x4F, 0x58, 0x4F, 0x55, 0x55, 0x55, 0x55, 0x59, 0x50, 0x53,
+  0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x43, 0x45, 0x45, 0x45, 0x45, 0x49, 0x49, 0x49, 0x49,
+  0x44, 0x4E, 0x4F, 0x4F, 0x4F, 0x4F, 0x4F, 0x2F, 0x4F, 0x55, 0x55, 0x55, 0x55, 0x59, 0x50, 0x59,
+};
+
+/* seg95: 20-7E */
+static const uint8_t charset_seg95[256] PROGMEM = {
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3F, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F,
+  0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0x3E, 0x3F,
+  0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4A, 0x4B, 0x4C, 0x4D, 0x4E, 0x4F,
+  0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x5B, 0x5C, 0x5D, 0x5E, 0x5F,
+  0x60, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6A, 0x6B, 0x6C, 0x6D, 0x6E, 0x6F,
+  0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x7B, 0x7C, 0x7D, 0x7E, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x21, 0x63, 0x4C, 0x3F, 0x59, 0x7C, 0x3F, 0x3F, 0x43, 0x3F, 0x3C, 0x2D, 0x2D, 0x52, 0x3F,
+  0x6F, 0x2B, 0x32, 0x33, 0x3F, 0x75, 0x3F, 0x2E, 0x3F, 0x31, 0x3F, 0x3E, 0x3F, 0x3F, 0x3F, 0x3F,
+  0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x43, 0x45, 0x45, 0x45, 0x45, 0x49, 0x49, 0x49, 0x49,
+  0x44, 0x4E, 0x4F, 0x4F, 0x4F, 0x4F, 0x4F, 0x78, 0x4F, 0x55, 0x55, 0x55, 0x55, 0x59, 0x50, 0x73,
+  0x61, 0x61, 0x61, 0x61, 0x61, 0x61, 0x61, 0x63, 0x65, 0x65, 0x65, 0x65, 0x69, 0x69, 0x69, 0x69,
+  0x64, 0x6E, 0x6F, 0x6F, 0x6F, 0x6F, 0x6F, 0x2F, 0x6F, 0x75, 0x75, 0x75, 0x75, 0x79, 0x70, 0x79,
+};
+
+/* dot: 20-7E */
+static const uint8_t charset_dot[256] PROGMEM = {
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3F, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F,
+  0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0x3E, 0x3F,
+  0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4A, 0x4B, 0x4C, 0x4D, 0x4E, 0x4F,
+  0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x5B, 0x5C, 0x5D, 0x5E, 0x5F,
+  0x60, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6A, 0x6B, 0x6C, 0x6D, 0x6E, 0x6F,
+  0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x7B, 0x7C, 0x7D, 0x7E, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x21, 0x63, 0x4C, 0x3F, 0x59, 0x7C, 0x3F, 0x3F, 0x43, 0x3F, 0x3C, 0x2D, 0x2D, 0x52, 0x3F,
+  0x6F, 0x2B, 0x32, 0x33, 0x3F, 0x75, 0x3F, 0x2E, 0x3F, 0x31, 0x3F, 0x3E, 0x3F, 0x3F, 0x3F, 0x3F,
+  0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x41, 0x43, 0x45, 0x45, 0x45, 0x45, 0x49, 0x49, 0x49, 0x49,
+  0x44, 0x4E, 0x4F, 0x4F, 0x4F, 0x4F, 0x4F, 0x78, 0x4F, 0x55, 0x55, 0x55, 0x55, 0x59, 0x50, 0x73,
+  0x61, 0x61, 0x61, 0x61, 0x61, 0x61, 0x61, 0x63, 0x65, 0x65, 0x65, 0x65, 0x69, 0x69, 0x69, 0x69,
+  0x64, 0x6E, 0x6F, 0x6F, 0x6F, 0x6F, 0x6F, 0x2F, 0x6F, 0x75, 0x75, 0x75, 0x75, 0x79, 0x70, 0x79,
+};
+
+/* hdsp: 20-7E, glyphs */
+static const uint8_t charset_hdsp[256] PROGMEM = {
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3F, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F,
+  0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0x3E, 0x3F,
+  0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4A, 0x4B, 0x4C, 0x4D, 0x4E, 0x4F,
+  0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x5B, 0x5C, 0x5D, 0x5E, 0x5F,
+  0x60, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6A, 0x6B, 0x6C, 0x6D, 0x6E, 0x6F,
+  0x70, 0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x7B, 0x7C, 0x7D, 0x7E, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x21, 0x63, 0x4C, 0x3F, 0x59, 0x7C, 0x3F, 0x3F, 0x43, 0x3F, 0x3C, 0x2D, 0x2D, 0x52, 0x3F,
+  0x8F, 0x2B, 0x32, 0x33, 0x3F, 0x75, 0x3F, 0x2E, 0x3F, 0x31, 0x3F, 0x3E, 0x3F, 0x3F, 0x3F, 0x3F,
+  0x41, 0x41, 0x41, 0x41, 0x88, 0x41, 0x41, 0x43, 0x45, 0x45, 0x45, 0x45, 0x49, 0x49, 0x49, 0x49,
+  0x44, 0x4E, 0x4F, 0x4F, 0x4F, 0x4F, 0x89, 0x78, 0x4F, 0x55, 0x55, 0x55, 0x8A, 0x59, 0x50, 0x8E,
+  0x61, 0x61, 0x61, 0x61, 0x8B, 0x61, 0x61, 0x63, 0x65, 0x65, 0x65, 0x65, 0x69, 0x69, 0x69, 0x69,
+  0x64, 0x6E, 0x6F, 0x6F, 0x6F, 0x6F, 0x8C, 0x2F, 0x6F, 0x75, 0x75, 0x75, 0x8D, 0x79, 0x70, 0x79,
+};
+
+/* U+00C4 U+00D6 U+00DC U+00E4 U+00F6 U+00FC U+00DF U+00B0 */
+static const char charset_glyphs[] PROGMEM = {
+  0xCA, 0xC5, 0xF8, 0x63, 0x54, 0x2E, 0xC6, 0x18, 0x9D, 0x02, 0x31, 0xC6,
+  0xE8, 0x14, 0x70, 0xE1, 0xC5, 0xA7, 0x80, 0x8B, 0x31, 0x3A, 0x05, 0x62,
+  0x8C, 0xB3, 0x31, 0x29, 0xA9, 0x94, 0x96, 0x49, 0xC9, 0x00, 0x00, 0x00,
+};
+
+static const struct charset_alias charset_aliases[] PROGMEM = {
+  { 0x2013, 0x2D },
+  { 0x2014, 0x2D },
+  { 0x2018, 0x27 },
+  { 0x2019, 0x27 },
+  { 0x201A, 0x27 },
+  { 0x201C, 0x22 },
+  { 0x201D, 0x22 },
+  { 0x201E, 0x22 },
+  { 0x2022, 0xB7 },
+  { 0x2026, 0x2E },
+  { 0x20AC, 0x45 },
+};
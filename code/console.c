@@ -0,0 +1,230 @@
+#include "console.h"
+#include "anim.h"
+#include "bitmap.h"
+#include "blink.h"
+#include "boot.h"
+#include "capture.h"
+#include "charset.h"
+#include "display.h"
+#include "governor.h"
+#include "marquee.h"
+#include "net.h"
+#include "profile.h"
+#include "resultlog.h"
+#include "sched.h"
+#include "settings.h"
+#include "shmoo.h"
+#include "uart.h"
+
+#include <util/crc16.h>
+
+#define ARG_TIMEOUT_MS  100
+#define MARQUEE_TEXT_MAX  128
+
+static uint8_t frame_crc;
+static bool frame_net;   /* the frame goes out wrapped for the ring */
+static bool test_running;
+
+/* Built-in animation (encoded by tools/animenc.py) */
+#include "demo_anim.h"
+
+static char marquee_text[MARQUEE_TEXT_MAX+1];
+static const char marquee_default[] PROGMEM =
+  "Intelligent alphanumeric display tester - "
+  "DL1414 DL1416 DL1814 DL2416 DL3416 DL3422 PD2816 HDSP-2xxx";
+
+
+static void frameOut(uint8_t b) {
+  if (frame_net) {
+    netReplyByte(b);
+  } else {
+    uartPutc(b);
+  }
+}
+
+
+static void frameByte(uint8_t b) {
+  frame_crc = _crc8_ccitt_update(frame_crc, b);
+  frameOut(b);
+}
+
+
+void consoleFrameBegin(uint8_t type, uint16_t len) {
+  frame_net = netActive();
+  if (frame_net) { netReplyBegin(len+5); }
+  frameOut(CONSOLE_SOF);
+  frame_crc = 0;
+  frameByte(type);
+  frameByte(len & 0xFF);
+  frameByte(len >> 8);
+}
+
+
+void consoleFrameData(const void *buf, uint16_t len) {
+  const uint8_t *p = buf;
+  while (len--) { frameByte(*p++); }
+}
+
+
+void consoleFrameEnd(void) {
+  frameOut(frame_crc);
+  if (frame_net) { netReplyEnd(); }
+}
+
+
+/* Next argument byte of a command, or -1 if the host stopped sending */
+static int16_t argByte(void) {
+  uint16_t start = schedMillis();
+  int16_t c;
+  while ((c = uartGetc()) < 0) {
+    if ((uint16_t)(schedMillis() - start) > ARG_TIMEOUT_MS) { break; }
+  }
+  return c;
+}
+
+
+/* 'M' mode text '\n', text in UTF-8 */
+static void marqueeCommand(void) {
+  enum marquee_mode mode;
+  switch (argByte()) {
+    case '<': mode = MARQUEE_LEFT; break;
+    case '>': mode = MARQUEE_RIGHT; break;
+    case '=': mode = MARQUEE_BOUNCE; break;
+    default: return;
+  }
+  uint8_t len = 0;
+  int16_t c;
+  struct utf8 u = {0};
+  while ((c = argByte()) >= 0 && c != '\n' && c != '\r') {
+    uint8_t latin1;
+    if (utf8Decode(&u, c, &latin1) && latin1 >= ' ' && len < MARQUEE_TEXT_MAX) {
+      marquee_text[len++] = latin1;
+    }
+  }
+  marquee_text[len] = '\0';
+  if (len) {
+    marqueeStart(marquee_text, mode);
+  } else {
+    marqueeStart_P(marquee_default, mode);
+  }
+  /* any byte from the host ends it */
+  while (uartGetc() < 0) {
+    marqueePoll();
+    settingsPoll();
+    resultlogPoll();
+  }
+  softResetDisplay();
+}
+
+
+static void marqueeSerialCommand(void) {
+  marqueeStartSerial();
+  while (marqueePoll()) {
+    settingsPoll();
+    resultlogPoll();
+  }
+  softResetDisplay();
+}
+
+
+void consolePoll(void) {
+  if (netActive()) {
+    netPoll();
+    return;
+  }
+  int16_t c = uartGetc();
+  if (c < 0) { return; }
+  if (c == NET_SOF) {
+    /* the host is talking to a ring of boards */
+    netStart();
+    netPoll();
+    return;
+  }
+  consoleCommand(c);
+}
+
+
+void consoleTestRunning(bool running) {
+  test_running = running;
+}
+
+
+/* Frame 'E' for a command that can't run now; the text or animation */
+/* that follows M, S or A is dropped (on a ring, commands come without */
+/* arguments) */
+static void refuseCommand(uint8_t c, uint8_t reason) {
+  if (!netActive() && (c == 'M' || c == 'S' || c == 'A')) {
+    while (argByte() >= 0) {}
+  }
+  uint8_t payload[2] = { c, reason };
+  consoleFrameBegin('E', sizeof(payload));
+  consoleFrameData(payload, sizeof(payload));
+  consoleFrameEnd();
+}
+
+
+void consoleCommand(uint8_t c) {
+  if (test_running) {
+    switch (c) {
+      case 'T': case 'M': case 'S': case 'A': case 'a': case 'G':
+        refuseCommand(c, CONSOLE_REFUSED_TEST);
+        return;
+      default:
+        break;
+    }
+  }
+  switch (c) {
+    case 'L':
+      resultlogDump();
+      break;
+    case 'T':
+      if (shmooAvailable()) {
+        shmooRun();
+      } else {
+        refuseCommand(c, CONSOLE_REFUSED_NO_PART);
+      }
+      break;
+    case 't':
+      shmooForget();
+      break;
+    case 'M':
+      marqueeCommand();
+      break;
+    case 'S':
+      marqueeSerialCommand();
+      break;
+    case 'C':
+      captureDisplay();
+      break;
+    case 'A':
+      animPlaySerial();
+      break;
+    case 'a':
+      /* loops until the next byte from the host */
+      while (animPlay_P(anim_demo)) {}
+      softResetDisplay();
+      break;
+    case 'G':
+      bitmapBenchmark();
+      break;
+    case 'B':
+      bootReport();
+      break;
+    case 'Y':
+      blinkReport();
+      break;
+    case 'V':
+      govReport();
+      break;
+#ifdef PROFILE
+    case 'P':
+      profDump();
+      break;
+    case 'p':
+      profReset();
+      break;
+#endif
+    default:
+      break;
+  }
+}
@@ -0,0 +1,61 @@
+/**
+ * Serial console: single-byte commands from the host, framed binary replies.
+ *
+ * Commands:
+ *   'L'  dump the test result log (reply frame 'L')
+ *   'T'  characterize bus timing of the current display (reply frame 'T')
+ *   't'  forget the stored bus timing of the current display
+ *   'M'  scroll text: 'M', mode ('<' left, '>' right, '=' bounce), up to
+ *        128 characters of UTF-8, '\n'; no text scrolls a built-in
+ *        message. Runs until the next byte from the host.
+ *   'S'  scroll the following UTF-8 text as it arrives, until ESC
+ *   'C'  snapshot of what the display shows (reply frame 'C', see capture.h)
+ *   'A'  play the animation that follows (see anim.h)
+ *   'a'  play the built-in animation until the next byte from the host
+ *   'G'  benchmark bitmap mode on the panel (reply frame 'G', see bitmap.h)
+ *   'B'  boot times (reply frame 'B', see boot.h)
+ *   'Y'  blink phase drift (reply frame 'Y', see blink.h)
+ *   'V'  frame governor counters (reply frame 'V', see governor.h)
+ *   'P'  dump the profiling counters (reply frame 'P'; profiling builds only)
+ *   'p'  clear the profiling counters (profiling builds only)
+ *
+ * Unsolicited frames:
+ *   'R'  one test result, sent as soon as it is logged
+ *   'E'  a refused command: the command byte, then CONSOLE_REFUSED_*
+ *
+ * While a part is being tested (consoleTestRunning()), the commands that
+ * take over the display or the bus (T, M, S, A, a, G) are refused with
+ * frame 'E', and the text or animation that follows M, S or A is dropped
+ * until the host pauses, so a test is never interrupted from inside
+ * waitMillis(). 'T' is also refused when the selected type can't be read
+ * back, e.g. from the menu, where nothing is selected yet.
+ *
+ * A board on a ring of boards (see net.h) takes commands from the host in
+ * 'K' frames instead, and its frames go out wrapped in 'r' frames.
+ *
+ * Frame format (all multi-byte values little-endian):
+ *   0xA5, type, length (2 bytes), payload (length bytes),
+ *   CRC-8/CCITT over type, length and payload (initial value 0)
+ *
+ * tools/tester.py is the host side.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CONSOLE_SOF  0xA5
+
+/* reasons in frame 'E' */
+#define CONSOLE_REFUSED_TEST     0  /* a test is running */
+#define CONSOLE_REFUSED_NO_PART  1  /* 'T': nothing to characterize */
+
+void consolePoll(void);
+/* Runs one command (also used by net.c) */
+void consoleCommand(uint8_t c);
+/* Set while a part is being tested; refuses the modal commands */
+void consoleTestRunning(bool running);
+
+void consoleFrameBegin(uint8_t type, uint16_t len);
+void consoleFrameData(const void *buf, uint16_t len);
+void consoleFrameEnd(void);
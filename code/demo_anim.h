@@ -0,0 +1,81 @@
+/* Generated by tools/animenc.py from demo.anim -- do not edit. */
+/*
+ * 74 frames, 8 digits, 2.96 s
+ * 860 bytes encoded, 1306 as full frames
+ */
+#pragma once
+
+static const char anim_demo[] PROGMEM = {
+  0x41, 0x01, 0x08, 0x28, 0x4A, 0x00, 0xC0, 0x01, 0x00, 0x88, 0x23, 0x00,
+  0x00, 0x00, 0x80, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x41, 0x01,
+  0x01, 0x80, 0x38, 0x02, 0x00, 0x00, 0x00, 0x81, 0x41, 0x01, 0x02, 0x00,
+  0x88, 0x23, 0x00, 0x00, 0x00, 0x82, 0x42, 0x02, 0x03, 0x00, 0x80, 0x30,
+  0x02, 0x00, 0x04, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x83, 0x01, 0x84,
+  0x42, 0x02, 0x05, 0x00, 0x00, 0x00, 0x02, 0x00, 0x06, 0x00, 0x00, 0x00,
+  0x31, 0x04, 0x00, 0x85, 0x01, 0x86, 0x42, 0x01, 0x07, 0x00, 0x00, 0x80,
+  0x38, 0x02, 0x00, 0x20, 0x01, 0x87, 0x41, 0x01, 0x08, 0x00, 0x00, 0xE2,
+  0x08, 0x00, 0x01, 0x88, 0x01, 0x01, 0x82, 0x42, 0x02, 0x09, 0x20, 0x8C,
+  0x00, 0x00, 0x00, 0x0A, 0x00, 0x40, 0x00, 0x00, 0x00, 0x01, 0x89, 0x02,
+  0x8A, 0x42, 0x02, 0x0B, 0x20, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x10, 0x43,
+  0x00, 0x00, 0x00, 0x01, 0x8B, 0x02, 0x8C, 0x42, 0x01, 0x0D, 0x00, 0x71,
+  0x04, 0x00, 0x00, 0x01, 0x20, 0x02, 0x8D, 0x41, 0x01, 0x0E, 0x00, 0x10,
+  0x47, 0x00, 0x00, 0x02, 0x8E, 0x41, 0x01, 0x0F, 0x00, 0x00, 0x71, 0x04,
+  0x00, 0x02, 0x8F, 0x42, 0x02, 0x00, 0x00, 0x00, 0x10, 0x46, 0x00, 0x01,
+  0x00, 0x00, 0x00, 0x20, 0x00, 0x02, 0x80, 0x03, 0x81, 0x02, 0x02, 0x85,
+  0x03, 0x86, 0x42, 0x01, 0x03, 0x00, 0x00, 0xC4, 0x11, 0x00, 0x02, 0x20,
+  0x03, 0x83, 0x01, 0x03, 0x8E, 0x41, 0x01, 0x04, 0x40, 0x1C, 0x01, 0x00,
+  0x00, 0x03, 0x84, 0x42, 0x02, 0x07, 0x61, 0x04, 0x00, 0x00, 0x00, 0x08,
+  0x00, 0x02, 0x00, 0x00, 0x00, 0x03, 0x87, 0x04, 0x88, 0x42, 0x02, 0x02,
+  0x00, 0x04, 0x00, 0x00, 0x00, 0x09, 0x00, 0x62, 0x08, 0x00, 0x00, 0x03,
+  0x82, 0x04, 0x89, 0x42, 0x01, 0x0A, 0x00, 0x20, 0x8E, 0x00, 0x00, 0x03,
+  0x20, 0x04, 0x8A, 0x41, 0x01, 0x0B, 0x00, 0x00, 0xE2, 0x08, 0x00, 0x04,
+  0x8B, 0x41, 0x01, 0x0C, 0x00, 0x00, 0x20, 0x8E, 0x00, 0x04, 0x8C, 0x02,
+  0x04, 0x80, 0x05, 0x81, 0x42, 0x02, 0x0D, 0x00, 0x00, 0x10, 0x00, 0x00,
+  0x0F, 0x00, 0x00, 0x88, 0x21, 0x00, 0x04, 0x8D, 0x05, 0x8F, 0x02, 0x04,
+  0x20, 0x05, 0x8A, 0x41, 0x01, 0x05, 0x80, 0x38, 0x02, 0x00, 0x00, 0x05,
+  0x85, 0x41, 0x01, 0x06, 0xE2, 0x08, 0x00, 0x00, 0x00, 0x05, 0x86, 0x42,
+  0x02, 0x03, 0x20, 0x8C, 0x00, 0x00, 0x00, 0x0E, 0x00, 0x40, 0x00, 0x00,
+  0x00, 0x05, 0x83, 0x06, 0x8E, 0x42, 0x02, 0x04, 0x00, 0x80, 0x00, 0x00,
+  0x00, 0x07, 0x00, 0x40, 0x0C, 0x01, 0x00, 0x05, 0x84, 0x06, 0x87, 0x42,
+  0x01, 0x08, 0x00, 0x00, 0xC4, 0x11, 0x00, 0x05, 0x20, 0x06, 0x88, 0x41,
+  0x01, 0x02, 0x00, 0x00, 0x40, 0x1C, 0x01, 0x06, 0x82, 0x01, 0x06, 0x8C,
+  0x42, 0x02, 0x09, 0x00, 0x80, 0x30, 0x02, 0x00, 0x0B, 0x00, 0x00, 0x00,
+  0x01, 0x00, 0x06, 0x89, 0x07, 0x8B, 0x02, 0x06, 0x84, 0x07, 0x87, 0x42,
+  0x01, 0x00, 0x00, 0x71, 0x04, 0x00, 0x00, 0x06, 0x20, 0x07, 0x80, 0x41,
+  0x01, 0x01, 0xC4, 0x11, 0x00, 0x00, 0x00, 0x07, 0x81, 0x41, 0x01, 0x0D,
+  0x40, 0x1C, 0x01, 0x00, 0x00, 0x07, 0x8D, 0x41, 0x01, 0x0F, 0x00, 0x10,
+  0x47, 0x00, 0x00, 0x07, 0x8F, 0x01, 0x07, 0x88, 0xC0, 0x02, 0x05, 0x00,
+  0x00, 0x00, 0x31, 0x04, 0x0A, 0x00, 0x00, 0x00, 0x02, 0x00, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x8A, 0x85, 0x42, 0x02, 0x03, 0x00, 0x00, 0x00,
+  0x20, 0x00, 0x06, 0x00, 0x00, 0x10, 0x46, 0x00, 0x06, 0x86, 0x07, 0x83,
+  0x42, 0x01, 0x0E, 0x00, 0x00, 0x71, 0x04, 0x00, 0x06, 0x8E, 0x07, 0x20,
+  0x01, 0x06, 0x8F, 0x01, 0x06, 0x80, 0x42, 0x02, 0x02, 0x20, 0x00, 0x00,
+  0x00, 0x00, 0x0C, 0x10, 0x43, 0x00, 0x00, 0x00, 0x05, 0x82, 0x06, 0x8C,
+  0x42, 0x02, 0x09, 0x20, 0x8C, 0x00, 0x00, 0x00, 0x0B, 0x00, 0x40, 0x00,
+  0x00, 0x00, 0x05, 0x89, 0x06, 0x8B, 0x42, 0x01, 0x04, 0x00, 0x88, 0x23,
+  0x00, 0x00, 0x05, 0x84, 0x06, 0x20, 0x41, 0x01, 0x07, 0x00, 0x00, 0xE2,
+  0x08, 0x00, 0x05, 0x87, 0x41, 0x01, 0x01, 0x00, 0x00, 0x80, 0x38, 0x02,
+  0x05, 0x81, 0x02, 0x04, 0x8A, 0x05, 0x85, 0x42, 0x02, 0x08, 0x00, 0x00,
+  0x00, 0x01, 0x00, 0x0D, 0x00, 0x80, 0x30, 0x02, 0x00, 0x04, 0x8D, 0x05,
+  0x88, 0x02, 0x04, 0x84, 0x05, 0x20, 0x41, 0x01, 0x03, 0x80, 0x38, 0x02,
+  0x00, 0x00, 0x04, 0x83, 0x41, 0x01, 0x06, 0x88, 0x23, 0x00, 0x00, 0x00,
+  0x04, 0x86, 0x42, 0x02, 0x0E, 0x00, 0x04, 0x00, 0x00, 0x00, 0x0F, 0x00,
+  0x62, 0x08, 0x00, 0x00, 0x03, 0x8E, 0x04, 0x8F, 0x42, 0x02, 0x00, 0x00,
+  0x84, 0x11, 0x00, 0x00, 0x02, 0x00, 0x00, 0x08, 0x00, 0x00, 0x03, 0x80,
+  0x04, 0x82, 0x42, 0x01, 0x0C, 0x00, 0x00, 0x71, 0x04, 0x00, 0x03, 0x8C,
+  0x04, 0x20, 0x41, 0x01, 0x09, 0x00, 0x00, 0x40, 0x1C, 0x01, 0x03, 0x89,
+  0x01, 0x03, 0x81, 0x42, 0x02, 0x07, 0x00, 0x00, 0x88, 0x21, 0x00, 0x0B,
+  0x00, 0x00, 0x10, 0x00, 0x00, 0x02, 0x8B, 0x03, 0x87, 0x02, 0x02, 0x80,
+  0x03, 0x82, 0x42, 0x01, 0x05, 0x40, 0x1C, 0x01, 0x00, 0x00, 0x02, 0x85,
+  0x03, 0x20, 0x41, 0x01, 0x0A, 0xC4, 0x11, 0x00, 0x00, 0x00, 0x02, 0x8A,
+  0x41, 0x01, 0x08, 0x00, 0x71, 0x04, 0x00, 0x00, 0x02, 0x88, 0x42, 0x02,
+  0x04, 0x00, 0x40, 0x0C, 0x01, 0x00, 0x0D, 0x00, 0x80, 0x00, 0x00, 0x00,
+  0x01, 0x8D, 0x02, 0x84, 0x42, 0x02, 0x03, 0x00, 0x80, 0x30, 0x02, 0x00,
+  0x06, 0x00, 0x00, 0x00, 0x01, 0x00, 0x01, 0x83, 0x02, 0x86, 0x42, 0x01,
+  0x0E, 0x00, 0x00, 0x20, 0x8E, 0x00, 0x01, 0x8E, 0x02, 0x20, 0x01, 0x01,
+  0x89, 0x41, 0x01, 0x0F, 0x00, 0x00, 0xC4, 0x11, 0x00, 0x01, 0x8F, 0x02,
+  0x00, 0x8D, 0x01, 0x84, 0x42, 0x02, 0x01, 0x00, 0x40, 0x00, 0x00, 0x00,
+  0x0C, 0x20, 0x8C, 0x00, 0x00, 0x00, 0x00, 0x8C, 0x01, 0x81, 0x42, 0x01,
+  0x07, 0xE2, 0x08, 0x00, 0x00, 0x00, 0x00, 0x87, 0x01, 0x20, 0x41, 0x01,
+  0x0B, 0x80, 0x38, 0x02, 0x00, 0x00, 0x00, 0x8B,
+};
@@ -0,0 +1,557 @@
+#include "display.h"
+#include "charset.h"
+#include "pins.h"
+#include "profile.h"
+#include "sched.h"
+#include "shmoo.h"
+#include "pin_xmega.h"
+
+#include <string.h>
+
+static const struct display_spec DISPLAYS[NUM_DISPLAY_TYPES] PROGMEM =
+{
+  [DL1414] = {
+    .quirks={0},
+    .num_digits=4, .asciival_min=' ', .asciival_max='_', .charset=CHARSET_SEG64,
+  },
+  [DLX1414] = {
+    .quirks={0},
+    .num_digits=4, .asciival_min='\0', .asciival_max='\x7f', .charset=CHARSET_DOT,
+  },
+  [DL1416T] = { /* or DL1416, SP1-16, uses a different cursor scheme */
+    .quirks={ .has_cursor=1, .cursor_parallel_load=1 },
+    .num_digits=4, .asciival_min=' ', .asciival_max='_', .charset=CHARSET_SEG64,
+  },
+  [DL1416B] = { /* uses the same cursor scheme as DL2416/3416/3422 */
+    .quirks={ .has_cursor=1, },
+    .num_digits=4, .asciival_min=' ', .asciival_max='_', .charset=CHARSET_SEG64,
+  },
+  [DL1814] = {
+    .quirks={ .has_blanking_pin=1 },
+    .num_digits=8, .asciival_min=' ', .asciival_max='_', .charset=CHARSET_SEG64,
+  },
+  [DL2416] = {
+    .quirks={ .has_cursor=1, .has_blanking_pin=1 },
+    .num_digits=4, .asciival_min=' ', .asciival_max='_', .charset=CHARSET_SEG64,
+  },
+  [DLX2416] = {
+    .quirks={ .has_cursor=1, .has_blanking_pin=1 },
+    .num_digits=4, .asciival_min='\0', .asciival_max='\x7f', .charset=CHARSET_DOT,
+  },
+  [DL3416] = {
+    .quirks={ .has_cursor=1, .has_blanking_pin=1 },
+    .num_digits=4, .asciival_min=' ', .asciival_max='_', .charset=CHARSET_SEG64,
+  },
+  [DLX3416] = {
+    .quirks={ .has_cursor=1, .has_blanking_pin=1 },
+    .num_digits=4, .asciival_min='\0', .asciival_max='\x7f', .charset=CHARSET_DOT,
+  },
+  [DL3422] = {
+    .quirks={ .has_cursor=1, .has_blanking_pin=1 },
+    .num_digits=4, .asciival_min=' ', .asciival_max='\x7e', .charset=CHARSET_SEG95,
+  },
+  [PD2816] = {
+    .quirks={ .controlreg_pd2816=1, .has_read=1 },
+    .num_digits=8, .asciival_min=' ', .asciival_max='_', .charset=CHARSET_SEG64,
+  },
+  [HDSP2xxx] = {
+    .quirks={ .left_to_right_digit_numbering=1, .has_read=1, .controlreg_hdsp2xxx=1, .has_udc=1 },
+    .num_digits=8, .asciival_min='\0', .asciival_max='\x8f', .charset=CHARSET_HDSP,
+  },
+  [HDLX2416] = { /* the cursor and blanking of DLX2416, ~BL also dims */
+    .quirks={ .has_cursor=1, .has_blanking_pin=1, .has_dimming=1 },
+    .num_digits=4, .asciival_min='\0', .asciival_max='\x7f', .charset=CHARSET_DOT,
+  },
+  [HDLX3416] = {
+    .quirks={ .has_cursor=1, .has_blanking_pin=1, .has_dimming=1 },
+    .num_digits=4, .asciival_min='\0', .asciival_max='\x7f', .charset=CHARSET_DOT,
+  },
+};
+
+
+struct display_spec disp = {0};
+enum display_type disp_type;
+
+bool a0_a1_not_swapped;
+struct display_shadow disp_shadow;
+
+static uint8_t fixAddress(uint8_t addr) {
+  if (a0_a1_not_swapped) { return addr; }
+  bool a0 = addr & 1;
+  bool a1 = (addr & 2) >> 1;
+  addr &= 0b11111100;
+  return addr | a1 | (a0<<1);
+}
+
+
+struct bus_timing bus_timing = {
+  BUS_DEFAULT_CYCLES, BUS_DEFAULT_CYCLES, BUS_DEFAULT_CYCLES
+};
+
+/* Number of NOPs executed in each delay sled */
+static struct bus_timing bus_nops = {
+  BUS_DEFAULT_CYCLES-BUS_MIN_CYCLES, BUS_DEFAULT_CYCLES-BUS_MIN_CYCLES, BUS_DEFAULT_CYCLES-BUS_MIN_CYCLES
+};
+
+#define BUS_SLED_LEN  (BUS_MAX_CYCLES-BUS_MIN_CYCLES)
+#define BUS_SLED      ".rept " XSTR_(BUS_SLED_LEN) "\n\tnop\n\t.endr\n\t"
+
+/* Jump target into the sled ending at label "lbl", leaving "n" NOPs to run */
+#define BUS_SLED_ENTRY(lo, hi, lbl, n) \
+  "ldi " lo ", lo8(pm(" lbl "))\n\t" \
+  "ldi " hi ", hi8(pm(" lbl "))\n\t" \
+  "sub " lo ", %[" n "]\n\t" \
+  "sbc " hi ", __zero_reg__\n\t"
+
+#define BUS_SLED_JUMP(lo) "movw r30, " lo "\n\tijmp\n\t" BUS_SLED
+
+static uint8_t clampCycles(uint8_t cycles) {
+  if (cycles < BUS_MIN_CYCLES) { return BUS_MIN_CYCLES; }
+  if (cycles > BUS_MAX_CYCLES) { return BUS_MAX_CYCLES; }
+  return cycles;
+}
+
+
+void busSetTiming(const struct bus_timing *t) {
+  bus_timing.setup  = clampCycles(t->setup);
+  bus_timing.strobe = clampCycles(t->strobe);
+  bus_timing.hold   = clampCycles(t->hold);
+  /* n NOPs, plus the movw/ijmp that reaches them and the cbi/sbi that
+     follows, take n+BUS_MIN_CYCLES cycles */
+  bus_nops.setup  = bus_timing.setup  - BUS_MIN_CYCLES;
+  bus_nops.strobe = bus_timing.strobe - BUS_MIN_CYCLES;
+  bus_nops.hold   = bus_timing.hold   - BUS_MIN_CYCLES;
+}
+
+
+void busSetDefaultTiming(void) {
+  struct bus_timing defaults = {
+    BUS_DEFAULT_CYCLES, BUS_DEFAULT_CYCLES, BUS_DEFAULT_CYCLES
+  };
+  busSetTiming(&defaults);
+}
+
+
+/**
+ * The delays between bus edges are set at runtime, so they can't be
+ * delay_ns_max() strings. Instead each delay is an indirect jump into a
+ * string of NOPs, entered far enough in to leave the requested number of
+ * cycles. Entry points are computed before the first edge so that every
+ * interval is exact to the cycle.
+ */
+static inline __attribute__((always_inline)) void busWrite(uint8_t addr, uint8_t data) {
+#ifdef __AVR__
+  asm volatile(
+    BUS_SLED_ENTRY("r30", "r31", "1f", "su")
+    BUS_SLED_ENTRY("r26", "r27", "2f", "su")
+    BUS_SLED_ENTRY("r24", "r25", "3f", "st")
+    BUS_SLED_ENTRY("r22", "r23", "4f", "ho")
+    BUS_SLED_ENTRY("r20", "r21", "5f", "ho")
+    /* set up address and data */
+    "out %[aport], %[addr]\n\t"
+    "out %[dport], %[data]\n\t"
+    "ijmp\n\t" BUS_SLED
+    "1: cbi %[ceport], %[cebit]\n\t"
+    BUS_SLED_JUMP("r26")
+    "2: cbi %[wrport], %[wrbit]\n\t"
+    BUS_SLED_JUMP("r24")
+    "3: sbi %[wrport], %[wrbit]\n\t"
+    BUS_SLED_JUMP("r22")
+    "4: sbi %[ceport], %[cebit]\n\t"
+    BUS_SLED_JUMP("r20")
+    "5:\n\t"
+    :
+    : [addr] "r" (addr), [data] "r" (data),
+      [su] "r" (bus_nops.setup), [st] "r" (bus_nops.strobe), [ho] "r" (bus_nops.hold),
+      [aport] "I" (_SFR_IO_ADDR(VPORT(ADDRESS_PORT).OUT)),
+      [dport] "I" (_SFR_IO_ADDR(VPORT(DATA_PORT).OUT)),
+      [ceport] "I" (_SFR_IO_ADDR(VPORT(nCE_PORT).OUT)), [cebit] "I" (nCE_PIN),
+      [wrport] "I" (_SFR_IO_ADDR(VPORT(nWR_PORT).OUT)), [wrbit] "I" (nWR_PIN)
+    : "r20", "r21", "r22", "r23", "r24", "r25", "r26", "r27", "r30", "r31"
+  );
+#else
+  port_out(ADDRESS, addr);
+  port_out(DATA, data);
+  pin_low(nCE);
+  pin_low(nWR);
+  pin_high(nWR);
+  pin_high(nCE);
+#endif
+}
+
+
+void writeByte(uint8_t addr, uint8_t data) {
+  PROF_BEGIN();
+  busWrite(fixAddress(addr), data);
+  PROF_END(PROF_WRITE_BYTE);
+}
+
+
+/* Same bus cycles as writeByte(), without a call per byte */
+void writeBurst(uint8_t addr, const uint8_t *data, uint8_t n) {
+  PROF_BEGIN();
+  for (uint8_t i = 0; i < n; i++) {
+    busWrite(fixAddress(addr + i), data[i]);
+  }
+  PROF_END(PROF_WRITE_BURST);
+}
+
+
+/* has_read only */
+uint8_t readByte(uint8_t addr) {
+  PROF_BEGIN();
+  uint8_t data;
+  addr = fixAddress(addr);
+#ifdef __AVR__
+  asm volatile(
+    BUS_SLED_ENTRY("r30", "r31", "1f", "su")
+    BUS_SLED_ENTRY("r26", "r27", "2f", "su")
+    BUS_SLED_ENTRY("r24", "r25", "3f", "st")
+    BUS_SLED_ENTRY("r22", "r23", "4f", "ho")
+    BUS_SLED_ENTRY("r20", "r21", "5f", "ho")
+    BUS_SLED_ENTRY("r18", "r19", "6f", "ho")
+    /* set up address lines and tristate data lines */
+    "out %[aport], %[addr]\n\t"
+    "out %[ddir], __zero_reg__\n\t"
+    "ijmp\n\t" BUS_SLED
+    "1: cbi %[ceport], %[cebit]\n\t"
+    BUS_SLED_JUMP("r26")
+    "2: cbi %[rdport], %[rdbit]\n\t"
+    BUS_SLED_JUMP("r24")
+    "3: in %[data], %[dpin]\n\t"
+    "sbi %[rdport], %[rdbit]\n\t"
+    BUS_SLED_JUMP("r22")
+    "4: sbi %[ceport], %[cebit]\n\t"
+    BUS_SLED_JUMP("r20")
+    "5: out %[ddir], %[ones]\n\t"
+    BUS_SLED_JUMP("r18")
+    "6:\n\t"
+    : [data] "=&r" (data)
+    : [addr] "r" (addr), [ones] "r" ((uint8_t)0xFF),
+      [su] "r" (bus_nops.setup), [st] "r" (bus_nops.strobe), [ho] "r" (bus_nops.hold),
+      [aport] "I" (_SFR_IO_ADDR(VPORT(ADDRESS_PORT).OUT)),
+      [ddir] "I" (_SFR_IO_ADDR(VPORT(DATA_PORT).DIR)),
+      [dpin] "I" (_SFR_IO_ADDR(VPORT(DATA_PORT).IN)),
+      [ceport] "I" (_SFR_IO_ADDR(VPORT(nCE_PORT).OUT)), [cebit] "I" (nCE_PIN),
+      [rdport] "I" (_SFR_IO_ADDR(VPORT(nRD_PORT).OUT)), [rdbit] "I" (nRD_PIN)
+    : "r18", "r19", "r20", "r21", "r22", "r23", "r24", "r25", "r26", "r27", "r30", "r31"
+  );
+#else
+  port_out(ADDRESS, addr);
+  port_inputs(DATA);
+  pin_low(nCE);
+  pin_low(nRD);
+  data = port_value(DATA);
+  pin_high(nRD);
+  pin_high(nCE);
+  port_outputs(DATA);
+#endif
+  PROF_END(PROF_READ_BYTE);
+  return data;
+}
+
+
+/* HDSP-2xxx and PD2816 only */
+void writeControlRegister(uint8_t data) {
+  /* A3 must be low to access control register for PD2816 */
+  /* ~FL and A4 must also be high to access character RAM on HDSP-2xxx */
+  writeByte(_BV(ADDR_FL)|_BV(ADDR_A4), data);
+  if (data & CR_CLEAR) {
+    /* clears character RAM (and flash RAM on HDSP-2xxx) */
+    memset(disp_shadow.chars, ' ', sizeof(disp_shadow.chars));
+    disp_shadow.flash = 0;
+  }
+  disp_shadow.control = data & ~CR_CLEAR;
+}
+
+
+/* has_read only */
+uint8_t readControlRegister(void) {
+  /* A3 must be low to access control register for PD2816 */
+  /* ~FL and A4 must also be high to access character RAM on HDSP-2xxx */
+  return readByte(_BV(ADDR_FL)|_BV(ADDR_A4));
+}
+
+
+/* Character RAM address of a position */
+static uint8_t charAddress(uint8_t pos) {
+  if (!disp.quirks.left_to_right_digit_numbering) {
+    pos = disp.num_digits-1-pos;
+  }
+  /* A3 must be high to access character RAM for PD2816 */
+  /* ~FL, A4, and A3 must be high to access character RAM on HDSP-2xxx */
+  /* Others don't care */
+  return pos|_BV(ADDR_FL)|_BV(ADDR_A4)|_BV(ADDR_A3);
+}
+
+
+void displayChar(uint8_t pos, uint8_t c) {
+  PROF_BEGIN();
+  pos &= 0b111;
+  disp_shadow.chars[pos] = c;
+  writeByte(charAddress(pos), c);
+  PROF_END(PROF_DISPLAY_CHAR);
+}
+
+
+/* has_read only */
+uint8_t readChar(uint8_t pos) {
+  return readByte(charAddress(pos & 0b111));
+}
+
+
+/* Bit n of a mask as byte n, for cursor and flash RAM */
+static void maskBytes(uint8_t bitmask, uint8_t bytes[8]) {
+  for (uint8_t i = 0; i < 8; i++) {
+    bytes[i] = bitmask & 1;
+    bitmask >>= 1;
+  }
+}
+
+
+void setCursorMask(uint8_t bitmask) {
+  disp_shadow.cursor = bitmask;
+  if (disp.quirks.cursor_parallel_load) {
+    /* DL1416 sets cursor for all digits with one write */
+    writeByte(_BV(ADDR_FL)|_BV(ADDR_A4), bitmask);
+  } else {
+    /* Others have a cursor bit at each digit's address */
+    uint8_t bytes[8];
+    maskBytes(bitmask, bytes);
+    writeBurst(_BV(ADDR_FL)|_BV(ADDR_A4), bytes, disp.num_digits);
+  }
+}
+
+
+/* HDSP-2xxx only */
+void setFlashMask(uint8_t bitmask) {
+  disp_shadow.flash = bitmask;
+  uint8_t bytes[8];
+  maskBytes(bitmask, bytes);
+  writeBurst(_BV(ADDR_A4)|_BV(ADDR_A3), bytes, disp.num_digits);
+}
+
+
+/* HDSP-2xxx only */
+uint8_t readFlashMask(void) {
+  uint8_t bitmask = 0;
+  for (uint8_t pos = disp.num_digits; pos-- > 0; ) {
+    bitmask = (bitmask << 1) | (readByte(pos|_BV(ADDR_A4)|_BV(ADDR_A3)) & 1);
+  }
+  return bitmask;
+}
+
+
+enum reset_step {
+  RESET_IDLE,
+  RESET_PULSE,    /* ~CLR held low */
+  RESET_RECOVER,  /* ~CLR released */
+  RESET_CLEAR,    /* clear bit written */
+};
+
+static enum reset_step reset_step;
+static uint16_t reset_since;  /* schedMicros() at the start of the step */
+
+
+static void resetNext(enum reset_step step) {
+  reset_step = step;
+  reset_since = schedMicros();
+}
+
+
+/* Control word, cursors and blanking back to their defaults */
+static void restoreDefaults(void) {
+  if (disp.quirks.controlreg_pd2816) {
+    writeControlRegister(CR_PD2816_BRIGHTNESS_100|CR_PD2816_ATTRS_ON|CR_PD2816_CHAR_SOLID|CR_PD2816_UNDERLINE_SOLID);
+  } else if (disp.quirks.controlreg_hdsp2xxx) {
+    writeControlRegister(CR_HDSP_BRIGHTNESS_100);
+  }
+  if (disp.quirks.has_cursor) {
+    setCursorMask(0);
+  }
+  pin_high(nBL); /* unblank */
+}
+
+
+void resetStart(enum reset_kind kind) {
+  if (kind == RESET_HARD) {
+    pin_low(nCLR);
+    /* clears every RAM except the UDCs */
+    memset(disp_shadow.chars, ' ', sizeof(disp_shadow.chars));
+    disp_shadow.control = disp_shadow.cursor = disp_shadow.flash = 0;
+    resetNext(RESET_PULSE);
+  } else if (disp.quirks.controlreg_pd2816 || disp.quirks.controlreg_hdsp2xxx) {
+    writeControlRegister(CR_CLEAR);
+    resetNext(RESET_CLEAR);
+  } else {
+    restoreDefaults();
+    reset_step = RESET_IDLE;
+  }
+}
+
+
+bool resetPoll(void) {
+  uint16_t elapsed = schedMicros() - reset_since;
+  switch (reset_step) {
+    case RESET_IDLE:
+      return true;
+    case RESET_PULSE:
+      if (elapsed < RESET_PULSE_US) { return false; }
+      pin_high(nCLR);
+      resetNext(RESET_RECOVER);
+      return false;
+    case RESET_RECOVER:
+      if (elapsed < RESET_RECOVER_US) { return false; }
+      break;
+    case RESET_CLEAR:
+      if (elapsed < RESET_RECOVER_US) { return false; }
+      restoreDefaults();
+      break;
+  }
+  reset_step = RESET_IDLE;
+  return true;
+}
+
+
+void hardResetDisplay(void) {
+  resetStart(RESET_HARD);
+  while (!resetPoll()) {}
+}
+
+
+void softResetDisplay(void) {
+  resetStart(RESET_SOFT);
+  while (!resetPoll()) {}
+}
+
+
+void ptextBegin(struct ptext *t, PGM_P packed) {
+  uint8_t header = pgm_read_byte(packed++);
+  t->remaining = header & PTEXT_LEN_MASK;
+  t->nruns = 0;
+  if (header & PTEXT_HAS_ATTRS) {
+    t->nruns = pgm_read_byte(packed++);
+    t->runs = packed;
+    packed += t->nruns;
+  }
+  t->skip = 0;
+  t->attrs = 0;
+  t->next = packed;
+  t->phase = 0;
+}
+
+
+static uint8_t ptextCode(struct ptext *t) {
+  uint8_t b, code;
+  /* 4 codes are packed LSB-first into 3 bytes */
+  switch (t->phase++) {
+    case 0:
+      b = pgm_read_byte(t->next++);
+      code = b;
+      t->carry = b >> 6;
+      break;
+    case 1:
+      b = pgm_read_byte(t->next++);
+      code = t->carry | (b << 2);
+      t->carry = b >> 4;
+      break;
+    case 2:
+      b = pgm_read_byte(t->next++);
+      code = t->carry | (b << 4);
+      t->carry = b >> 2;
+      break;
+    default:
+      code = t->carry;
+      t->phase = 0;
+      break;
+  }
+  return code & 0b00111111;
+}
+
+
+/* Only call while t->remaining is nonzero */
+uint8_t ptextNext(struct ptext *t) {
+  t->remaining--;
+  uint8_t c = ptextCode(t);
+  if (c == PTEXT_CODE_ESCAPE) {
+    c = ptextCode(t) + PTEXT_ESCAPE_BASE;
+  } else {
+    c += PTEXT_DIRECT_BASE;
+  }
+  /* runs are (skip, count) nibble pairs; a run may be empty */
+  while (t->skip == 0 && t->attrs == 0 && t->nruns) {
+    uint8_t run = pgm_read_byte(t->runs++);
+    t->nruns--;
+    t->skip = run >> 4;
+    t->attrs = run & 0x0F;
+  }
+  if (t->skip) {
+    t->skip--;
+  } else if (t->attrs) {
+    t->attrs--;
+    c |= CHAR_ATTR;
+  }
+  return c;
+}
+
+
+/* Shows a packed message, padded with spaces to the display width, in */
+/* one burst */
+void displayString_P(PGM_P str) {
+  uint8_t bytes[8];
+  struct ptext t;
+  ptextBegin(&t, str);
+  for (uint8_t pos = 0; pos < disp.num_digits; pos++) {
+    uint8_t c = t.remaining ? ptextNext(&t) : ' ';
+    disp_shadow.chars[pos] = c;
+    bytes[charAddress(pos) & 0b111] = c;
+  }
+  writeBurst(charAddress(0) & ~0b111, bytes, disp.num_digits);
+}
+
+
+void fillDisplay(uint8_t c, uint8_t ndigits) {
+  for (uint8_t pos = 0; pos < ndigits; pos++) {
+    displayChar(pos, c);
+  }
+}
+
+
+/* has_udc only */
+/* Loads rows firstrow..firstrow+6 of a packed glyph table/strip into a UDC */
+void setUserDefinedChar_P(uint8_t idx, PGM_P strip, uint8_t firstrow) {
+  uint8_t rows[7];
+  /* rows are 5 bits each, packed LSB-first */
+  uint16_t bit = firstrow*5;
+  for (uint8_t row = 0; row < 7; row++) {
+    rows[row] = (pgm_read_word(strip + (bit >> 3)) >> (bit & 7)) & 0b00011111;
+    bit += 5;
+  }
+  setUserDefinedChar(idx, rows);
+}
+
+
+/* has_udc only */
+/* Loads a UDC from 7 rows in RAM, leftmost pixel in bit 4 */
+void setUserDefinedChar(uint8_t idx, const uint8_t *rows) {
+  PROF_BEGIN();
+  /* set UDC address, then the rows in one burst */
+  writeByte(_BV(ADDR_FL), idx);
+  memcpy(disp_shadow.udc[idx & 0x0F], rows, 7);
+  writeBurst(_BV(ADDR_FL)|_BV(ADDR_A3), rows, 7);
+  PROF_END(PROF_SET_UDC);
+}
+
+
+void displaySpec(enum display_type type, struct display_spec *spec) {
+  memcpy_P(spec, DISPLAYS+type, sizeof(*spec));
+}
+
+
+void setDisplayType(enum display_type type) {
+  displaySpec(type, &disp);
+  disp_type = type;
+  charsetSelect(disp.charset);
+  shmooApplyTiming();
+  softResetDisplay();
+}
@@ -0,0 +1,197 @@
+/**
+ * Display bus and character-level access for all supported display types.
+ *
+ * All displays share the tester's data and address bus. writeByte() and
+ * readByte() run one bus cycle with the timing in bus_timing; everything
+ * else is built on top of them. writeBurst() fills a run of consecutive
+ * addresses (UDC rows, flash/cursor RAM) with one call instead of one per
+ * byte; each byte is still a complete bus cycle, delay sled entry points
+ * and address fix-up included.
+ *
+ * HDLx-2416/3416 sit in the DL2416/DL3416 sockets, which only wire A0, A1
+ * and ~CU (A3) to the bus, plus CUE and ~BL. Their extended functions are
+ * on those pins: the cursor RAM behind ~CU, CUE to show (or blink) the
+ * cursor, and ~BL, which dims the display when driven with a PWM signal
+ * (has_dimming) as well as blanking it.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <avr/pgmspace.h>
+
+/* Address bits */
+#define ADDR_FL  5
+#define ADDR_A4  4
+#define ADDR_A3  3
+#define ADDR_nCU ADDR_A3
+#define ADDR_A2  2
+#define ADDR_A1  1
+#define ADDR_A0  0
+
+/* Control register bits */
+#define CR_CLEAR                  0b10000000
+#define CR_PD2816_BRIGHTNESS_0    0b00000000
+#define CR_PD2816_BRIGHTNESS_25   0b00000001
+#define CR_PD2816_BRIGHTNESS_50   0b00000010
+#define CR_PD2816_BRIGHTNESS_100  0b00000011
+#define CR_PD2816_CHAR_SOLID      0b00000000
+#define CR_PD2816_CHAR_BLINK      0b00000100
+#define CR_PD2816_UNDERLINE_SOLID 0b00000000
+#define CR_PD2816_UNDERLINE_BLINK 0b00001000
+#define CR_PD2816_ATTRS_ON        0b00010000
+#define CR_PD2816_BLINK_DISPLAY   0b00100000
+#define CR_PD2816_LAMP_TEST       0b01000000
+#define CR_HDSP_BRIGHTNESS_100    0b00000000
+#define CR_HDSP_BRIGHTNESS_80     0b00000001
+#define CR_HDSP_BRIGHTNESS_53     0b00000010
+#define CR_HDSP_BRIGHTNESS_40     0b00000011
+#define CR_HDSP_BRIGHTNESS_27     0b00000100
+#define CR_HDSP_BRIGHTNESS_20     0b00000101
+#define CR_HDSP_BRIGHTNESS_13     0b00000110
+#define CR_HDSP_BRIGHTNESS_0      0b00000111
+#define CR_HDSP_FLASH_ON          0b00001000
+#define CR_HDSP_BLINK_DISPLAY     0b00010000
+#define CR_HDSP_SELF_TEST_RESULT  0b00100000
+#define CR_HDSP_SELF_TEST_START   0b01000000
+
+/* Packed text format (see tools/packmsg.py) */
+#define PTEXT_LEN_MASK     0b00111111
+#define PTEXT_HAS_ATTRS    0b10000000
+#define PTEXT_CODE_ESCAPE  63
+#define PTEXT_DIRECT_BASE  ' '
+#define PTEXT_ESCAPE_BASE  '_'
+/* Attribute bit: underline on PD2816, UDC select on HDSP-2xxx */
+#define CHAR_ATTR          0b10000000
+
+/* Part-specific quirks */
+struct quirks {
+  uint8_t left_to_right_digit_numbering:1;
+  uint8_t has_cursor:1;
+  uint8_t cursor_parallel_load:1;
+  uint8_t has_blanking_pin:1;
+  uint8_t has_read:1;
+  uint8_t controlreg_pd2816:1;
+  uint8_t controlreg_hdsp2xxx:1;
+  uint8_t has_dimming:1;         /* HDLx-2416/3416: PWM on ~BL dims */
+  uint8_t has_udc:1;             /* 16 UDCs, codes CHAR_ATTR|0..15 */
+  uint8_t :7;
+};
+
+/* Display properties */
+struct display_spec {
+  struct quirks quirks;
+  uint8_t num_digits;
+  uint8_t asciival_min;
+  uint8_t asciival_max;
+  uint8_t charset;  /* enum charset_id (see charset.h) */
+};
+
+enum display_type {
+  DL1414,   /* segmented */
+  DLX1414,  /* dot matrix */
+  DL1416T,  /* (and DL1416, SP1-16) segmented */
+  DL1416B,  /* segmented */
+  DL1814,   /* segmented */
+  DL2416,   /* segmented */
+  DLX2416,  /* dot matrix */
+  DL3416,   /* segmented */
+  DLX3416,  /* dot matrix */
+  DL3422,   /* segmented */
+  PD2816,   /* segmented */
+  HDSP2xxx, /* (and PD188x) dot matrix */
+  /* Not supported: PD243x/353x/443x (no socket on this board) */
+  HDLX2416, /* HDLx-2416 with its extended functions */
+  HDLX3416, /* HDLx-3416 with its extended functions */
+  NUM_DISPLAY_TYPES
+};
+
+/* Bus timing, in CPU cycles between successive bus signal edges */
+struct bus_timing {
+  uint8_t setup;   /* address/data valid to ~CE low, ~CE low to ~WR/~RD low */
+  uint8_t strobe;  /* ~WR/~RD low to high; read data is sampled at the end */
+  uint8_t hold;    /* ~WR/~RD high to ~CE high, ~CE high to next cycle */
+};
+
+#define BUS_MIN_CYCLES      4   /* shortest interval writeByte()/readByte() can produce */
+#define BUS_MAX_CYCLES      18
+/* conservative; used until a part has been characterized (see shmoo.h) */
+#define BUS_DEFAULT_CYCLES  6   /* 300ns at 20MHz */
+
+/* Reset timing (datasheet minimums are 15 ms and 110 us) */
+#define RESET_PULSE_US    16000  /* ~CLR low */
+#define RESET_RECOVER_US  120    /* after ~CLR rises, or after a clear */
+
+enum reset_kind {
+  RESET_HARD,  /* pulse ~CLR: resets every display on the bus */
+  RESET_SOFT,  /* clear through the control register, restore defaults */
+};
+
+/* What the tester last wrote, for the parts of a snapshot that can't be */
+/* read back (see capture.h) */
+struct display_shadow {
+  uint8_t chars[8];      /* by position, as passed to displayChar() */
+  uint8_t control;
+  uint8_t cursor;
+  uint8_t flash;          /* HDSP-2xxx flash RAM */
+  uint8_t udc[16][7];
+};
+
+/* Decoder state for a packed message (see tools/packmsg.py) */
+struct ptext {
+  PGM_P next;         /* next byte of the 6-bit code stream */
+  uint8_t phase;      /* position within a 4-code/3-byte group */
+  uint8_t carry;      /* leftover bits of the previous byte */
+  uint8_t remaining;  /* characters left to decode */
+  PGM_P runs;         /* next attribute run */
+  uint8_t nruns;      /* attribute runs left */
+  uint8_t skip;       /* characters left before the current run */
+  uint8_t attrs;      /* characters left in the current run */
+};
+
+extern struct display_spec disp;
+extern enum display_type disp_type;
+/* rev 1 board has A0 and A1 swapped on the DL3416/3422 footprint */
+extern bool a0_a1_not_swapped;
+extern struct bus_timing bus_timing;
+extern struct display_shadow disp_shadow;
+
+void busSetTiming(const struct bus_timing *t);
+void busSetDefaultTiming(void);
+void writeByte(uint8_t addr, uint8_t data);
+/* Writes data[i] to addr+i for i < n */
+void writeBurst(uint8_t addr, const uint8_t *data, uint8_t n);
+/* has_read only */
+uint8_t readByte(uint8_t addr);
+/* HDSP-2xxx and PD2816 only */
+void writeControlRegister(uint8_t data);
+/* has_read only */
+uint8_t readControlRegister(void);
+void displayChar(uint8_t pos, uint8_t c);
+/* has_read only */
+uint8_t readChar(uint8_t pos);
+/* has_cursor only */
+void setCursorMask(uint8_t bitmask);
+/* HDSP-2xxx only */
+void setFlashMask(uint8_t bitmask);
+/* HDSP-2xxx only */
+uint8_t readFlashMask(void);
+/* has_udc only */
+void setUserDefinedChar_P(uint8_t idx, PGM_P strip, uint8_t firstrow);
+/* has_udc only */
+void setUserDefinedChar(uint8_t idx, const uint8_t *rows);
+/* Starts a reset and returns at once; resetPoll() advances it and */
+/* returns true when it is finished. Writes before then are lost. */
+void resetStart(enum reset_kind kind);
+bool resetPoll(void);
+/* Blocking versions */
+void hardResetDisplay(void);
+void softResetDisplay(void);
+void setDisplayType(enum display_type type);
+/* Properties of a type other than the current one (see multi.h) */
+void displaySpec(enum display_type type, struct display_spec *spec);
+
+void ptextBegin(struct ptext *t, PGM_P packed);
+uint8_t ptextNext(struct ptext *t);
+void displayString_P(PGM_P str);
+void fillDisplay(uint8_t c, uint8_t ndigits);
@@ -0,0 +1,189 @@
+#include "fmt.h"
+#include "display.h"
+#include "panel.h"
+
+#include <avr/io.h>
+
+enum fmt_source {
+  FMT_RAM,
+  FMT_PGM,
+  FMT_PTEXT,
+};
+
+struct source {
+  enum fmt_source kind;
+  const char *p;
+  struct ptext t;
+};
+
+static const uint32_t powers_of_ten[] PROGMEM = {
+  1, 10, 100, 1000, 10000, 100000, 1000000,
+  10000000, 100000000, 1000000000,
+};
+
+
+void fmtDisplay(struct fmt *f, uint8_t pos, uint8_t width) {
+  uint8_t end = pos+width;
+  if (width == 0 || end > disp.num_digits) { end = disp.num_digits; }
+  f->row = FMT_DISPLAY;
+  f->pos = pos;
+  f->end = end;
+  f->attr = 0;
+}
+
+
+void fmtPanel(struct fmt *f, uint8_t row, uint8_t col, uint8_t width, uint8_t attr) {
+  uint8_t end = col+width;
+  if (width == 0 || end > PANEL_COLS) { end = PANEL_COLS; }
+  f->row = row;
+  f->pos = col;
+  f->end = end;
+  f->attr = attr;
+}
+
+
+void fmtChar(struct fmt *f, uint8_t c) {
+  if (f->pos < f->end) {
+    if (f->row == FMT_DISPLAY) {
+      displayChar(f->pos, c);
+    } else {
+      panelPut(f->row, f->pos, c, f->attr);
+    }
+  }
+  if (f->pos != 0xFF) { f->pos++; }
+}
+
+
+static void fmtRepeat(struct fmt *f, uint8_t c, uint8_t n) {
+  while (n--) { fmtChar(f, c); }
+}
+
+
+void fmtPad(struct fmt *f) {
+  while (f->pos < f->end) { fmtChar(f, ' '); }
+}
+
+
+static uint8_t sourceNext(struct source *s) {
+  switch (s->kind) {
+    case FMT_RAM:   return *s->p++;
+    case FMT_PGM:   return pgm_read_byte(s->p++);
+    case FMT_PTEXT: return s->t.remaining ? ptextNext(&s->t) : 0;
+  }
+  return 0;
+}
+
+
+static uint8_t sourceLength(const struct source *s, uint8_t max) {
+  if (s->kind == FMT_PTEXT) {
+    return (s->t.remaining < max) ? s->t.remaining : max;
+  }
+  uint8_t len = 0;
+  const char *p = s->p;
+  while (len < max && ((s->kind == FMT_RAM) ? *p : pgm_read_byte(p))) {
+    p++;
+    len++;
+  }
+  return len;
+}
+
+
+static void fmtSource(struct fmt *f, struct source *s, uint8_t width, uint8_t flags) {
+  /* only right-aligned fields need the length up front */
+  uint8_t len = width;
+  if (width == 0 || !(flags & FMT_LEFT)) {
+    len = sourceLength(s, width ? width : 0xFF);
+  }
+  uint8_t pad = (width > len) ? width-len : 0;
+  if (!(flags & FMT_LEFT)) { fmtRepeat(f, ' ', pad); }
+  while (len--) {
+    uint8_t c = sourceNext(s);
+    if (c == 0) {
+      pad += len+1;
+      break;
+    }
+    fmtChar(f, c);
+  }
+  if (flags & FMT_LEFT) { fmtRepeat(f, ' ', pad); }
+}
+
+
+void fmtStr(struct fmt *f, const char *s, uint8_t width, uint8_t flags) {
+  struct source src = { .kind = FMT_RAM, .p = s };
+  fmtSource(f, &src, width, flags);
+}
+
+
+void fmtStr_P(struct fmt *f, PGM_P s, uint8_t width, uint8_t flags) {
+  struct source src = { .kind = FMT_PGM, .p = s };
+  fmtSource(f, &src, width, flags);
+}
+
+
+void fmtStrEE(struct fmt *f, uint8_t s, uint8_t width, uint8_t flags) {
+  /* EEPROM is memory-mapped on megaAVR 0-series */
+  fmtStr(f, (const char *)(MAPPED_EEPROM_START+s), width, flags);
+}
+
+
+void fmtPtext(struct fmt *f, PGM_P packed, uint8_t width, uint8_t flags) {
+  struct source src = { .kind = FMT_PTEXT };
+  ptextBegin(&src.t, packed);
+  fmtSource(f, &src, width, flags);
+}
+
+
+/* sign: 0, '-' or '+'; frac: digits after the decimal point */
+static void fmtNumber(struct fmt *f, uint32_t v, uint8_t sign, uint8_t frac,
+                      uint8_t width, uint8_t flags) {
+  uint8_t ndigits = 1;
+  if (flags & FMT_HEX) {
+    while (ndigits < 8 && (v >> (ndigits*4))) { ndigits++; }
+    frac = 0;
+  } else {
+    while (ndigits < 10 && v >= pgm_read_dword(&powers_of_ten[ndigits])) { ndigits++; }
+  }
+  if (ndigits <= frac) { ndigits = frac+1; }
+
+  uint8_t len = ndigits + (frac ? 1 : 0) + (sign ? 1 : 0);
+  uint8_t pad = (width > len) ? width-len : 0;
+  if (!(flags & (FMT_LEFT|FMT_ZERO))) { fmtRepeat(f, ' ', pad); }
+  if (sign) { fmtChar(f, sign); }
+  if ((flags & (FMT_LEFT|FMT_ZERO)) == FMT_ZERO) { fmtRepeat(f, '0', pad); }
+
+  while (ndigits--) {
+    uint8_t d;
+    if (flags & FMT_HEX) {
+      d = (v >> (ndigits*4)) & 0xF;
+      d += (d <= 9) ? '0' : 'A'-10;
+    } else {
+      uint32_t p = pgm_read_dword(&powers_of_ten[ndigits]);
+      d = '0';
+      while (v >= p) { v -= p; d++; }
+    }
+    fmtChar(f, d);
+    if (frac && ndigits == frac) { fmtChar(f, '.'); }
+  }
+  if (flags & FMT_LEFT) { fmtRepeat(f, ' ', pad); }
+}
+
+
+void fmtUint(struct fmt *f, uint32_t v, uint8_t width, uint8_t flags) {
+  fmtNumber(f, v, 0, 0, width, flags);
+}
+
+
+void fmtInt(struct fmt *f, int32_t v, uint8_t width, uint8_t flags) {
+  fmtFixed(f, v, 0, width, flags);
+}
+
+
+void fmtFixed(struct fmt *f, int32_t v, uint8_t frac, uint8_t width, uint8_t flags) {
+  uint8_t sign = (flags & FMT_PLUS) ? '+' : 0;
+  uint32_t mag = v;
+  if (v < 0) {
+    sign = '-';
+    mag = -mag;
+  }
+  fmtNumber(f, mag, sign, (frac < 9) ? frac : 9, width, flags & ~FMT_HEX);
+}
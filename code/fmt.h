@@ -0,0 +1,60 @@
+/**
+ * Text and number formatting straight into a display window.
+ *
+ * A window is a run of positions on the display under test (written with
+ * displayChar()) or on one row of the panel framebuffer (panel_fb). Each
+ * call appends one field at the window's current position; characters
+ * past the end of the window are dropped, so a field never spills into
+ * the next one. Nothing is formatted into a buffer first: numbers are
+ * produced most significant digit first, by repeated subtraction of powers
+ * of ten (the AVR has no divide instruction), and strings are copied a
+ * character at a time from RAM, program memory, EEPROM or a packed
+ * message.
+ *
+ * Field widths of 0 mean "as wide as the value". Numbers wider than their
+ * field are never truncated, only clipped by the window; strings are cut to
+ * the field width.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <avr/pgmspace.h>
+
+/* Field flags */
+#define FMT_LEFT  0b00000001  /* pad on the right instead of the left */
+#define FMT_ZERO  0b00000010  /* pad numbers with zeros after the sign */
+#define FMT_HEX   0b00000100  /* unsigned numbers in upper-case hex */
+#define FMT_PLUS  0b00001000  /* show '+' on non-negative signed numbers */
+
+/* Window row for the display under test */
+#define FMT_DISPLAY  0xFF
+
+struct fmt {
+  uint8_t row;   /* panel row, or FMT_DISPLAY */
+  uint8_t pos;   /* next position; may run past the end */
+  uint8_t end;   /* first position after the window */
+  uint8_t attr;  /* panel cell attributes */
+};
+
+/* Window of "width" digits starting at pos (0: to the last digit) */
+void fmtDisplay(struct fmt *f, uint8_t pos, uint8_t width);
+/* Window of "width" columns of a panel row (0: to the last column) */
+void fmtPanel(struct fmt *f, uint8_t row, uint8_t col, uint8_t width, uint8_t attr);
+
+void fmtChar(struct fmt *f, uint8_t c);
+/* Blanks the rest of the window */
+void fmtPad(struct fmt *f);
+
+/* NUL-terminated strings */
+void fmtStr(struct fmt *f, const char *s, uint8_t width, uint8_t flags);
+void fmtStr_P(struct fmt *f, PGM_P s, uint8_t width, uint8_t flags);
+/* s is an EEPROM address */
+void fmtStrEE(struct fmt *f, uint8_t s, uint8_t width, uint8_t flags);
+/* Packed message (see tools/packmsg.py) */
+void fmtPtext(struct fmt *f, PGM_P packed, uint8_t width, uint8_t flags);
+
+void fmtUint(struct fmt *f, uint32_t v, uint8_t width, uint8_t flags);
+void fmtInt(struct fmt *f, int32_t v, uint8_t width, uint8_t flags);
+/* v in units of 10^-frac, e.g. fmtFixed(f, 1234, 2, ...) shows 12.34 */
+void fmtFixed(struct fmt *f, int32_t v, uint8_t frac, uint8_t width, uint8_t flags);
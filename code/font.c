@@ -0,0 +1,21 @@
+#include "font.h"
+#include "charset.h"
+
+#include <avr/pgmspace.h>
+
+#include "font5x7.h"
+
+
+void fontGlyph(uint8_t c, uint8_t rows[FONT_ROWS]) {
+  if (charsetGlyph(c, rows)) { return; }
+  if (c < FONT_FIRST || c > FONT_LAST) {
+    for (uint8_t row = 0; row < FONT_ROWS; row++) { rows[row] = 0; }
+    return;
+  }
+  /* rows are 5 bits each, packed LSB-first */
+  uint16_t bit = (c-FONT_FIRST)*(FONT_ROWS*FONT_WIDTH);
+  for (uint8_t row = 0; row < FONT_ROWS; row++) {
+    rows[row] = (pgm_read_word(font5x7 + (bit >> 3)) >> (bit & 7)) & 0b00011111;
+    bit += FONT_WIDTH;
+  }
+}
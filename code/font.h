@@ -0,0 +1,17 @@
+/**
+ * 5x7 font for building user-defined characters from text
+ * (font.def, packed into font5x7.h by tools/packmsg.py).
+ */
+#pragma once
+
+#include <stdint.h>
+
+#define FONT_FIRST  ' '
+#define FONT_LAST   '~'
+#define FONT_ROWS   7
+#define FONT_WIDTH  5
+
+/* Rows of character c, top first, leftmost pixel in bit 4; blank if the */
+/* font doesn't have it. Codes of fallback glyphs (see charset.h) give the */
+/* glyph. */
+void fontGlyph(uint8_t c, uint8_t rows[FONT_ROWS]);
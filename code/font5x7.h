@@ -0,0 +1,47 @@
+/* Generated by tools/packmsg.py from font.def -- do not edit. */
+/*
+ * Flash usage in bytes (raw = unpacked 8-bit PROGMEM equivalent):
+ *   kind     count      raw   packed
+ *   glyphs       1      665      417
+ *   total               665      417
+ */
+#pragma once
+
+#define FONT5X7_ROWS 665
+static const char font5x7[] PROGMEM = {
+  0x00, 0x00, 0x00, 0x00, 0x20, 0x84, 0x10, 0x02, 0x88, 0x52, 0x0A, 0x00,
+  0x00, 0x94, 0xFA, 0xEA, 0x2B, 0x45, 0x1E, 0x75, 0xC5, 0x13, 0x9C, 0x05,
+  0x41, 0x73, 0x30, 0x49, 0x51, 0x95, 0x8D, 0x11, 0x04, 0x00, 0x00, 0x82,
+  0x20, 0x84, 0x88, 0x40, 0x44, 0x08, 0x41, 0x10, 0x20, 0xD5, 0x55, 0x02,
+  0x00, 0x21, 0x9F, 0x10, 0x00, 0x00, 0x00, 0x8C, 0x20, 0x00, 0xC0, 0x07,
+  0x00, 0x00, 0x00, 0x00, 0x60, 0x0C, 0x04, 0x41, 0x10, 0x04, 0x2E, 0xCE,
+  0x9A, 0xA3, 0x23, 0x8C, 0x10, 0x42, 0x9C, 0x8B, 0x41, 0x10, 0xF4, 0xBF,
+  0x20, 0x22, 0x44, 0x27, 0x8C, 0x92, 0x5F, 0x88, 0x0F, 0x7D, 0x08, 0xD1,
+  0x19, 0x04, 0x7D, 0x8C, 0xEE, 0x07, 0x41, 0x10, 0x42, 0x2E, 0x46, 0x17,
+  0xA3, 0x73, 0x31, 0xBE, 0x20, 0x18, 0x60, 0x0C, 0x30, 0x06, 0x00, 0x63,
+  0x80, 0x11, 0x24, 0x08, 0x82, 0x88, 0x08, 0x00, 0x3E, 0xF8, 0x00, 0x20,
+  0x22, 0x82, 0x20, 0xC8, 0xC5, 0x20, 0x08, 0x20, 0x2E, 0x86, 0x56, 0xAB,
+  0x73, 0x31, 0xC6, 0x1F, 0xA3, 0x8F, 0xD1, 0xC7, 0xE8, 0x5D, 0x84, 0x10,
+  0x46, 0xC7, 0x65, 0x8C, 0x51, 0xF2, 0x0F, 0xA1, 0x87, 0xF0, 0x7F, 0x08,
+  0x3D, 0x84, 0xD0, 0x45, 0x78, 0x63, 0x7C, 0x31, 0xC6, 0x1F, 0x63, 0x74,
+  0x84, 0x10, 0x42, 0xDC, 0x11, 0x42, 0x08, 0xC9, 0xA2, 0xA4, 0x98, 0xCA,
+  0x08, 0x21, 0x84, 0x10, 0xFE, 0xB8, 0x6B, 0x8D, 0x31, 0xC6, 0x98, 0xEB,
+  0x8C, 0xD1, 0xC5, 0x18, 0x63, 0x74, 0x3E, 0x46, 0x0F, 0x21, 0x74, 0x31,
+  0xC6, 0x2A, 0x9B, 0x8F, 0xD1, 0x53, 0x19, 0x1F, 0x84, 0x2E, 0x04, 0xFF,
+  0x09, 0x21, 0x84, 0x90, 0x18, 0x63, 0x8C, 0xD1, 0xC5, 0x18, 0x63, 0x54,
+  0x24, 0xC6, 0x58, 0x6B, 0x55, 0x31, 0x2A, 0xA2, 0x62, 0x8C, 0x31, 0x2A,
+  0x42, 0xC8, 0x0F, 0x82, 0x20, 0xF8, 0x1D, 0x42, 0x08, 0x21, 0x07, 0x20,
+  0x22, 0x22, 0x00, 0x27, 0x84, 0x10, 0xC2, 0x11, 0x15, 0x01, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0xF8, 0x88, 0x08, 0x00, 0x00, 0x00, 0xC0, 0x85, 0x17,
+  0x1F, 0x84, 0x36, 0xC7, 0xE8, 0x01, 0x70, 0x10, 0x46, 0x17, 0x42, 0x9B,
+  0x31, 0x3E, 0x00, 0x5C, 0xFC, 0xD0, 0x99, 0x84, 0x38, 0x42, 0x08, 0xBC,
+  0x18, 0x5F, 0x70, 0x10, 0xDA, 0x1C, 0x63, 0x24, 0x80, 0x11, 0x42, 0x9C,
+  0x00, 0x46, 0x08, 0xC9, 0x20, 0x94, 0x14, 0x53, 0xC9, 0x08, 0x21, 0x84,
+  0x38, 0x00, 0x74, 0xAD, 0x31, 0x02, 0x60, 0x73, 0x8C, 0x11, 0x00, 0x17,
+  0x63, 0x74, 0x00, 0xF8, 0xE8, 0x21, 0x04, 0xA0, 0xCD, 0x17, 0x02, 0x00,
+  0x36, 0x43, 0x08, 0x01, 0x70, 0xD0, 0x05, 0x8F, 0x10, 0x47, 0x28, 0x19,
+  0x00, 0x62, 0x8C, 0xB3, 0x01, 0x10, 0x63, 0x54, 0x04, 0x80, 0x18, 0x6B,
+  0x55, 0x00, 0x44, 0x45, 0x54, 0x04, 0x20, 0xC6, 0x17, 0x1C, 0x00, 0x5F,
+  0x10, 0xF4, 0x05, 0x21, 0x88, 0x10, 0x41, 0x08, 0x21, 0x84, 0x10, 0x44,
+  0x88, 0x20, 0x04, 0x01, 0x80, 0xAA, 0x00, 0x00, 0x00,
+};
@@ -0,0 +1,115 @@
+#include "governor.h"
+#include "console.h"
+#include "display.h"
+#include "panel.h"
+#include "sched.h"
+
+#define PANEL_CELLS  (PANEL_ROWS*PANEL_COLS)
+
+static uint8_t stage[PANEL_CELLS];
+static uint8_t stage_mask[PANEL_CELLS/8];
+static uint8_t latched[PANEL_CELLS];
+static uint8_t latched_mask[PANEL_CELLS/8];
+static bool staged;
+static bool have_latched;
+static bool draining;
+static bool measuring;
+static uint16_t visited_at;
+static uint16_t commit_us;
+static uint32_t commit_ms;
+static struct gov_status status;
+
+
+static uint16_t cellNs(void) {
+  /* writeByte() waits out setup and hold twice each (see bus_timing) */
+  uint16_t cycles = 2*bus_timing.setup + bus_timing.strobe + 2*bus_timing.hold +
+                    GOV_CELL_OVERHEAD_CYCLES;
+  return (uint32_t)cycles * 1000 / (F_CPU/1000000);
+}
+
+
+static uint16_t backlogUs(void) {
+  return (uint32_t)panelPending() * cellNs() / 1000;
+}
+
+
+void govStage(uint8_t pos, uint8_t c) {
+  stage[pos] = c;
+  stage_mask[pos >> 3] |= 1 << (pos & 7);
+  staged = true;
+}
+
+
+void govLatch(void) {
+  if (!staged) { return; }
+  staged = false;
+  have_latched = true;
+  for (uint8_t i = 0; i < sizeof(stage_mask); i++) {
+    uint8_t pos = i*8;
+    for (uint8_t bits = stage_mask[i]; bits; pos++, bits >>= 1) {
+      if (bits & 1) { latched[pos] = stage[pos]; }
+    }
+    latched_mask[i] |= stage_mask[i];
+    stage_mask[i] = 0;
+  }
+}
+
+
+void govCommit(void) {
+  if (!have_latched) { return; }
+  have_latched = false;
+  for (uint8_t i = 0; i < sizeof(latched_mask); i++) {
+    uint8_t pos = i*8;
+    for (uint8_t bits = latched_mask[i]; bits; pos++, bits >>= 1) {
+      if (bits & 1) { panelPut(pos / PANEL_COLS, pos % PANEL_COLS, latched[pos], 0); }
+    }
+    latched_mask[i] = 0;
+  }
+  status.frames++;
+  if (draining) {
+    /* whatever of the last frame is still queued is written as this one */
+    status.merged++;
+  }
+  status.cell_ns = cellNs();
+  status.cost_us = backlogUs();
+  draining = true;
+  if (!measuring) {
+    measuring = true;
+    visited_at = panelVisited();
+    commit_us = schedMicros();
+    commit_ms = schedMillis();
+  }
+}
+
+
+void govDropped(void) {
+  status.dropped++;
+}
+
+
+void govPoll(void) {
+  if (!draining) { return; }
+  bool done = panelFlush(GOV_FLUSH_CELLS);
+  if (measuring && (done || (uint16_t)(panelVisited() - visited_at) >= PANEL_CELLS)) {
+    measuring = false;
+    /* schedMicros() wraps every 65 ms */
+    uint16_t us = (schedMillis() - commit_ms < 60) ? schedMicros() - commit_us : GOV_LATENCY_MAX;
+    status.latency_us = us;
+    if (us > status.max_latency_us) { status.max_latency_us = us; }
+  }
+  if (done) { draining = false; }
+}
+
+
+bool govBusy(void) {
+  if (!draining || backlogUs() <= GOV_BUSY_US) { return false; }
+  status.busy++;
+  return true;
+}
+
+
+void govReport(void) {
+  consoleFrameBegin('V', sizeof(status));
+  consoleFrameData(&status, sizeof(status));
+  consoleFrameEnd();
+}
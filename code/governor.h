@@ -0,0 +1,69 @@
+/**
+ * Frame-rate governor for panel frames streamed over the ring (net.h).
+ *
+ * Flushing a whole panel frame takes longer than the 64-byte receive
+ * buffer (uart.c) lasts at 1 Mbaud, so a commit that blocked until the
+ * panel was up to date lost the frames behind it, and the host's
+ * retransmissions put the panel further behind. Instead, 'W' frames for
+ * the panel are staged here, an 'F' frame latches them (govLatch()), its
+ * deadline puts them into the panel framebuffer (govCommit()), and
+ * govPoll() writes GOV_FLUSH_CELLS cells per netPoll(). Cells staged
+ * between an 'F' and its deadline wait for the next 'F'.
+ *
+ * A commit that arrives while the last frame is still going out is
+ * merged into it cell by cell: the flush writes what the framebuffer
+ * holds when it gets to a cell, so cells superseded in the meantime are
+ * never written. As the flush goes round the panel (panel.h), every
+ * frame is out within one pass of at most PANEL_ROWS*PANEL_COLS writes,
+ * and the panel shows the newest frame however fast they arrive.
+ *
+ * The bus time of a cell is estimated from the current bus timing
+ * (display.h) plus GOV_CELL_OVERHEAD_CYCLES for the code around the
+ * write; the cost of a frame is that times the cells still to write.
+ * While that is over GOV_BUSY_US, 'W' and 'F' frames to the board are
+ * acknowledged with NET_ACK_BUSY: they are taken, but the host should
+ * send less often (tools/netbus.py keeps a set of busy boards).
+ *
+ * Counters are reported as frame 'V' (console command 'V'), a struct
+ * gov_status. Latency runs from a commit until its frame is all written;
+ * while one is being measured, further commits are only counted.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* cells written per netPoll() */
+#define GOV_FLUSH_CELLS           8
+/* panelSelect(), displayChar() and the loop around them, beyond the bus */
+/* intervals themselves */
+#define GOV_CELL_OVERHEAD_CYCLES  60
+/* queued work beyond which the sender is asked to slow down */
+#define GOV_BUSY_US               250
+#define GOV_LATENCY_MAX           0xFFFF
+
+struct gov_status {
+  uint16_t frames;           /* panel commits */
+  uint16_t merged;           /* committed while the previous frame was going out */
+  uint16_t dropped;          /* replaced by a later commit before their own was due */
+  uint16_t busy;             /* frames acknowledged with NET_ACK_BUSY */
+  uint16_t cell_ns;          /* estimated bus time per cell */
+  uint16_t cost_us;          /* estimated time to write the last frame */
+  uint16_t latency_us;       /* last frame; GOV_LATENCY_MAX if longer */
+  uint16_t max_latency_us;
+};
+
+/* Stages a panel cell (position row*PANEL_COLS + column) for the next commit */
+void govStage(uint8_t pos, uint8_t c);
+/* Takes the staged cells for the next govCommit() */
+void govLatch(void);
+/* Puts the latched cells into the panel framebuffer */
+void govCommit(void);
+/* Counts a commit that a later one replaced before it was due */
+void govDropped(void);
+/* Writes some of what is queued; call often while the panel is in use */
+void govPoll(void);
+/* True if the sender should slow down; counted as a busy answer */
+bool govBusy(void);
+/* Sends frame 'V' */
+void govReport(void);
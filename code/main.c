@@ -16,10 +16,16 @@
  * - DL3422 (4-char segmented)
  * - PD2816 (8-char segmented)
  * - HDSP-2xxx, PD188x (8-char dot matrix)
+ * - Extended features of HDLx-2416 and HDLx-3416 (cursor blink and
+ *   dimming through CUE and ~BL)
  *
  * Not currently supported:
- * - PD243x, PD353x, PD443x (4-char dot matrix)
- * - Extended features of HDLx-2416 and HDLx-3416
+ * - PD243x, PD353x, PD443x (4-char dot matrix). The board has no socket
+ *   for them (see alphadisplays.net), so there is no display type, probe
+ *   or bus timing for them until a socket and a verified register map
+ *   exist.
+ * - The HDLx-2416/3416 functions the DL2416/DL3416 sockets don't wire
+ *   (the pins beyond A0, A1, ~CU, CUE and ~BL).
  *
  * Controls (during menu):
  * - SW1: advance to next menu item
@@ -32,7 +38,7 @@
  * PD2816 and HDSP-2xxx/PD188x devices are auto-detected by checking for the
  * presence of their clock output signals. On powerup, if one of these devices
  * is detected, the display will show "HDSP2xxx" or "PD2816  ". Press SW2 to
- * begin the test.
+ * begin the test, or SW1 for the menu.
  *
  * Otherwise, a menu is shown. Press SW1 to cycle through the menu items to
  * select the display type. Press SW2 to confirm. Some types have an additional
@@ -49,10 +55,14 @@
  *     "2416"
  *       "SEGM" (DL2416, HPDL-2416)
  *       "MTRX" (DLx-2416, HDLx-2416)
+ *       "HDLX" (HDLx-2416, extended features)
  *     "3416"
  *       "SEGM" (DL3416)
  *       "MTRX" (DLx-3416, HDLx-3416)
+ *       "HDLX" (HDLx-3416, extended features)
  *     "3422" (DL3422)
+ *     "TERM" (4x4 PDSP1881 panel as a serial terminal, see term.h)
+ *     "MULT" (every socket at once, see below)
  *
  * Menu selections are saved in nonvolatile memory and recalled at powerup to
  * facilitate testing multiple displays in a row.
@@ -66,6 +76,11 @@
  * recalled at powerup. "Normal" behavior can be restored by performing the
  * same procedure a second time.
  *
+ * A board on a ring of boards (see net.h) comes up showing the last frame
+ * the host committed to it, within a millisecond or so of powerup, before
+ * the part is detected (see boot.h). It keeps showing it, and whatever the
+ * host sends, until a button is pressed; then it carries on as above.
+ *
  * Test suite
  * ----------
  * 1. Display "ABCD" or "ABCDEFGH".
@@ -96,6 +111,8 @@
  * 9. (DL1814/2416/3416/3422) Test blanking pin.
  *     9a. Display "ABCD" or "ABCDEFGH".
  *     9b. Flash the display three times.
+ *     9c. (extended HDLx only) Dim the display in steps by driving ~BL with
+ *         a PWM signal, then blink the cursor in all digits by toggling CUE.
  * 10. (HDSP-2xxx only) Test user-defined-character RAM.
  *     10a. Blank the display.
  *     10b. Animate a pattern scrolling upward on each digit from left to right.
@@ -117,309 +134,94 @@
  * 12. Show each displayable character and its code point. The  2-digit ASCII
  *     code shown in hexadecimal in leftmost two digits. Third digit is blank.
  *     Remaining digits show the character.
- * 13. Display "DONE".
+ * 13. Display "DONE" and the number of parts tested so far (8-digit parts;
+ *     "9999" for 9999 or more).
  * 14. Scroll the full displayable character set. Loops continuously until SW1
  *     is pressed or power is disconnected.
  *
+ * Multi-socket test
+ * -----------------
+ * "MULT" runs steps 1-5 on every socket of the board in one pass, so a tray
+ * of mixed parts can be checked without a menu trip per part. All sockets
+ * share the bus, so every part sees every write; multi.h merges the write
+ * streams of the part types so each part shows its test in its own digit
+ * order. Text like "ABCDEFGH" is shown to HDSP-2xxx and to the other parts
+ * in turn; with an HDSP-2xxx inserted, the gradual fills of the others run
+ * from both ends. A PD2816 or HDSP-2xxx is included (and its control
+ * register set up) when its clock is detected. The tester cannot tell which
+ * of the other sockets hold a part, so multi-socket runs are not logged.
+ * Ends showing "DONE"; press SW1 to return to the menu.
+ *
+ * Result log
+ * ----------
+ * When the suite reaches "DONE", the part's result (display type, first
+ * failing test and address/bits, HDSP-2xxx self-test duration) is appended
+ * to a log of the last 16 parts in EEPROM and sent over the serial port.
+ * Use tools/tester.py to dump the log or to capture results live. See
+ * uart.h for serial port wiring. A production line can chain several
+ * testers on one serial port (net.h); each keeps its log and reports to the
+ * host with its node id.
+ *
+ * Bus timing
+ * ----------
+ * PD2816 and HDSP-2xxx parts can be characterized with "tools/tester.py PORT
+ * shmoo" while the tester is idle (menu or "DONE" scroll; it is refused
+ * during a test). The tester finds the shortest bus timing that still reads
+ * back correctly and keeps the worst case over all runs; tests of that part
+ * type then run with a small margin over it where that is faster than the
+ * conservative default. See shmoo.h.
+ *
  * Note: It's not recommended to plug in or unplug displays while the board is
  * powered up. Even when using a ZIF socket, "hot-swapping" is not recommended.
  * These displays are old, rare, and expensive!
  */
 
 #include "pin_xmega.h"
-#include "delay_ns.h"
+#include "pins.h"
+#include "pins_net.h"  /* checks pins.h against the schematic */
+#include "blink.h"
+#include "boot.h"
+#include "console.h"
+#include "display.h"
+#include "fmt.h"
+#include "multi.h"
+#include "net.h"
+#include "profile.h"
+#include "resultlog.h"
+#include "sched.h"
+#include "settings.h"
+#include "term.h"
+#include "uart.h"
 
 #include <stdint.h>
 #include <stdbool.h>
-#include <avr/eeprom.h>
 #include <avr/interrupt.h>
 #include <avr/pgmspace.h>
 #include <util/delay.h>
 
-/* active high */
-#define LED_PORT        D
-#define LED_PIN         7
-/* ~WR - write (active low) */
-#define nWR_PORT        E
-#define nWR_PIN         1
-/* ~CE - chip enable (active low) */
-#define nCE_PORT        E
-#define nCE_PIN         2
-/* ~CLR (2416/3416/3422) / ~RST (HDSP-2xxx/PD2816) - clear/reset display (active low) */
-#define nCLR_PORT       E
-#define nCLR_PIN        3
-/* ~RD (HDSP-2xxx/PD2816) - read (active low) */
-#define nRD_PORT        B
-#define nRD_PIN         0
-/* CUE (2416/3416/3422) - cursor enable (active high) */
-#define CUE_PORT        B
-#define CUE_PIN         2
-/* ~BL (2416/3416/3422) - blank display (active low) */
-#define nBL_PORT        B
-#define nBL_PIN         3
-/* Button 1 (left) */
-#define nSW1_PORT       C
-#define nSW1_PIN        1
-/* Button 2 (right) */
-#define nSW2_PORT       C
-#define nSW2_PIN        0
-/* HDSP-2xxx clock detect */
-#define HDSPCLK_PORT    C
-#define HDSPCLK_PIN     2
-/* PD2816 clock detect */
-#define PD2816CLK_PORT  C
-#define PD2816CLK_PIN   3
-/* Data lines D0-D7 */
-#define DATA_PORT       A
-/* Address lines A0-A4 and ~FL. ~CU is A3. */
-#define ADDRESS_PORT    F
-
-/* Address bits */
-#define ADDR_FL  5
-#define ADDR_A4  4
-#define ADDR_A3  3
-#define ADDR_nCU ADDR_A3
-#define ADDR_A2  2
-#define ADDR_A1  1
-#define ADDR_A0  0
-
-/* Control register bits */
-#define CR_CLEAR                  0b10000000
-#define CR_PD2816_BRIGHTNESS_0    0b00000000
-#define CR_PD2816_BRIGHTNESS_25   0b00000001
-#define CR_PD2816_BRIGHTNESS_50   0b00000010
-#define CR_PD2816_BRIGHTNESS_100  0b00000011
-#define CR_PD2816_CHAR_SOLID      0b00000000
-#define CR_PD2816_CHAR_BLINK      0b00000100
-#define CR_PD2816_UNDERLINE_SOLID 0b00000000
-#define CR_PD2816_UNDERLINE_BLINK 0b00001000
-#define CR_PD2816_ATTRS_ON        0b00010000
-#define CR_PD2816_BLINK_DISPLAY   0b00100000
-#define CR_PD2816_LAMP_TEST       0b01000000
-#define CR_HDSP_BRIGHTNESS_100    0b00000000
-#define CR_HDSP_BRIGHTNESS_80     0b00000001
-#define CR_HDSP_BRIGHTNESS_53     0b00000010
-#define CR_HDSP_BRIGHTNESS_40     0b00000011
-#define CR_HDSP_BRIGHTNESS_27     0b00000100
-#define CR_HDSP_BRIGHTNESS_20     0b00000101
-#define CR_HDSP_BRIGHTNESS_13     0b00000110
-#define CR_HDSP_BRIGHTNESS_0      0b00000111
-#define CR_HDSP_FLASH_ON          0b00001000
-#define CR_HDSP_BLINK_DISPLAY     0b00010000
-#define CR_HDSP_SELF_TEST_RESULT  0b00100000
-#define CR_HDSP_SELF_TEST_START   0b01000000
-
 #define INTER_CHAR_DELAY_MS         250
 #define LONG_DELAY_MS               1000
 #define HDSP_SELF_TEST_DURATION_MS  7000
+/* parts tested shown at "DONE"; more show as this */
+#define PARTS_SHOWN_MAX             9999
+/* software PWM on ~BL for extended HDLx dimming */
+#define DIM_PERIOD_US               1024
+#define DIM_STEPS                   8
 
-/* Part-specific quirks */
-struct quirks {
-  uint8_t left_to_right_digit_numbering:1;
-  uint8_t has_cursor:1;
-  uint8_t cursor_parallel_load:1;
-  uint8_t has_blanking_pin:1;
-  uint8_t has_read:1;
-  uint8_t controlreg_pd2816:1;
-  uint8_t controlreg_hdsp2xxx:1;
-  uint8_t :1;
-};
-
-/* Display properties */
-struct display_spec {
-  struct quirks quirks;
-  uint8_t num_digits;
-  uint8_t asciival_min;
-  uint8_t asciival_max;
-};
-
-enum display_type {
-  DL1414,   /* segmented */
-  DLX1414,  /* dot matrix */
-  DL1416T,  /* (and DL1416, SP1-16) segmented */
-  DL1416B,  /* segmented */
-  DL1814,   /* segmented */
-  DL2416,   /* segmented */
-  DLX2416,  /* dot matrix */
-  DL3416,   /* segmented */
-  DLX3416,  /* dot matrix */
-  DL3422,   /* segmented */
-  PD2816,   /* segmented */
-  HDSP2xxx, /* (and PD188x) dot matrix */
-  /* Not supported: PD243x/353x/443x and extended features of HDLx-2416/3416 */
-  NUM_DISPLAY_TYPES
-};
-
-static const char msg_pd2816[] PROGMEM    = "PD2816  ";
-static const char msg_hdsp2xxx[] PROGMEM  = "HDSP2xxx";
-static const char msg_dl1414[] PROGMEM    = "1414";
-static const char msg_dl1416[] PROGMEM    = "1416";
-static const char msg_dl1416t[] PROGMEM   = "'16T";
-static const char msg_dl1416b[] PROGMEM   = "'16B";
-static const char msg_dl1814[] PROGMEM    = "1814";
-static const char msg_dl2416[] PROGMEM    = "2416";
-static const char msg_dl3416[] PROGMEM    = "3416";
-static const char msg_dl3422[] PROGMEM    = "3422";
-static const char msg_segmented[] PROGMEM = "SEGM";
-static const char msg_matrix[] PROGMEM    = "MTRX";
-static const char msg_abcdefgh[] PROGMEM  = "ABCDEFGH";
-static const char msg_readtest[] PROGMEM  = "READTEST";
-static const char msg_readfail[] PROGMEM  = "RD  FAIL";
-static const char msg_readok[] PROGMEM    = "READ OK ";
-static const char msg_done[] PROGMEM      = "DONE    ";
-
-/* Control register tests */
-static const char msg_brightness_13[] PROGMEM             = " 13% BRI";
-static const char msg_brightness_20[] PROGMEM             = " 20% BRI";
-static const char msg_brightness_25[] PROGMEM             = " 25% BRI";
-static const char msg_brightness_27[] PROGMEM             = " 27% BRI";
-static const char msg_brightness_40[] PROGMEM             = " 40% BRI";
-static const char msg_brightness_50[] PROGMEM             = " 50% BRI";
-static const char msg_brightness_53[] PROGMEM             = " 53% BRI";
-static const char msg_brightness_80[] PROGMEM             = " 80% BRI";
-static const char msg_brightness_100[] PROGMEM            = "100% BRI";
-static const char msg_underline[] PROGMEM                 = { 0x80|'U', 0x80|'N', 0x80|'D', 0x80|'E', 0x80|'R', 0x80|'L', 0x80|'I', 0x80|'N', 0 };
-static const char msg_charblink_underline[] PROGMEM       = { 0x80|'C', 0x80|'B', 0x80|'L', 0x80|'I', 0x80|'N', 0x80|'K', 0x80|'+', 0x80|'U', 0 };
-static const char msg_underline_blink[] PROGMEM           = { 0x80|'U', 0x80|'L', 0x80|'.', 0x80|'B', 0x80|'L', 0x80|'I', 0x80|'N', 0x80|'K', 0 };
-static const char msg_char_and_underline_blink[] PROGMEM  = { 0x80|'B', 0x80|'L', 0x80|'I', 0x80|'N', 0x80|'K', 0x80|'+', 0x80|'U', 0x80|'L', 0 };
-static const char msg_attributes_off[] PROGMEM            = { 0x80|'(', 0x80|'N', 0x80|'O', 0x80|'R', 0x80|'M', 0x80|'A', 0x80|'L', 0x80|')', 0 };
-static const char msg_blink_all[] PROGMEM                 = "BLINKALL";
-static const char msg_lamp_test[] PROGMEM                 = "LAMPTEST";
-static const char msg_selftest[] PROGMEM                  = "SELFTEST";
-static const char msg_selftest_pass[] PROGMEM             = "S.T.PASS";
-static const char msg_selftest_fail[] PROGMEM             = "S.T.FAIL";
-static const char msg_udc_test[] PROGMEM                  = "UDC TEST";
-static const char msg_udc1[] PROGMEM                      = {0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0};
-static const char msg_udc2[] PROGMEM                      = {0x88, 0x89, 0x8A, 0x8B, 0x8C, 0x8D, 0x8E, 0x8F, 0};
-
-static const char udc[] PROGMEM = {
-  0b00000000,
-  0b00000000,
-  0b00000000,
-  0b00000000,
-  0b00000000,
-  0b00000000,
-  0b00000000,
-  0b00010000,
-  0b00011000,
-  0b00011100,
-  0b00011110,
-  0b00011111,
-  0b00001111,
-  0b00000111,
-  0b00000011,
-  0b00000001,
-  0b00000000,
-  0b00000000,
-  0b00000000,
-  0b00000000,
-  0b00000000,
-  0b00000000,
-  0b00000000
-};
-
-static const char udc2[] PROGMEM = {
-  0b00000000,
-  0b00000000,
-  0b00000000,
-  0b00000000,
-  0b00000000,
-  0b00000000,
-  0b00000000,
-  0b00000001,
-  0b00000011,
-  0b00000111,
-  0b00001111,
-  0b00011111,
-  0b00011110,
-  0b00011100,
-  0b00011000,
-  0b00010000,
-  0b00000000,
-  0b00000000,
-  0b00000000,
-  0b00000000,
-  0b00000000,
-  0b00000000,
-  0b00000000
-};
-
-
-/* Boxed hex digits 0-9, A-F */
-static const char udc_hexdigits[] PROGMEM = {
-  0b11111, 0b10001, 0b10101, 0b10101, 0b10101, 0b10001, 0b11111,
-  0b11111, 0b11011, 0b10011, 0b11011, 0b11011, 0b10001, 0b11111,
-  0b11111, 0b10001, 0b11101, 0b10001, 0b10111, 0b10001, 0b11111,
-  0b11111, 0b10001, 0b11101, 0b11001, 0b11101, 0b10001, 0b11111,
-  0b11111, 0b10101, 0b10101, 0b10001, 0b11101, 0b11101, 0b11111,
-  0b11111, 0b10001, 0b10111, 0b10001, 0b11101, 0b10001, 0b11111,
-  0b11111, 0b10001, 0b10111, 0b10001, 0b10101, 0b10001, 0b11111,
-  0b11111, 0b10001, 0b10101, 0b10101, 0b11101, 0b11101, 0b11111,
-  0b11111, 0b10001, 0b10101, 0b10001, 0b10101, 0b10001, 0b11111,
-  0b11111, 0b10001, 0b10101, 0b10001, 0b11101, 0b10001, 0b11111,
-  0b11111, 0b10001, 0b10101, 0b10001, 0b10101, 0b10101, 0b11111,
-  0b11111, 0b10001, 0b10101, 0b10011, 0b10101, 0b10001, 0b11111,
-  0b11111, 0b10001, 0b10111, 0b10111, 0b10111, 0b10001, 0b11111,
-  0b11111, 0b10011, 0b10101, 0b10101, 0b10101, 0b10011, 0b11111,
-  0b11111, 0b10001, 0b10111, 0b10011, 0b10111, 0b10001, 0b11111,
-  0b11111, 0b10001, 0b10111, 0b10011, 0b10111, 0b10111, 0b11111,
-};
+/* Messages, UDC glyphs and animation strips (packed by tools/packmsg.py) */
+#include "messages.h"
 
 
-static const struct display_spec DISPLAYS[NUM_DISPLAY_TYPES] PROGMEM =
-{
-  [DL1414] = {
-    .quirks={0},
-    .num_digits=4, .asciival_min=' ', .asciival_max='_',
-  },
-  [DLX1414] = {
-    .quirks={0},
-    .num_digits=4, .asciival_min='\0', .asciival_max='\x7f',
-  },
-  [DL1416T] = { /* or DL1416, SP1-16, uses a different cursor scheme */
-    .quirks={ .has_cursor=1, .cursor_parallel_load=1 },
-    .num_digits=4, .asciival_min=' ', .asciival_max='_',
-  },
-  [DL1416B] = { /* uses the same cursor scheme as DL2416/3416/3422 */
-    .quirks={ .has_cursor=1, },
-    .num_digits=4, .asciival_min=' ', .asciival_max='_',
-  },
-  [DL1814] = {
-    .quirks={ .has_blanking_pin=1 },
-    .num_digits=8, .asciival_min=' ', .asciival_max='_',
-  },
-  [DL2416] = {
-    .quirks={ .has_cursor=1, .has_blanking_pin=1 },
-    .num_digits=4, .asciival_min=' ', .asciival_max='_',
-  },
-  [DLX2416] = {
-    .quirks={ .has_cursor=1, .has_blanking_pin=1 },
-    .num_digits=4, .asciival_min='\0', .asciival_max='\x7f',
-  },
-  [DL3416] = {
-    .quirks={ .has_cursor=1, .has_blanking_pin=1 },
-    .num_digits=4, .asciival_min=' ', .asciival_max='_',
-  },
-  [DLX3416] = {
-    .quirks={ .has_cursor=1, .has_blanking_pin=1 },
-    .num_digits=4, .asciival_min='\0', .asciival_max='\x7f',
-  },
-  [DL3422] = {
-    .quirks={ .has_cursor=1, .has_blanking_pin=1 },
-    .num_digits=4, .asciival_min=' ', .asciival_max='\x7e',
-  },
-  [PD2816] = {
-    .quirks={ .controlreg_pd2816=1, .has_read=1 },
-    .num_digits=8, .asciival_min=' ', .asciival_max='_',
-  },
-  [HDSP2xxx] = {
-    .quirks={ .left_to_right_digit_numbering=1, .has_read=1, .controlreg_hdsp2xxx=1 },
-    .num_digits=8, .asciival_min='\0', .asciival_max='\x8f',
-  },
-};
+#define COUNT_OF(arr) (sizeof(arr)/sizeof((arr)[0]))
 
+/* menu_item.disptype for the panel terminal and the multi-socket test */
+#define MENU_TERMINAL  0xFE
+#define MENU_MULTI     0xFD
 
-#define COUNT_OF(arr) (sizeof(arr)/sizeof((arr)[0]))
+/* One part type for each socket without a clock output; segmented and */
+/* dot-matrix parts, and DL1416T/B, address their digits the same way */
+#define MULTI_SOCKETS  (MULTI_TYPE(DL1414)|MULTI_TYPE(DL1416B)|MULTI_TYPE(DL1814)| \
+                        MULTI_TYPE(DL2416)|MULTI_TYPE(DL3416))
 
 struct menu;
 
@@ -432,7 +234,7 @@ struct menu_item {
 };
 
 struct menu {
-  uint8_t idx_eeaddr;
+  uint8_t idx_setting; /* index into settings.menu_idx */
   uint8_t nitems;
   const struct menu_item * PROGMEM items;
 };
@@ -443,7 +245,7 @@ static const struct menu_item menu_items_dl1414[] PROGMEM = {
 };
 
 static const struct menu menu_dl1414 PROGMEM = {
-  .idx_eeaddr = 2,
+  .idx_setting = SETTINGS_MENU_DL1414,
   .nitems = COUNT_OF(menu_items_dl1414),
   .items = menu_items_dl1414
 };
@@ -454,7 +256,7 @@ static const struct menu_item menu_items_dl1416[] PROGMEM = {
 };
 
 static const struct menu menu_dl1416 PROGMEM = {
-  .idx_eeaddr = 3,
+  .idx_setting = SETTINGS_MENU_DL1416,
   .nitems = COUNT_OF(menu_items_dl1416),
   .items = menu_items_dl1416
 };
@@ -462,10 +264,11 @@ static const struct menu menu_dl1416 PROGMEM = {
 static const struct menu_item menu_items_dl2416[] PROGMEM = {
   { .text=msg_segmented, .disptype=DL2416, .ff=0xFF },
   { .text=msg_matrix, .disptype=DLX2416, .ff=0xFF },
+  { .text=msg_hdlx, .disptype=HDLX2416, .ff=0xFF },
 };
 
 static const struct menu menu_dl2416 PROGMEM = {
-  .idx_eeaddr = 4,
+  .idx_setting = SETTINGS_MENU_DL2416,
   .nitems = COUNT_OF(menu_items_dl2416),
   .items = menu_items_dl2416
 };
@@ -473,10 +276,11 @@ static const struct menu menu_dl2416 PROGMEM = {
 static const struct menu_item menu_items_dl3416[] PROGMEM = {
   { .text=msg_segmented, .disptype=DL3416, .ff=0xFF },
   { .text=msg_matrix, .disptype=DLX3416, .ff=0xFF },
+  { .text=msg_hdlx, .disptype=HDLX3416, .ff=0xFF },
 };
 
 static const struct menu menu_dl3416 PROGMEM = {
-  .idx_eeaddr = 5,
+  .idx_setting = SETTINGS_MENU_DL3416,
   .nitems = COUNT_OF(menu_items_dl3416),
   .items = menu_items_dl3416
 };
@@ -488,162 +292,43 @@ static const struct menu_item main_menu_items[] PROGMEM = {
   { .text=msg_dl2416, .submenu=&menu_dl2416 },
   { .text=msg_dl3416, .submenu=&menu_dl3416 },
   { .text=msg_dl3422, .disptype=DL3422, .ff=0xFF },
+  { .text=msg_term, .disptype=MENU_TERMINAL, .ff=0xFF },
+  { .text=msg_multi, .disptype=MENU_MULTI, .ff=0xFF },
 };
 
 static const struct menu main_menu PROGMEM = {
-  .idx_eeaddr = 1,
+  .idx_setting = SETTINGS_MENU_MAIN,
   .nitems = COUNT_OF(main_menu_items),
   .items = main_menu_items
 };
 
 
 
-static struct display_spec disp = {0};
+/* outcome of the current test run, logged when the suite completes */
+static struct result_entry result;
 
 static void waitMillis(uint16_t ms) {
   pin_toggle(LED);
-  do {
+  uint16_t start = schedMillis();
+  while ((uint16_t)(schedMillis() - start) <= ms) {
     /* Pause if button 2 is held down */
-    while (pin_is_low(nSW2)) {}
-    _delay_ms(1);
-  } while (ms--);
-}
-
-
-/* rev 1 board has A0 and A1 swapped on the DL3416/3422 footprint */
-static bool a0_a1_not_swapped;
-static uint8_t fixAddress(uint8_t addr) {
-  if (a0_a1_not_swapped) { return addr; }
-  bool a0 = addr & 1;
-  bool a1 = (addr & 2) >> 1;
-  addr &= 0b11111100;
-  return addr | a1 | (a0<<1);
-}
-
-
-static void writeByte(uint8_t addr, uint8_t data) {
-  /* set up address and data */
-  addr = fixAddress(addr);
-  port_out(ADDRESS, addr);
-  port_out(DATA, data);
-  /* being conservative with timing here */
-  delay_ns_max(300);
-  pin_low(nCE);
-  delay_ns_max(300);
-  pin_low(nWR);
-  delay_ns_max(300);
-  pin_high(nWR);
-  delay_ns_max(300);
-  pin_high(nCE);
-  delay_ns_max(300);
-}
-
-
-/* HDSP-2xxx and PD2816 only */
-static uint8_t readByte(uint8_t addr) {
-  /* set up address lines and tristate data lines */
-  addr = fixAddress(addr);
-  port_out(ADDRESS, addr);
-  port_inputs(DATA);
-  delay_ns_max(300);
-  pin_low(nCE);
-  delay_ns_max(300);
-  pin_low(nRD);
-  delay_ns_max(300);
-  uint8_t data = port_value(DATA);
-  pin_high(nRD);
-  delay_ns_max(300);
-  pin_high(nCE);
-  delay_ns_max(300);
-  port_outputs(DATA);
-  delay_ns_max(300);
-  return data;
-}
-
-
-/* HDSP-2xxx and PD2816 only */
-static void writeControlRegister(uint8_t data) {
-  /* A3 must be low to access control register for PD2816 */
-  /* ~FL and A4 must also be high to access character RAM on HDSP-2xxx */
-  writeByte(_BV(ADDR_FL)|_BV(ADDR_A4), data);
-}
-
-
-/* HDSP-2xxx and PD2816 only */
-static uint8_t readControlRegister(void) {
-  /* A3 must be low to access control register for PD2816 */
-  /* ~FL and A4 must also be high to access character RAM on HDSP-2xxx */
-  return readByte(_BV(ADDR_FL)|_BV(ADDR_A4));
-}
-
-
-static void displayChar(uint8_t pos, uint8_t c) {
-  pos &= 0b111;
-  if (!disp.quirks.left_to_right_digit_numbering) {
-    pos = disp.num_digits-1-pos;
-  }
-  /* A3 must be high to access character RAM for PD2816 */
-  /* ~FL, A4, and A3 must be high to access character RAM on HDSP-2xxx */
-  /* Others don't care */
-  writeByte(pos|_BV(ADDR_FL)|_BV(ADDR_A4)|_BV(ADDR_A3), c);
-}
-
-
-static void setCursorMask(uint8_t bitmask) {
-  if (disp.quirks.cursor_parallel_load) {
-    /* DL1416 sets cursor for all digits with one write */
-    writeByte(_BV(ADDR_FL)|_BV(ADDR_A4), bitmask);
-  } else {
-    /* Others require one write per digit */
-    for (uint8_t pos = 0; pos < disp.num_digits; pos++) {
-      writeByte(pos|_BV(ADDR_FL)|_BV(ADDR_A4), (bitmask & 1));
-      bitmask >>= 1;
+    if (pin_is_low(nSW2)) {
+      uint16_t paused = schedMillis();
+      while (pin_is_low(nSW2)) { schedPoll(); }
+      start += (uint16_t)(schedMillis() - paused);
     }
+    schedPoll();
   }
 }
 
 
-/* HDSP-2xxx only */
-static void setFlashMask(uint8_t bitmask) {
-  for (uint8_t pos = 0; pos < disp.num_digits; pos++) {
-    writeByte(pos|_BV(ADDR_A4)|_BV(ADDR_A3), (bitmask & 1));
-    bitmask >>= 1;
-  }
-}
-
-
-static inline void hardResetDisplay(void) {
-  /* datasheet specifies 15ms minimum */
-  pin_low(nCLR); _delay_ms(16); pin_high(nCLR);
-  _delay_us(120); /* datasheet specifies to wait 110us min. after rising edge */
-}
-
-
-static void softResetDisplay(void) {
-  if (disp.quirks.controlreg_pd2816) {
-    writeControlRegister(CR_CLEAR);
-    writeControlRegister(CR_PD2816_BRIGHTNESS_100|CR_PD2816_ATTRS_ON|CR_PD2816_CHAR_SOLID|CR_PD2816_UNDERLINE_SOLID);
-  } else if (disp.quirks.controlreg_hdsp2xxx) {
-    writeControlRegister(CR_CLEAR);
-    writeControlRegister(CR_HDSP_BRIGHTNESS_100);
-  }
-  if (disp.quirks.has_cursor) {
-    setCursorMask(0);
-  }
-  pin_high(nBL); /* unblank */
-}
-
-
-static void displayString_P(PGM_P str) {
-  for (uint8_t pos = 0; pos < disp.num_digits; pos++) {
-    displayChar(pos, pgm_read_byte(str+pos));
-  }
-}
-
-
-static void fillDisplay(uint8_t c, uint8_t ndigits) {
-  for (uint8_t pos = 0; pos < ndigits; pos++) {
-    displayChar(pos, c);
+/* Hard reset; EEPROM writes keep going during the ~CLR pulse (not the */
+/* console, whose commands use the display) */
+static void resyncDisplay(void) {
+  resetStart(RESET_HARD);
+  while (!resetPoll()) {
+    settingsPoll();
+    resultlogPoll();
   }
 }
 
@@ -682,21 +367,13 @@ static void scrollCharSet(uint16_t delay) {
 }
 
 
-static inline char hexdigit(uint8_t i) {
-  i &= 0xF; return '0' + i + ((i <= 9) ? 0 : 7);
-}
-
-
 static void showASCIIValues(uint16_t delay) {
   for (uint8_t c = disp.asciival_min; c <= disp.asciival_max; c++) {
-    char hex1 = hexdigit(c >> 4);
-    char hex2 = hexdigit(c & 0xF);
-    displayChar(0, hex1);
-    displayChar(1, hex2);
-    displayChar(2, ' ');
-    for (uint8_t pos = 3; pos < disp.num_digits; pos++) {
-      displayChar(pos, c);
-    }
+    struct fmt f;
+    fmtDisplay(&f, 0, 0);
+    fmtUint(&f, c, 2, FMT_HEX|FMT_ZERO);
+    fmtChar(&f, ' ');
+    while (f.pos < f.end) { fmtChar(&f, c); }
     waitMillis(delay);
   }
 }
@@ -717,6 +394,41 @@ static void testBlanking(uint16_t delay) {
 }
 
 
+/* ~BL held high (lit) for duty/DIM_STEPS of every DIM_PERIOD_US */
+static void waitDimmed(uint16_t ms, uint8_t duty) {
+  pin_toggle(LED);
+  uint16_t start = schedMillis();
+  while ((uint16_t)(schedMillis() - start) <= ms) {
+    uint16_t t = schedMicros();
+    pin_high(nBL);
+    while ((uint16_t)(schedMicros() - t) < duty*(DIM_PERIOD_US/DIM_STEPS)) {}
+    pin_low(nBL);
+    while ((uint16_t)(schedMicros() - t) < DIM_PERIOD_US) {}
+    schedPoll();
+  }
+  pin_high(nBL);
+}
+
+
+/* Extended HDLx only: dimming through ~BL, cursor blink through CUE */
+static void testDimming(uint16_t delay) {
+  if (!disp.quirks.has_dimming) { return; }
+  displayString_P(msg_abcdefgh);
+  /* brightest first */
+  for (uint8_t duty = DIM_STEPS; duty; duty >>= 1) {
+    waitDimmed(delay, duty);
+  }
+  /* blink the cursor in all digits */
+  setCursorMask(0xFF);
+  for (uint8_t i = 0; i < 6; i++) {
+    pin_toggle(CUE);
+    waitMillis(delay);
+  }
+  setCursorMask(0);
+  pin_low(CUE);
+}
+
+
 static void testCursor(uint16_t delay) {
   if (!disp.quirks.has_cursor) { return; }
   /* clear cursor from all positions */
@@ -748,7 +460,8 @@ static void testCursor(uint16_t delay) {
 /* HDSP-2xxx only */
 static void testFlash(uint16_t delay) {
   if (!disp.quirks.controlreg_hdsp2xxx) { return; }
-  //!!! TODO: hard-reset to synchronize flashing?
+  /* every step starts from the same blink phase */
+  blinkSync();
   /* clear flash from all positions */
   setFlashMask(0);
   /* flash on */
@@ -775,51 +488,49 @@ static void testFlash(uint16_t delay) {
 }
 
 
-/* HDSP-2xxx only */
-static void setUserDefinedChar_P(uint8_t idx, PGM_P pattern) {
-  /* set UDC address */
-  writeByte(_BV(ADDR_FL), idx);
-  for (uint8_t row = 0; row < 7; row++) {
-    writeByte(row|_BV(ADDR_FL)|_BV(ADDR_A3), pgm_read_byte(pattern));
-    pattern++;
-  }
-}
-
-
 /* HDSP-2xxx only */
 static void testUserDefinedChars(uint16_t delay)
 {
-  if (!disp.quirks.controlreg_hdsp2xxx) { return; }
+  if (!disp.quirks.has_udc) { return; }
   displayString_P(msg_udc_test);
   waitMillis(delay<<3);
   /* clear all user-defined characters */
   for (uint8_t i = 0; i < 16; i++) {
-    setUserDefinedChar_P(i, udc);
+    setUserDefinedChar_P(i, udc, 0);
   }
   displayString_P(msg_udc1);
   /* animate each UDC */
   for (uint8_t pos = 0; pos < disp.num_digits; pos++) {
-    for (uint8_t i = 0; i < sizeof(udc)-6; i++) {
-      setUserDefinedChar_P(pos, udc+i);
+    for (uint8_t i = 0; i < UDC_ROWS-6; i++) {
+      setUserDefinedChar_P(pos, udc, i);
       waitMillis(delay);
     }
   }
   displayString_P(msg_udc2);
   for (uint8_t pos = 0; pos < disp.num_digits; pos++) {
-    for (uint8_t i = 0; i < sizeof(udc2)-6; i++) {
-      setUserDefinedChar_P(8+pos, udc2+i);
+    for (uint8_t i = 0; i < UDC2_ROWS-6; i++) {
+      setUserDefinedChar_P(8+pos, udc2, i);
       waitMillis(delay);
     }
   }
 
-  const char *pattern = udc_hexdigits;
   for (uint8_t i = 0; i < 16; i++) {
-    setUserDefinedChar_P(i, pattern);
-    pattern += 7;
+    setUserDefinedChar_P(i, udc_hexdigits, i*7);
   }
 }
 
 
+/* Records the first failure of the part under test */
+static void recordFailure(enum result_test test, uint8_t addr, uint8_t bits) {
+  if (result.test != RESULT_PASS) { return; }
+  result.test = test;
+  result.fail_addr = addr;
+  result.fail_bits = bits;
+  settings.parts_failed++;
+  settingsSave();
+}
+
+
 static void testReadback(uint16_t delay)
 {
   if (!disp.quirks.has_read) { return; }
@@ -840,8 +551,11 @@ static void testReadback(uint16_t delay)
   for (uint8_t pos = 0; pos < disp.num_digits; pos++) {
     uint8_t readValue = readByte(pos|_BV(ADDR_FL)|_BV(ADDR_A4)|_BV(ADDR_A3));
     if (readValue != expectedReadValue) {
+      recordFailure(RESULT_READBACK_DATA, pos, readValue ^ expectedReadValue);
       displayString_P(msg_readfail);
-      displayChar(2, '0'+pos);
+      struct fmt f;
+      fmtDisplay(&f, 2, 1);
+      fmtUint(&f, pos, 0, 0);
       waitMillis(5000); /* long pause, then bail out of test */
       return;
     }
@@ -856,6 +570,7 @@ static void testReadback(uint16_t delay)
   softResetDisplay();
 
   if (readValue != expectedReadValue) {
+    recordFailure(RESULT_READBACK_CONTROL, 0, readValue ^ expectedReadValue);
     displayString_P(msg_readfail);
     displayChar(2, 'C');
     waitMillis(5000); /* long pause, then bail out of test */
@@ -881,20 +596,20 @@ static void testControlRegisterPD2816(uint16_t delay)
   writeControlRegister(CR_PD2816_BRIGHTNESS_100);
   waitMillis(delay);
   /* test highlight styles */
-  /* hard-resets merely reset the multiplex/blink phase */
-  hardResetDisplay();
+  /* each style starts from the same blink phase */
+  blinkSync();
   displayString_P(msg_underline);
   writeControlRegister(CR_PD2816_BRIGHTNESS_100|CR_PD2816_ATTRS_ON|CR_PD2816_CHAR_SOLID|CR_PD2816_UNDERLINE_SOLID);
   waitMillis(delay<<2);
-  hardResetDisplay();
+  blinkSync();
   displayString_P(msg_charblink_underline);
   writeControlRegister(CR_PD2816_BRIGHTNESS_100|CR_PD2816_ATTRS_ON|CR_PD2816_CHAR_BLINK|CR_PD2816_UNDERLINE_SOLID);
   waitMillis(delay<<2);
-  hardResetDisplay();
+  blinkSync();
   displayString_P(msg_underline_blink);
   writeControlRegister(CR_PD2816_BRIGHTNESS_100|CR_PD2816_ATTRS_ON|CR_PD2816_CHAR_SOLID|CR_PD2816_UNDERLINE_BLINK);
   waitMillis(delay<<2);
-  hardResetDisplay();
+  blinkSync();
   displayString_P(msg_char_and_underline_blink);
   writeControlRegister(CR_PD2816_BRIGHTNESS_100|CR_PD2816_ATTRS_ON|CR_PD2816_CHAR_BLINK|CR_PD2816_UNDERLINE_BLINK);
   waitMillis(delay<<2);
@@ -902,7 +617,7 @@ static void testControlRegisterPD2816(uint16_t delay)
   writeControlRegister(CR_PD2816_BRIGHTNESS_100);
   waitMillis(delay<<2);
   /* test full display blink */
-  hardResetDisplay();
+  blinkSync();
   displayString_P(msg_blink_all);
   writeControlRegister(CR_PD2816_BLINK_DISPLAY|CR_PD2816_BRIGHTNESS_100);
   waitMillis(delay<<3);
@@ -926,7 +641,6 @@ static void testControlRegisterPD2816(uint16_t delay)
 
 static void testControlRegisterHDSP2xxx(uint16_t delay)
 {
-  //!!! TODO: hard-reset to synchronize flashing?
   /* test brightness levels */
   displayString_P(msg_brightness_13);
   writeControlRegister(CR_HDSP_BRIGHTNESS_13);
@@ -949,8 +663,9 @@ static void testControlRegisterHDSP2xxx(uint16_t delay)
   displayString_P(msg_brightness_100);
   writeControlRegister(CR_HDSP_BRIGHTNESS_100);
   waitMillis(delay);
-  /* test full display blink */
+  /* test full display blink, from a known phase */
   displayString_P(msg_blink_all);
+  blinkSync();
   writeControlRegister(CR_HDSP_BLINK_DISPLAY|CR_HDSP_BRIGHTNESS_100);
   waitMillis(delay<<2);
   /* invoke the self test */
@@ -959,15 +674,22 @@ static void testControlRegisterHDSP2xxx(uint16_t delay)
   waitMillis(delay<<1);
   writeControlRegister(CR_HDSP_SELF_TEST_START);
   /* wait for test to finish--blink LED so we know things haven't crashed */
-  for (uint8_t i = 0; i < HDSP_SELF_TEST_DURATION_MS/INTER_CHAR_DELAY_MS; i++) {
-    waitMillis(INTER_CHAR_DELAY_MS);
-  }
+  /* the start bit is cleared when the test completes */
+  uint32_t start = schedMillis();
+  uint8_t cr;
+  do {
+    waitMillis(RESULT_SELFTEST_TIME_MS);
+    cr = readControlRegister();
+  } while ((cr & CR_HDSP_SELF_TEST_START) &&
+           schedMillis() - start < HDSP_SELF_TEST_DURATION_MS);
+  uint32_t duration = (schedMillis() - start)/RESULT_SELFTEST_TIME_MS;
+  result.selftest_time = (duration > 0xFF) ? 0xFF : duration;
   /* check result */
-  uint8_t result = readControlRegister();
-  if (result & CR_HDSP_SELF_TEST_RESULT) {
+  if (cr & CR_HDSP_SELF_TEST_RESULT) {
     displayString_P(msg_selftest_pass);
     waitMillis(delay<<2);
   } else {
+    recordFailure(RESULT_SELFTEST, 0, cr);
     displayString_P(msg_selftest_fail);
     waitMillis(5000); /* long pause if selftest fails */
   }
@@ -987,12 +709,6 @@ static void testControlRegister(uint16_t delay)
 }
 
 
-static void setDisplayType(enum display_type type) {
-  memcpy_P(&disp, DISPLAYS+type, sizeof(disp));
-  softResetDisplay();
-}
-
-
 /* Waits until a button is pressed and released, returning true if SW2 was */
 /* pressed, and false if SW1 was pressed. */
 /* (Does not detect both buttons pressed simultaneously.) */
@@ -1001,6 +717,7 @@ static bool waitForButtonPress(void) {
   uint8_t ret;
   do {
     buttons = pin_is_low(nSW1) | (pin_is_low(nSW2)<<1);
+    schedPoll();
     _delay_ms(50); /* long delay to for debouncing */
   } while (buttons == 0);
   /* return value is true if SW2 was pressed, false otherwise */
@@ -1008,14 +725,65 @@ static bool waitForButtonPress(void) {
   /* wait for release */
   do {
     buttons = pin_is_low(nSW1) | (pin_is_low(nSW2)<<1);
+    schedPoll();
     _delay_ms(50);
   } while (buttons != 0);
   return ret;
 }
 
 
-static inline void waitForButton2Press(void) {
-  while (waitForButtonPress() == 0) {}
+/* HDSP2xxx or PD2816 if one is inserted (it outputs a clock), otherwise */
+/* NUM_DISPLAY_TYPES */
+static enum display_type detectPart(void) {
+  uint8_t count = 0; /* poll 256 times, once per microsecond */
+  while (--count) {
+    /* It should not be physically possible to have a PD2816 and HDSP2xxx */
+    /* inserted at the same time */
+    if (pin_is_low(HDSPCLK)) { return HDSP2xxx; }
+    if (pin_is_low(PD2816CLK)) { return PD2816; }
+    _delay_us(1);
+  }
+  return NUM_DISPLAY_TYPES;
+}
+
+
+/* Shows a message on every part, in as many turns as it takes */
+static void multiShow_P(PGM_P str, uint16_t parts, uint16_t delay) {
+  do {
+    parts = multiString_P(str, parts);
+    waitMillis(delay);
+  } while (parts);
+}
+
+
+static void multiFillGradual(uint8_t c, uint16_t parts, uint16_t delay) {
+  for (uint8_t pos = 0; pos < 8; pos++) {
+    if (multiChar(pos, c, parts)) { waitMillis(delay); }
+  }
+}
+
+
+/* Steps 1-5 on every socket at once; does not return */
+static void testMultiSocket(void) {
+  /* pressing SW1 reboots the tester */
+  pin_ctrl(nSW1) |= PORT_ISC0_bm|PORT_ISC1_bm;
+  consoleTestRunning(true);
+  uint16_t parts = MULTI_SOCKETS;
+  enum display_type found = detectPart();
+  resyncDisplay();
+  if (found != NUM_DISPLAY_TYPES) {
+    /* its control register defaults */
+    setDisplayType(found);
+    parts |= MULTI_TYPE(found);
+  }
+  multiShow_P(msg_abcdefgh, parts, INTER_CHAR_DELAY_MS);
+  multiFillGradual('U', parts, INTER_CHAR_DELAY_MS);
+  multiFillGradual('*', parts, INTER_CHAR_DELAY_MS);
+  multiFillGradual('O', parts, INTER_CHAR_DELAY_MS);
+  multiFillGradual('.', parts, INTER_CHAR_DELAY_MS);
+  consoleTestRunning(false);
+  multiShow_P(msg_done, parts, LONG_DELAY_MS);
+  while (1) { waitMillis(LONG_DELAY_MS); }
 }
 
 
@@ -1025,7 +793,7 @@ static void menu(void)
 
   struct menu current_menu;
   memcpy_P(&current_menu, &main_menu, sizeof(struct menu));
-  uint8_t idx = eeprom_read_byte((void*)((int)current_menu.idx_eeaddr));
+  uint8_t idx = settings.menu_idx[current_menu.idx_setting];
   if (idx >= current_menu.nitems) { idx = 0; }
 
   struct menu_item item;
@@ -1039,16 +807,21 @@ static void menu(void)
     }
     /* button 2: activate current menu item */
     else {
-      /* save current index to eeprom */
-      eeprom_update_byte((void*)((int)current_menu.idx_eeaddr), idx);
+      /* save current index */
+      if (settings.menu_idx[current_menu.idx_setting] != idx) {
+        settings.menu_idx[current_menu.idx_setting] = idx;
+        settingsSave();
+      }
       if (item.ff == 0xFF) {
+        if (item.disptype == MENU_TERMINAL) { termRun(); }
+        if (item.disptype == MENU_MULTI) { testMultiSocket(); }
         /* set display type and return */
         setDisplayType(item.disptype);
         return;
       } else {
         /* enter submenu */
         memcpy_P(&current_menu, item.submenu, sizeof(struct menu));
-        idx = eeprom_read_byte((void*)((int)current_menu.idx_eeaddr));
+        idx = settings.menu_idx[current_menu.idx_setting];
         if (idx >= current_menu.nitems) { idx = 0; }
       }
     }
@@ -1060,6 +833,10 @@ ISR(port_isr(nSW1)) {
   /* wait for button release */
   do { _delay_ms(50); } while (pin_is_low(nSW1));
   _delay_ms(100);
+  /* don't lose a pending settings write or log entry; this waits on the */
+  /* EEPROM in the ISR, but nothing else runs again before the reset */
+  settingsFlush();
+  resultlogFlush();
   /* software reset */
   CCP = 0xD8; /* unlock RSTCTRL registers */
   RSTCTRL.SWRR = RSTCTRL_SWRE_bm;
@@ -1073,8 +850,7 @@ int main(void)
   CCP = 0xD8; /* unlock CLKCTRL registers */
   CLKCTRL_MCLKCTRLB = 0;
 
-  /* initialize pins */
-  pin_output_low(nCLR); /* hold in reset */
+  /* initialize pins (~CLR in bootInstantOn()) */
   pin_output_high(nWR);
   pin_output_high(nCE);
   pin_output_high(nRD);
@@ -1087,39 +863,47 @@ int main(void)
   pin_input_pullup(nSW2);
   pin_input_pullup(HDSPCLK);
   pin_input_pullup(PD2816CLK);
-  hardResetDisplay();
+  schedInit();
+  uartInit();
+  profInit();
+  sei();
+  settingsLoad();
 
   /* if SW2 is held down on powerup, toggle the swap-A1/A0 bit */
-  /* for rev1 boards that have A0/A1 swapped on the DL3416/3422 footprint */
-  _delay_ms(50);
-  a0_a1_not_swapped = !!(eeprom_read_byte((void*)7) & 1);
+  /* for rev1 boards that have A0/A1 swapped on the DL3416/3422 footprint; */
+  /* the pullup has settled by now, so only a press is debounced */
   if (pin_is_low(nSW2)) {
-    a0_a1_not_swapped = !a0_a1_not_swapped;
-    eeprom_update_byte((void*)7, a0_a1_not_swapped);
-    eeprom_busy_wait();
-    while (pin_is_low(nSW2)) {}
     _delay_ms(50);
+    if (pin_is_low(nSW2)) {
+      settings.flags ^= SETTINGS_A0_A1_NOT_SWAPPED;
+      settingsSave();
+      while (pin_is_low(nSW2)) { schedPoll(); }
+      _delay_ms(50);
+    }
   }
+  a0_a1_not_swapped = !!(settings.flags & SETTINGS_A0_A1_NOT_SWAPPED);
+
+  /* a board on a ring shows its last frame at once (see boot.h); */
+  /* otherwise load the rest while the display is held in reset */
+  bool instant = bootInstantOn();
+  if (!instant) { resetStart(RESET_HARD); }
+  resultlogInit();
+  netInit();
+  while (!resetPoll()) {}
 
   /* if an HDSP/PDSP/PD2816 is present, we'll see a clock signal */
-  uint8_t count = 0; /* poll 256 times, once per microsecond */
-  while (--count) {
-    /* It should not be physically possible to have a PD2816 and HDSP2xxx */
-    /* inserted at the same time */
-    if (pin_is_low(HDSPCLK)) {
-      setDisplayType(HDSP2xxx);
-      displayString_P(msg_hdsp2xxx);
-      waitForButton2Press();
-      goto run;
-    } else if (pin_is_low(PD2816CLK)) {
-      setDisplayType(PD2816);
-      displayString_P(msg_pd2816);
-      waitForButton2Press();
-      goto run;
-    }
-    _delay_us(1);
+  enum display_type found = detectPart();
+  if (instant && bootConfirm(found)) {
+    /* keep showing it until a button is pressed */
+    waitForButtonPress();
+  }
+  if (found != NUM_DISPLAY_TYPES) {
+    setDisplayType(found);
+    displayString_P(found == HDSP2xxx ? msg_hdsp2xxx : msg_pd2816);
+    /* SW2 tests it, SW1 goes to the menu (e.g. to test every socket) */
+    if (waitForButtonPress()) { goto run; }
   }
-  /* if neither display type detected, show the menu */
+  /* otherwise show the menu */
   setDisplayType(DL1414);
   menu();
 
@@ -1127,7 +911,15 @@ run:
 
   /* pressing SW1 reboots the tester */
   pin_ctrl(nSW1) |= PORT_ISC0_bm|PORT_ISC1_bm;
-  sei();
+
+  /* update production counters */
+  result.display_type = disp_type;
+  /* a frame saved from the ring belongs to the type it replaces here */
+  settings.display_type = disp_type;
+  settings.flags &= ~SETTINGS_LAST_FRAME;
+  settings.parts_tested++;
+  settingsSave();
+  consoleTestRunning(true);
 
   displayString_P(msg_abcdefgh);
   waitMillis(INTER_CHAR_DELAY_MS);
@@ -1143,12 +935,24 @@ run:
   testCursor(INTER_CHAR_DELAY_MS);
   testFlash(LONG_DELAY_MS);
   testBlanking(INTER_CHAR_DELAY_MS);
+  testDimming(INTER_CHAR_DELAY_MS);
   testUserDefinedChars(50);
   testControlRegister(INTER_CHAR_DELAY_MS);
   /* show each character and its ASCII code */
   showASCIIValues(INTER_CHAR_DELAY_MS);
+  /* log the result */
+  uint32_t uptime = schedMillis() >> 10;
+  result.timestamp = (uptime < RESULT_TIMESTAMP_MAX) ? uptime : RESULT_TIMESTAMP_MAX;
+  resultlogAppend(&result);
+  consoleTestRunning(false);
   /* scroll character set (loops until SW1 is pressed) */
   displayString_P(msg_done);
+  struct fmt f;
+  fmtDisplay(&f, 4, 4);
+  /* four digits fit; tools/tester.py log has the full count */
+  uint16_t shown = settings.parts_tested;
+  if (shown > PARTS_SHOWN_MAX) { shown = PARTS_SHOWN_MAX; }
+  fmtUint(&f, shown, 4, 0);
   waitMillis(LONG_DELAY_MS);
   scrollCharSet(INTER_CHAR_DELAY_MS);
   __builtin_unreachable();
@@ -0,0 +1,193 @@
+#include "marquee.h"
+#include "charset.h"
+#include "display.h"
+#include "font.h"
+#include "sched.h"
+#include "uart.h"
+
+#include <string.h>
+
+enum marquee_source {
+  MARQUEE_PGM,
+  MARQUEE_RAM,
+  MARQUEE_SERIAL,
+};
+
+/* What a digit is showing: character a, or the columns of a and b */
+/* starting "shift" pixels into a */
+struct digit_state {
+  uint8_t a, b;
+  uint8_t shift;
+};
+
+static struct {
+  enum marquee_source source;
+  enum marquee_mode mode;
+  const char *text;
+  int16_t len;
+  int16_t pos;              /* pixel column shown in the leftmost digit */
+  int16_t pos_min, pos_max;
+  int8_t dir;
+  bool smooth;              /* pixel scrolling with UDCs */
+  bool stopped;             /* serial: ESC received */
+  struct utf8 utf8;         /* serial: decoder state */
+  uint16_t last_frame;
+  /* serial: the (Latin-1) characters on the display, from the leftmost digit */
+  uint8_t stream[MARQUEE_MAX_DIGITS+1];
+  struct digit_state shown[MARQUEE_MAX_DIGITS];
+} mq;
+
+
+static int16_t floorDiv(int16_t x, int16_t d) {
+  int16_t q = x / d;
+  return (x % d < 0) ? q-1 : q;
+}
+
+
+static uint8_t charAt(int16_t i) {
+  if (mq.source == MARQUEE_SERIAL) {
+    return (i >= 0 && i < (int16_t)sizeof(mq.stream)) ? mq.stream[i] : ' ';
+  }
+  if (i < 0 || i >= mq.len) { return ' '; }
+  if (mq.source == MARQUEE_PGM) { return pgm_read_byte(mq.text + i); }
+  return mq.text[i];
+}
+
+
+static void start(void) {
+  int16_t width = disp.num_digits * MARQUEE_PITCH;
+  int16_t text_width = mq.len * MARQUEE_PITCH;
+  mq.smooth = disp.quirks.has_udc;
+  mq.dir = 1;
+  mq.stopped = false;
+  charsetLoadGlyphs();
+  if (mq.mode == MARQUEE_BOUNCE) {
+    /* end positions put the first or last character at a display edge */
+    mq.pos_min = (text_width > width) ? 0 : text_width - width;
+    mq.pos_max = (text_width > width) ? text_width - width : 0;
+  } else {
+    /* enter from one edge, leave by the other */
+    mq.pos_min = -width;
+    mq.pos_max = text_width;
+  }
+  if (mq.mode == MARQUEE_RIGHT) {
+    mq.dir = -1;
+    mq.pos = mq.pos_max;
+  } else {
+    mq.pos = mq.pos_min;
+  }
+  /* nothing is known to be on the display */
+  memset(mq.shown, 0xFF, sizeof(mq.shown));
+  mq.last_frame = schedMillis() - MARQUEE_FRAME_MS;
+}
+
+
+void marqueeStart_P(PGM_P text, enum marquee_mode mode) {
+  mq.source = MARQUEE_PGM;
+  mq.text = text;
+  mq.len = strlen_P(text);
+  mq.mode = mode;
+  start();
+}
+
+
+void marqueeStart(const char *text, enum marquee_mode mode) {
+  mq.source = MARQUEE_RAM;
+  mq.text = text;
+  mq.len = strlen(text);
+  mq.mode = mode;
+  start();
+}
+
+
+void marqueeStartSerial(void) {
+  mq.source = MARQUEE_SERIAL;
+  mq.len = 0;
+  mq.mode = MARQUEE_LEFT;
+  start();
+  mq.pos = 0;
+  mq.utf8.need = 0;
+  memset(mq.stream, ' ', sizeof(mq.stream));
+}
+
+
+/* Serial text scrolls forever: shift in a character whenever the leftmost */
+/* digit has moved on to the next one */
+static void advanceStream(void) {
+  while (mq.pos >= MARQUEE_PITCH) {
+    memmove(mq.stream, mq.stream+1, sizeof(mq.stream)-1);
+    uint8_t c = ' ';
+    int16_t b;
+    /* bytes after ESC are the host's next command: leave them unread */
+    while (!mq.stopped && (b = uartGetc()) >= 0) {
+      if (b == MARQUEE_STOP) {
+        mq.stopped = true;
+        break;
+      }
+      if (utf8Decode(&mq.utf8, b, &c)) { break; }
+    }
+    mq.stream[sizeof(mq.stream)-1] = c;
+    mq.pos -= MARQUEE_PITCH;
+  }
+}
+
+
+static void drawDigit(uint8_t digit, int16_t x) {
+  int16_t i = floorDiv(x, MARQUEE_PITCH);
+  struct digit_state now = { charsetMap(charAt(i)), ' ', x - i*MARQUEE_PITCH };
+  if (!mq.smooth || now.shift == 0) {
+    now.shift = 0;
+  } else {
+    now.b = charsetMap(charAt(i+1));
+    /* blank whatever the shift */
+    if (now.a == ' ' && now.b == ' ') { now.shift = 0; }
+  }
+  struct digit_state *was = &mq.shown[digit];
+  if (now.a == was->a && now.b == was->b && now.shift == was->shift) { return; }
+  *was = now;
+  if (now.shift == 0) {
+    displayChar(digit, now.a);
+    return;
+  }
+  /* both characters side by side, each followed by the gap column */
+  uint8_t a[FONT_ROWS], b[FONT_ROWS];
+  fontGlyph(now.a, a);
+  fontGlyph(now.b, b);
+  for (uint8_t row = 0; row < FONT_ROWS; row++) {
+    uint16_t pair = ((uint16_t)a[row] << (MARQUEE_PITCH+1)) | (b[row] << 1);
+    a[row] = (pair >> (MARQUEE_PITCH+1-now.shift)) & 0b00011111;
+  }
+  setUserDefinedChar(digit, a);
+  displayChar(digit, CHAR_ATTR|digit);
+}
+
+
+bool marqueePoll(void) {
+  if (mq.stopped) { return false; }
+  uint16_t now = schedMillis();
+  if ((uint16_t)(now - mq.last_frame) < MARQUEE_FRAME_MS) { return true; }
+  mq.last_frame += MARQUEE_FRAME_MS;
+  /* don't try to catch up after a long stall */
+  if ((uint16_t)(now - mq.last_frame) >= MARQUEE_FRAME_MS) { mq.last_frame = now; }
+
+  if (mq.source == MARQUEE_SERIAL) { advanceStream(); }
+  for (uint8_t digit = 0; digit < disp.num_digits; digit++) {
+    drawDigit(digit, mq.pos + digit*MARQUEE_PITCH);
+  }
+
+  /* next position */
+  if (mq.source == MARQUEE_SERIAL) {
+    mq.pos++;
+  } else if (mq.mode == MARQUEE_BOUNCE) {
+    if (mq.pos_min == mq.pos_max) { return true; }
+    if ((mq.dir > 0 && mq.pos >= mq.pos_max) || (mq.dir < 0 && mq.pos <= mq.pos_min)) {
+      mq.dir = -mq.dir;
+    }
+    mq.pos += mq.dir;
+  } else {
+    mq.pos += mq.dir;
+    if (mq.pos > mq.pos_max) { mq.pos = mq.pos_min; }
+    if (mq.pos < mq.pos_min) { mq.pos = mq.pos_max; }
+  }
+  return true;
+}
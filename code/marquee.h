@@ -0,0 +1,47 @@
+/**
+ * Marquee: scrolls text of any length across the display.
+ *
+ * Text is Latin-1 from flash or RAM, or UTF-8 from the serial port, and is
+ * shown with the part's character set (see charset.h).
+ *
+ * The text can come from flash, RAM, or the serial port (left scrolling
+ * only; characters are pulled in as they are needed, and blanks are shown
+ * while none are waiting, so the sender should pace itself to about
+ * 1000/(MARQUEE_FRAME_MS*MARQUEE_PITCH) characters per second). Text scrolls left, right, or bounces between
+ * its ends when there is more text than digits (or between the edges of
+ * the display when there is less).
+ *
+ * Frames are timed from the scheduler tick, MARQUEE_FRAME_MS apart, and
+ * each frame moves the text one pixel column. Displays with user-defined
+ * characters (has_udc) scroll smoothly: a digit straddling two characters
+ * shows a UDC cut from the 5x7 font (see font.h), one UDC per digit. Other
+ * displays move a whole character every MARQUEE_PITCH frames, at the same
+ * speed. Either way, only digits whose contents changed are written.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <avr/pgmspace.h>
+
+#define MARQUEE_FRAME_MS  40
+/* pixel columns per character: 5 plus the gap between digits */
+#define MARQUEE_PITCH     6
+#define MARQUEE_MAX_DIGITS 8
+/* ends a serial marquee */
+#define MARQUEE_STOP      0x1B
+
+enum marquee_mode {
+  MARQUEE_LEFT,
+  MARQUEE_RIGHT,
+  MARQUEE_BOUNCE,
+};
+
+/* Text in flash or RAM, NUL-terminated */
+void marqueeStart_P(PGM_P text, enum marquee_mode mode);
+void marqueeStart(const char *text, enum marquee_mode mode);
+/* Text read from the serial port as it scrolls in */
+void marqueeStartSerial(void);
+/* Draws the next frame if it is due; false once a serial marquee has */
+/* received MARQUEE_STOP */
+bool marqueePoll(void);
@@ -0,0 +1,244 @@
+/* Generated by tools/packmsg.py from messages.def -- do not edit. */
+/*
+ * Flash usage in bytes (raw = unpacked 8-bit PROGMEM equivalent):
+ *   kind     count      raw   packed
+ *   text        42      326      280
+ *   glyphs       1      112       71
+ *   strip        2       46       32
+ *   total               484      383
+ */
+#pragma once
+
+/* PD2816   */
+static const char msg_pd2816[] PROGMEM = {
+  0x08, 0x30, 0x29, 0x61, 0x91, 0x05, 0x00,
+};
+
+/* HDSP2xxx */
+static const char msg_hdsp2xxx[] PROGMEM = {
+  0x08, 0x28, 0x39, 0xC3, 0xD2, 0x9F, 0xFD, 0xD9, 0x9F, 0x01,
+};
+
+/* 1414 */
+static const char msg_dl1414[] PROGMEM = {
+  0x04, 0x11, 0x15, 0x51,
+};
+
+/* 1416 */
+static const char msg_dl1416[] PROGMEM = {
+  0x04, 0x11, 0x15, 0x59,
+};
+
+/* '16T */
+static const char msg_dl1416t[] PROGMEM = {
+  0x04, 0x47, 0x64, 0xD1,
+};
+
+/* '16B */
+static const char msg_dl1416b[] PROGMEM = {
+  0x04, 0x47, 0x64, 0x89,
+};
+
+/* 1814 */
+static const char msg_dl1814[] PROGMEM = {
+  0x04, 0x11, 0x16, 0x51,
+};
+
+/* 2416 */
+static const char msg_dl2416[] PROGMEM = {
+  0x04, 0x12, 0x15, 0x59,
+};
+
+/* 3416 */
+static const char msg_dl3416[] PROGMEM = {
+  0x04, 0x13, 0x15, 0x59,
+};
+
+/* 3422 */
+static const char msg_dl3422[] PROGMEM = {
+  0x04, 0x13, 0x25, 0x49,
+};
+
+/* SEGM */
+static const char msg_segmented[] PROGMEM = {
+  0x04, 0x73, 0x79, 0xB6,
+};
+
+/* MTRX */
+static const char msg_matrix[] PROGMEM = {
+  0x04, 0x2D, 0x2D, 0xE3,
+};
+
+/* HDLX */
+static const char msg_hdlx[] PROGMEM = {
+  0x04, 0x28, 0xC9, 0xE2,
+};
+
+/* TERM */
+static const char msg_term[] PROGMEM = {
+  0x04, 0x74, 0x29, 0xB7,
+};
+
+/* MULT */
+static const char msg_multi[] PROGMEM = {
+  0x04, 0x6D, 0xCD, 0xD2,
+};
+
+/* ABCDEFGH */
+static const char msg_abcdefgh[] PROGMEM = {
+  0x08, 0xA1, 0x38, 0x92, 0xA5, 0x79, 0xA2,
+};
+
+/* READTEST */
+static const char msg_readtest[] PROGMEM = {
+  0x08, 0x72, 0x19, 0x92, 0x74, 0x39, 0xD3,
+};
+
+/* RD  FAIL */
+static const char msg_readfail[] PROGMEM = {
+  0x08, 0x32, 0x09, 0x00, 0x66, 0x98, 0xB2,
+};
+
+/* READ OK  */
+static const char msg_readok[] PROGMEM = {
+  0x08, 0x72, 0x19, 0x92, 0xC0, 0xBB, 0x02,
+};
+
+/* DONE     */
+static const char msg_done[] PROGMEM = {
+  0x08, 0xE4, 0xEB, 0x96, 0x00, 0x00, 0x00,
+};
+
+/*  13% BRI */
+static const char msg_brightness_13[] PROGMEM = {
+  0x08, 0x40, 0x34, 0x15, 0x80, 0x28, 0xA7,
+};
+
+/*  20% BRI */
+static const char msg_brightness_20[] PROGMEM = {
+  0x08, 0x80, 0x04, 0x15, 0x80, 0x28, 0xA7,
+};
+
+/*  25% BRI */
+static const char msg_brightness_25[] PROGMEM = {
+  0x08, 0x80, 0x54, 0x15, 0x80, 0x28, 0xA7,
+};
+
+/*  27% BRI */
+static const char msg_brightness_27[] PROGMEM = {
+  0x08, 0x80, 0x74, 0x15, 0x80, 0x28, 0xA7,
+};
+
+/*  40% BRI */
+static const char msg_brightness_40[] PROGMEM = {
+  0x08, 0x00, 0x05, 0x15, 0x80, 0x28, 0xA7,
+};
+
+/*  50% BRI */
+static const char msg_brightness_50[] PROGMEM = {
+  0x08, 0x40, 0x05, 0x15, 0x80, 0x28, 0xA7,
+};
+
+/*  53% BRI */
+static const char msg_brightness_53[] PROGMEM = {
+  0x08, 0x40, 0x35, 0x15, 0x80, 0x28, 0xA7,
+};
+
+/*  80% BRI */
+static const char msg_brightness_80[] PROGMEM = {
+  0x08, 0x00, 0x06, 0x15, 0x80, 0x28, 0xA7,
+};
+
+/* 100% BRI */
+static const char msg_brightness_100[] PROGMEM = {
+  0x08, 0x11, 0x04, 0x15, 0x80, 0x28, 0xA7,
+};
+
+/* UNDERLIN */
+static const char msg_underline[] PROGMEM = {
+  0x88, 0x01, 0x08, 0xB5, 0x4B, 0x96, 0x32, 0x9B, 0xBA,
+};
+
+/* CBLINK+U */
+static const char msg_charblink_underline[] PROGMEM = {
+  0x88, 0x01, 0x08, 0xA3, 0xC8, 0xA6, 0xEE, 0xBA, 0xD4,
+};
+
+/* UL.BLINK */
+static const char msg_underline_blink[] PROGMEM = {
+  0x88, 0x01, 0x08, 0x35, 0xEB, 0x88, 0x6C, 0xEA, 0xAE,
+};
+
+/* BLINK+UL */
+static const char msg_char_and_underline_blink[] PROGMEM = {
+  0x88, 0x01, 0x08, 0x22, 0x9B, 0xBA, 0xEB, 0x52, 0xB3,
+};
+
+/* (NORMAL) */
+static const char msg_attributes_off[] PROGMEM = {
+  0x88, 0x01, 0x08, 0x88, 0xFB, 0xCA, 0x6D, 0xC8, 0x26,
+};
+
+/* BLINKALL */
+static const char msg_blink_all[] PROGMEM = {
+  0x08, 0x22, 0x9B, 0xBA, 0x6B, 0xC8, 0xB2,
+};
+
+/* LAMPTEST */
+static const char msg_lamp_test[] PROGMEM = {
+  0x08, 0x6C, 0xD8, 0xC2, 0x74, 0x39, 0xD3,
+};
+
+/* SELFTEST */
+static const char msg_selftest[] PROGMEM = {
+  0x08, 0x73, 0xC9, 0x9A, 0x74, 0x39, 0xD3,
+};
+
+/* S.T.PASS */
+static const char msg_selftest_pass[] PROGMEM = {
+  0x08, 0xB3, 0x43, 0x3B, 0x70, 0x38, 0xCF,
+};
+
+/* S.T.FAIL */
+static const char msg_selftest_fail[] PROGMEM = {
+  0x08, 0xB3, 0x43, 0x3B, 0x66, 0x98, 0xB2,
+};
+
+/* UDC TEST */
+static const char msg_udc_test[] PROGMEM = {
+  0x08, 0x35, 0x39, 0x02, 0x74, 0x39, 0xD3,
+};
+
+/* \x80\x81\x82\x83\x84\x85\x86\x87 */
+static const char msg_udc1[] PROGMEM = {
+  0x08, 0x7F, 0xF8, 0x8B, 0xFF, 0xF8, 0x93, 0x7F, 0xF9, 0x9B, 0xFF, 0xF9,
+  0xA3,
+};
+
+/* \x88\x89\x8a\x8b\x8c\x8d\x8e\x8f */
+static const char msg_udc2[] PROGMEM = {
+  0x08, 0x7F, 0xFA, 0xAB, 0xFF, 0xFA, 0xB3, 0x7F, 0xFB, 0xBB, 0xFF, 0xFB,
+  0xC3,
+};
+
+#define UDC_ROWS 23
+static const char udc[] PROGMEM = {
+  0x00, 0x00, 0x00, 0x00, 0x80, 0x98, 0xFB, 0xFF, 0xCE, 0x08, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00,
+};
+
+#define UDC2_ROWS 23
+static const char udc2[] PROGMEM = {
+  0x00, 0x00, 0x00, 0x00, 0x08, 0xE3, 0xBC, 0xEF, 0x39, 0x86, 0x00, 0x00,
+  0x00, 0x00, 0x00, 0x00,
+};
+
+#define UDC_HEXDIGITS_ROWS 112
+static const char udc_hexdigits[] PROGMEM = {
+  0x3F, 0xD6, 0x5A, 0xE3, 0xFF, 0x7B, 0xEE, 0x1D, 0xFF, 0x8F, 0x3D, 0xDE,
+  0xF8, 0x7F, 0xEC, 0xB9, 0xC7, 0xFF, 0x6B, 0x8D, 0xBD, 0xFF, 0x1F, 0x6F,
+  0xEC, 0xF1, 0xFF, 0x78, 0x63, 0x8D, 0xFF, 0xC7, 0x5A, 0x7B, 0xFF, 0x3F,
+  0xD6, 0x58, 0xE3, 0xFF, 0xB1, 0xC6, 0x1E, 0xFF, 0x8F, 0x35, 0xD6, 0xFA,
+  0x7F, 0xAC, 0xB3, 0xC6, 0xFF, 0xE3, 0xBD, 0x37, 0xFE, 0x3F, 0x6B, 0xAD,
+  0xF3, 0xFF, 0x78, 0xE7, 0x8D, 0xFF, 0xC7, 0x3B, 0xEF, 0xFD, 0x00,
+};
@@ -0,0 +1,124 @@
+#include "multi.h"
+
+#include <string.h>
+#include <avr/io.h>
+
+#define MULTI_DIGITS      8
+/* enough for every position of two conflicting streams */
+#define MULTI_MAX_WRITES  (2*MULTI_DIGITS)
+#define CHAR_ADDRESS      (_BV(ADDR_FL)|_BV(ADDR_A4)|_BV(ADDR_A3))
+
+struct multi_write {
+  uint8_t addr;  /* position bits only; see CHAR_ADDRESS */
+  uint8_t data;
+};
+
+struct multi_stream {
+  uint8_t n;
+  struct multi_write w[MULTI_MAX_WRITES];
+};
+
+
+/* Address of position pos; A2 is a don't-care on 4-digit parts, so a */
+/* right-to-left one uses the same address as an 8-digit one */
+static uint8_t posAddress(const struct display_spec *spec, uint8_t pos) {
+  if (spec->quirks.left_to_right_digit_numbering) { return pos; }
+  return MULTI_DIGITS-1-pos;
+}
+
+
+/* Position (from the left) that a part writes for an address */
+static uint8_t addressPos(const struct display_spec *spec, uint8_t addr) {
+  addr &= spec->num_digits-1;
+  if (spec->quirks.left_to_right_digit_numbering) { return addr; }
+  return spec->num_digits-1-addr;
+}
+
+
+/* Appends a write, or moves an identical one to the end; false if full */
+static bool streamAdd(struct multi_stream *s, uint8_t addr, uint8_t data) {
+  for (uint8_t i = 0; i < s->n; i++) {
+    if (s->w[i].addr == addr && s->w[i].data == data) {
+      memmove(&s->w[i], &s->w[i+1], (s->n-i-1)*sizeof(s->w[0]));
+      s->n--;
+      break;
+    }
+  }
+  if (s->n == MULTI_MAX_WRITES) { return false; }
+  s->w[s->n].addr = addr;
+  s->w[s->n].data = data;
+  s->n++;
+  return true;
+}
+
+
+/* True if the stream leaves every part of "parts" showing text */
+static bool streamShows(const struct multi_stream *s, uint16_t parts, const uint8_t *text) {
+  for (uint8_t type = 0; type < NUM_DISPLAY_TYPES; type++) {
+    if (!(parts & MULTI_TYPE(type))) { continue; }
+    struct display_spec spec;
+    displaySpec(type, &spec);
+    uint8_t shown[MULTI_DIGITS];
+    uint8_t written = 0;
+    for (uint8_t i = 0; i < s->n; i++) {
+      uint8_t pos = addressPos(&spec, s->w[i].addr);
+      shown[pos] = s->w[i].data;
+      written |= 1 << pos;
+    }
+    for (uint8_t pos = 0; pos < spec.num_digits; pos++) {
+      if (!(written & (1 << pos)) || shown[pos] != text[pos]) { return false; }
+    }
+  }
+  return true;
+}
+
+
+static void streamWrite(const struct multi_stream *s) {
+  for (uint8_t i = 0; i < s->n; i++) {
+    writeByte(s->w[i].addr|CHAR_ADDRESS, s->w[i].data);
+  }
+}
+
+
+uint16_t multiString_P(PGM_P str, uint16_t parts) {
+  uint8_t text[MULTI_DIGITS];
+  struct ptext t;
+  ptextBegin(&t, str);
+  for (uint8_t pos = 0; pos < MULTI_DIGITS; pos++) {
+    text[pos] = t.remaining ? ptextNext(&t) : ' ';
+  }
+  struct multi_stream merged = {0};
+  uint16_t group = 0;
+  for (uint8_t type = 0; type < NUM_DISPLAY_TYPES; type++) {
+    if (!(parts & MULTI_TYPE(type))) { continue; }
+    struct display_spec spec;
+    displaySpec(type, &spec);
+    /* rightmost first, so a 4-digit part's positions are written last */
+    struct multi_stream trial = merged;
+    bool fits = true;
+    for (uint8_t pos = spec.num_digits; pos-- > 0 && fits; ) {
+      fits = streamAdd(&trial, posAddress(&spec, pos), text[pos]);
+    }
+    if (fits && streamShows(&trial, group|MULTI_TYPE(type), text)) {
+      merged = trial;
+      group |= MULTI_TYPE(type);
+    }
+  }
+  streamWrite(&merged);
+  return parts & ~group;
+}
+
+
+bool multiChar(uint8_t pos, uint8_t c, uint16_t parts) {
+  struct multi_stream s = {0};
+  for (uint8_t type = 0; type < NUM_DISPLAY_TYPES; type++) {
+    if (!(parts & MULTI_TYPE(type))) { continue; }
+    struct display_spec spec;
+    displaySpec(type, &spec);
+    if (pos < spec.num_digits) {
+      streamAdd(&s, posAddress(&spec, pos), c);
+    }
+  }
+  streamWrite(&s);
+  return s.n != 0;
+}
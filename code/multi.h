@@ -0,0 +1,37 @@
+/**
+ * Testing the parts in several sockets at once ("MULT" in the menu).
+ *
+ * Every socket on the tester board hangs off the same data and address
+ * bus, ~WR and ~CE, so each bus write reaches every inserted part. What a
+ * part does with it depends on how it decodes the address: HDSP-2xxx
+ * numbers its digits from the left, everything else from the right, and
+ * the 4-digit parts ignore A2.
+ *
+ * These calls take a set of part types (MULTI_TYPE() bits) and build one
+ * write stream per type from its DISPLAYS[] entry, as displayChar() would
+ * for that type alone. A 4-digit part takes the address an 8-digit part
+ * numbered the same way would use (A2 set), so the streams of all the
+ * right-to-left parts come out identical and merge into one. Writes that
+ * appear in several streams are issued once, and the merged stream is
+ * checked by decoding it as each part would: if it leaves a part showing
+ * anything else, that part's stream is left for a later turn instead.
+ * Text that reads differently when the digits are numbered the other way
+ * (anything but a repeated character) is therefore shown to the
+ * left-to-right parts and the right-to-left parts in turn.
+ */
+#pragma once
+
+#include "display.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <avr/pgmspace.h>
+
+#define MULTI_TYPE(t)  ((uint16_t)1 << (t))
+
+/* Shows a packed message on as many of the parts as the bus allows at */
+/* once, and returns the parts that are still to be shown it */
+uint16_t multiString_P(PGM_P str, uint16_t parts);
+/* Writes c to position pos (from the left) of every part that has it; */
+/* returns false if none has */
+bool multiChar(uint8_t pos, uint8_t c, uint16_t parts);
@@ -0,0 +1,454 @@
+#include "net.h"
+#include "blink.h"
+#include "charset.h"
+#include "console.h"
+#include "display.h"
+#include "governor.h"
+#include "panel.h"
+#include "sched.h"
+#include "settings.h"
+#include "uart.h"
+
+#include <string.h>
+#include <util/crc16.h>
+
+#define HEADER_LEN       6     /* destination..length */
+#define US_PER_BYTE      (10*1000000UL/UART_BAUD)
+/* a frame being passed on that stalls for this long is given up on */
+#define PASS_TIMEOUT_MS  5
+/* commits closer than this are waited for instead of polled for */
+#define COMMIT_SPIN_US   200
+/* the last frame is saved for the next boot (boot.h) once it has been */
+/* shown this long without a newer commit, and at most once per */
+/* FRAME_SAVE_MS: the settings journal has only a few slots to wear */
+#define FRAME_IDLE_MS    60000UL
+#define FRAME_SAVE_MS    3600000UL
+
+/* console commands that may be run over the ring: short, no arguments */
+static const char net_commands[] = "LTtCPpBYV";
+
+enum rx_state {
+  RX_HUNT,     /* waiting for NET_SOF */
+  RX_HEADER,
+  RX_PASS,     /* passing a frame for someone else on as it arrives */
+  RX_PAYLOAD,  /* keeping a frame for this node */
+  RX_CRC,
+};
+
+static struct {
+  enum rx_state state;
+  uint8_t hdr[HEADER_LEN];
+  uint8_t payload[NET_MAX_PAYLOAD];
+  uint16_t len;
+  uint16_t pos;
+  uint8_t crc;
+} rx;
+
+/* header fields */
+#define RX_DST   rx.hdr[0]
+#define RX_SEQ   rx.hdr[2]
+#define RX_KIND  rx.hdr[3]
+
+static bool active;
+static bool busy;           /* running a command: don't nest netPoll() */
+static uint8_t tx_crc;
+static uint8_t reply_seq;   /* sequence number of the frame being answered */
+static bool have_last;      /* last_seq/last_status are valid */
+static uint8_t last_seq;
+static uint8_t last_status;
+
+/* staged characters, and those taken for the pending commit */
+static uint8_t stage[8];
+static uint8_t stage_mask;
+static uint8_t commit_chars[8];
+static uint8_t commit_mask;
+static bool panel_ready;
+
+static bool commit_pending;
+static uint16_t commit_at;
+static uint8_t commit_kind;   /* 'F' commit or 'Y' blink sync */
+static bool frame_dirty;      /* the display differs from settings.last_frame */
+static bool frame_saved;      /* saved since powerup */
+static uint32_t frame_saved_at;
+static uint32_t frame_committed_at;
+
+
+void netInit(void) {
+  active = (settings.node_id != 0);
+}
+
+
+bool netActive(void) {
+  return active;
+}
+
+
+void netStart(void) {
+  active = true;
+  rx.state = RX_HEADER;
+  rx.pos = 0;
+  rx.crc = 0;
+}
+
+
+static void txByte(uint8_t b) {
+  tx_crc = _crc8_ccitt_update(tx_crc, b);
+  uartPutc(b);
+}
+
+
+static void txBegin(uint8_t dst, uint8_t seq, uint8_t kind, uint16_t len) {
+  uartPutc(NET_SOF);
+  tx_crc = 0;
+  txByte(dst);
+  txByte(settings.node_id);
+  txByte(seq);
+  txByte(kind);
+  txByte(len & 0xFF);
+  txByte(len >> 8);
+}
+
+
+static void txEnd(void) {
+  uartPutc(tx_crc);
+}
+
+
+static void txFrame(uint8_t dst, uint8_t seq, uint8_t kind, const uint8_t *buf, uint8_t len) {
+  txBegin(dst, seq, kind, len);
+  while (len--) { txByte(*buf++); }
+  txEnd();
+}
+
+
+/* Passes the broadcast just received on, with its (updated) payload */
+static void forward(void) {
+  uartPutc(NET_SOF);
+  tx_crc = 0;
+  for (uint8_t i = 0; i < HEADER_LEN; i++) { txByte(rx.hdr[i]); }
+  for (uint8_t i = 0; i < rx.len; i++) { txByte(rx.payload[i]); }
+  txEnd();
+}
+
+
+static void feed(uint8_t c);
+
+/* Finishes passing on a frame, so a frame of our own can go out */
+static void waitPassed(void) {
+  uint16_t start = schedMillis();
+  while (rx.state == RX_PASS) {
+    int16_t c = uartGetc();
+    if (c >= 0) {
+      feed(c);
+      start = schedMillis();
+    } else if ((uint16_t)(schedMillis() - start) > PASS_TIMEOUT_MS) {
+      /* the rest of it was lost upstream; the host resynchronizes on */
+      /* the next 0xA6 */
+      rx.state = RX_HUNT;
+    }
+  }
+}
+
+
+void netReplyBegin(uint16_t len) {
+  waitPassed();
+  txBegin(NET_HOST, reply_seq, 'r', len);
+}
+
+
+void netReplyByte(uint8_t b) {
+  txByte(b);
+}
+
+
+void netReplyEnd(void) {
+  txEnd();
+}
+
+
+static void ack(uint8_t status) {
+  last_status = status;
+  txFrame(NET_HOST, RX_SEQ, 'a', &status, 1);
+}
+
+
+/* A frame that was taken: asks the host to slow down while the panel is */
+/* behind (governor.h) */
+static uint8_t taken(uint8_t status) {
+  if (status == NET_ACK_OK && panel_ready && govBusy()) { return NET_ACK_BUSY; }
+  return status;
+}
+
+
+static void identify(void) {
+  uint8_t reply[2] = { settings.node_id, disp_type };
+  txFrame(NET_HOST, RX_SEQ, 'q', reply, sizeof(reply));
+}
+
+
+static uint8_t stageChars(void) {
+  if (rx.len < 2) { return NET_ACK_TOO_LONG; }
+  uint8_t target = rx.payload[0];
+  uint8_t pos = rx.payload[1];
+  uint8_t n = rx.len - 2;
+  const uint8_t *c = &rx.payload[2];
+  if (target == NET_TARGET_DISPLAY) {
+    if (pos + n > disp.num_digits) { return NET_ACK_TOO_LONG; }
+    while (n--) {
+      stage[pos] = charsetMap(*c++);
+      stage_mask |= 1 << pos;
+      pos++;
+    }
+  } else if (target == NET_TARGET_PANEL) {
+    uint8_t row = pos / PANEL_COLS;
+    uint8_t col = pos % PANEL_COLS;
+    if (row >= PANEL_ROWS || col + n > PANEL_COLS) { return NET_ACK_TOO_LONG; }
+    if (!panel_ready) {
+      panelInit();
+      charsetLoadGlyphs();
+      panel_ready = true;
+    }
+    /* the panel only changes when it is committed */
+    while (n--) { govStage(pos++, charsetMap(*c++)); }
+  } else {
+    return NET_ACK_UNKNOWN;
+  }
+  return NET_ACK_OK;
+}
+
+
+static void commit(void) {
+  commit_pending = false;
+  for (uint8_t pos = 0; commit_mask; pos++, commit_mask >>= 1) {
+    if (commit_mask & 1) { displayChar(pos, commit_chars[pos]); }
+  }
+  /* once the panel is in use, disp_shadow holds the last panel chip */
+  /* written, not the display (see boot.h) */
+  if (!panel_ready) {
+    frame_dirty = true;
+    frame_committed_at = schedMillis();
+  }
+  /* written by govPoll(), a few cells at a time */
+  if (panel_ready) { govCommit(); }
+}
+
+
+/* Resets the display (or the panel) to bring its blinking into phase with */
+/* the other boards (blink.h) */
+static void sync(void) {
+  commit_pending = false;
+  if (panel_ready) {
+    panelSync();
+    while (!panelFlush(PANEL_COLS)) {}
+  } else {
+    blinkSync();
+  }
+}
+
+
+/* Keeps what the display shows for the next boot, once it has settled */
+static void saveFrame(void) {
+  uint32_t now = schedMillis();
+  if (now - frame_committed_at < FRAME_IDLE_MS) { return; }
+  if (frame_saved && now - frame_saved_at < FRAME_SAVE_MS) { return; }
+  frame_dirty = false;
+  if ((settings.flags & SETTINGS_LAST_FRAME) && settings.display_type == disp_type &&
+      !memcmp(settings.last_frame, disp_shadow.chars, sizeof(settings.last_frame))) {
+    return;
+  }
+  memcpy(settings.last_frame, disp_shadow.chars, sizeof(settings.last_frame));
+  settings.display_type = disp_type;
+  settings.flags |= SETTINGS_LAST_FRAME;
+  settingsSave();
+  frame_saved = true;
+  frame_saved_at = now;
+}
+
+
+static uint16_t clampDelay(uint16_t delay) {
+  return (delay > NET_DELAY_MAX_US) ? NET_DELAY_MAX_US : delay;
+}
+
+
+/* Takes the staged characters for the pending commit, so that 'W' frames */
+/* arriving before its deadline wait for the next one */
+static void latchStage(void) {
+  for (uint8_t pos = 0, mask = stage_mask; mask; pos++, mask >>= 1) {
+    if (mask & 1) { commit_chars[pos] = stage[pos]; }
+  }
+  commit_mask |= stage_mask;
+  stage_mask = 0;
+  if (panel_ready) { govLatch(); }
+}
+
+
+static void scheduleCommit(uint16_t delay, uint8_t kind) {
+  if (commit_pending && commit_kind == 'F' && kind == 'F' && panel_ready) {
+    /* the earlier frame goes out with this one */
+    govDropped();
+  }
+  if (kind == 'F') { latchStage(); }
+  commit_at = schedMicros() + delay;
+  commit_kind = kind;
+  commit_pending = true;
+}
+
+
+static void runCommand(void) {
+  if (rx.len != 1 || !memchr(net_commands, rx.payload[0], sizeof(net_commands)-1)) {
+    ack(NET_ACK_UNKNOWN);
+    return;
+  }
+  reply_seq = RX_SEQ;
+  consoleCommand(rx.payload[0]);
+  reply_seq = 0;
+  ack(NET_ACK_OK);
+}
+
+
+/* A frame addressed to this node */
+static void unicast(void) {
+  if (RX_KIND == 'Q') {
+    identify();
+    return;
+  }
+  /* a retransmission: the first copy was handled but its ack was lost */
+  if (have_last && RX_SEQ == last_seq) {
+    ack(last_status);
+    return;
+  }
+  have_last = true;
+  last_seq = RX_SEQ;
+  if (rx.len > NET_MAX_PAYLOAD) {
+    ack(NET_ACK_TOO_LONG);
+    return;
+  }
+  switch (RX_KIND) {
+    case 'K':
+      runCommand();
+      break;
+    case 'W':
+      ack(taken(stageChars()));
+      break;
+    case 'F':
+      if (rx.len != 2) { ack(NET_ACK_TOO_LONG); break; }
+      scheduleCommit(clampDelay(rx.payload[0] | (rx.payload[1] << 8)), 'F');
+      ack(taken(NET_ACK_OK));
+      break;
+    default:
+      ack(NET_ACK_UNKNOWN);
+      break;
+  }
+}
+
+
+/* A frame for every node: acted on, then passed on (possibly updated) */
+static void broadcast(void) {
+  uint8_t *p = rx.payload;
+  bool leave = false;
+  switch (RX_KIND) {
+    case 'E':
+      if (rx.len != 1) { break; }
+      if (p[0] == NET_BROADCAST) { break; }   /* out of ids */
+      settings.node_id = p[0];
+      if (!p[0]) { settings.flags &= ~SETTINGS_LAST_FRAME; }
+      settingsSave();
+      have_last = false;
+      if (p[0]) {
+        p[0]++;
+      } else {
+        leave = true;
+      }
+      break;
+    case 'F':
+    case 'Y':
+      if (rx.len != 2) { break; }
+      {
+        /* the next node gets the frame one frame-time later */
+        uint16_t delay = clampDelay(p[0] | (p[1] << 8));
+        uint16_t hop = (1 + HEADER_LEN + rx.len + 1)*US_PER_BYTE + NET_HOP_EXTRA_US;
+        scheduleCommit(delay, RX_KIND);
+        delay = (delay > hop) ? delay - hop : 0;
+        p[0] = delay & 0xFF;
+        p[1] = delay >> 8;
+      }
+      break;
+    case 'W':
+      stageChars();
+      break;
+    default:
+      break;
+  }
+  forward();
+  if (RX_KIND == 'Q') { identify(); }
+  if (leave) { active = false; }
+}
+
+
+static void feed(uint8_t c) {
+  switch (rx.state) {
+    case RX_HUNT:
+      if (c == NET_SOF) { netStart(); }
+      break;
+    case RX_HEADER:
+      rx.hdr[rx.pos++] = c;
+      rx.crc = _crc8_ccitt_update(rx.crc, c);
+      if (rx.pos < HEADER_LEN) { break; }
+      rx.len = rx.hdr[4] | (rx.hdr[5] << 8);
+      rx.pos = 0;
+      if ((RX_DST == settings.node_id && RX_DST != NET_HOST) ||
+          (RX_DST == NET_BROADCAST && rx.len <= NET_MAX_PAYLOAD)) {
+        rx.state = rx.len ? RX_PAYLOAD : RX_CRC;
+      } else {
+        /* someone else's: pass it on as it arrives */
+        uartPutc(NET_SOF);
+        uartWrite(rx.hdr, HEADER_LEN);
+        rx.len++;   /* and its CRC */
+        rx.state = RX_PASS;
+      }
+      break;
+    case RX_PASS:
+      uartPutc(c);
+      if (++rx.pos == rx.len) { rx.state = RX_HUNT; }
+      break;
+    case RX_PAYLOAD:
+      rx.crc = _crc8_ccitt_update(rx.crc, c);
+      if (rx.pos < NET_MAX_PAYLOAD) { rx.payload[rx.pos] = c; }
+      if (++rx.pos == rx.len) { rx.state = RX_CRC; }
+      break;
+    case RX_CRC:
+      rx.state = RX_HUNT;
+      /* a damaged frame is dropped; the host retransmits */
+      if (c != rx.crc) { break; }
+      busy = true;
+      if (RX_DST == NET_BROADCAST) {
+        broadcast();
+      } else {
+        unicast();
+      }
+      busy = false;
+      break;
+  }
+}
+
+
+void netPoll(void) {
+  if (busy) { return; }
+  int16_t c;
+  while (active && (c = uartGetc()) >= 0) {
+    feed(c);
+  }
+  if (commit_pending) {
+    int16_t left = commit_at - schedMicros();
+    if (left < COMMIT_SPIN_US) {
+      while ((int16_t)(commit_at - schedMicros()) > 0) {}
+      if (commit_kind == 'Y') {
+        sync();
+      } else {
+        commit();
+      }
+    }
+  }
+  if (panel_ready) { govPoll(); }
+  if (frame_dirty && active) { saveFrame(); }
+}
@@ -0,0 +1,93 @@
+/**
+ * Daisy-chained tester boards and panels on one host serial port.
+ *
+ * The boards form a ring: the host's TXD goes to the first board's RXD,
+ * each board's TXD (PC4) to the next board's RXD (PC5), and the last
+ * board's TXD back to the host's RXD. Long runs use RS-485 transceivers as
+ * plain line drivers, one pair per hop; no direction control is needed.
+ *
+ * Every frame travels around the ring:
+ *   0xA6, destination, source, sequence, kind, length (2 bytes),
+ *   payload, CRC-8/CCITT over destination..payload (initial value 0)
+ * Address 0 is the host and 0xFF is every node. A node keeps frames
+ * addressed to it, passes others on as they arrive, and takes a copy of
+ * broadcasts, which it passes on once they are complete (so it can update
+ * them). Its own frames go out between frames it is passing on, so replies
+ * from every node reach the host without collisions.
+ *
+ * A board joins the ring when it has a node id (settings.node_id, 1-254);
+ * with id 0 the serial port is the plain console (console.h) until the
+ * first 0xA6 arrives. Host to node:
+ *   'E' next id      broadcast: take "next id" as the node id and pass on
+ *                    next id + 1 (the host gets back the node count + 1);
+ *                    0 takes every board out of the ring
+ *   'Q'              who are you: reply 'q' (node id, display type)
+ *   'K' command      run a one-byte console command (L T t C P p B Y V); its
+ *                    reply frames come back wrapped in 'r' frames
+ *   'W' target, position, characters
+ *                    stage characters; target 0 is the display under test
+ *                    (position = digit), 1 the panel (position =
+ *                    row*32 + column, see panel.h). Nothing changes until
+ *                    the next commit. Panel frames are written a few
+ *                    cells at a time, merging frames that arrive faster
+ *                    than the bus takes them (governor.h).
+ *   'F' delay (2 bytes, us, at most NET_DELAY_MAX_US)
+ *                    commit the characters staged so far "delay" us after
+ *                    the frame is received; characters staged while it is
+ *                    pending wait for the next 'F'. Each node subtracts its forwarding
+ *                    time before passing the broadcast on, so every node
+ *                    shows the new frame at the same moment. What the
+ *                    display shows is saved for the next powerup once it
+ *                    has stayed up a minute, at most once an hour (see
+ *                    boot.h).
+ *   'Y' delay (2 bytes, us, at most NET_DELAY_MAX_US)
+ *                    broadcast: reset the display (or panel) "delay" us
+ *                    after the frame is received, corrected per hop as
+ *                    for 'F', so every board blinks in phase (blink.h)
+ * Node to host:
+ *   'a' status       acknowledges a unicast frame (same sequence number);
+ *                    status 0 ok, 1 unknown, 2 too long, 3 taken
+ *                    but the panel is behind: send less often
+ *   'q' id, type     reply to 'Q'
+ *   'r' frame        a console frame (console.h), e.g. a test result
+ * A repeated sequence number from the host is acknowledged again but not
+ * run twice, so the host can retransmit safely.
+ *
+ * tools/netbus.py is the host side; tools/netsim.py stands in for a ring
+ * of boards on a pseudo-terminal.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define NET_SOF          0xA6
+#define NET_HOST         0x00
+#define NET_BROADCAST    0xFF
+#define NET_MAX_PAYLOAD  40   /* longest frame a node keeps (the ring passes any length) */
+/* forwarding time not accounted for by the bytes on the wire */
+#define NET_HOP_EXTRA_US 20
+/* longest 'F'/'Y' delay: the deadline is kept in schedMicros(), which */
+/* wraps every 65 ms; longer delays are cut to this */
+#define NET_DELAY_MAX_US 32767
+
+#define NET_ACK_OK       0
+#define NET_ACK_UNKNOWN  1
+#define NET_ACK_TOO_LONG 2
+#define NET_ACK_BUSY     3
+
+#define NET_TARGET_DISPLAY  0
+#define NET_TARGET_PANEL    1
+
+/* Enters the ring if the board has a node id */
+void netInit(void);
+bool netActive(void);
+/* Joins the ring after the console has seen NET_SOF */
+void netStart(void);
+/* Handles received bytes and due commits; called from consolePoll() */
+void netPoll(void);
+
+/* Console frames in ring mode: wrapped in an 'r' frame to the host */
+void netReplyBegin(uint16_t len);
+void netReplyByte(uint8_t b);
+void netReplyEnd(void);
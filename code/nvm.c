@@ -0,0 +1,33 @@
+#include "nvm.h"
+
+#include <avr/io.h>
+#include <string.h>
+#include <util/atomic.h>
+
+
+bool nvmBusy(void) {
+  return NVMCTRL.STATUS & NVMCTRL_EEBUSY_bm;
+}
+
+
+void nvmRead(uint8_t addr, void *dst, uint8_t len) {
+  /* EEPROM is memory-mapped on megaAVR 0-series */
+  memcpy(dst, (const void *)(MAPPED_EEPROM_START+addr), len);
+}
+
+
+bool nvmWrite(uint8_t addr, const void *src, uint8_t len) {
+  /* an interrupt that writes too (the SW1 reset flushes the settings and */
+  /* the log) must not land between filling the page buffer and the command */
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    if (nvmBusy()) { return false; }
+    /* fill page buffer */
+    volatile uint8_t *dst = (volatile uint8_t *)(MAPPED_EEPROM_START+addr);
+    const uint8_t *s = src;
+    while (len--) { *dst++ = *s++; }
+    /* start erase/write of the loaded bytes; completes in the background */
+    CCP = 0x9D; /* unlock NVMCTRL.CTRLA (SPM) */
+    NVMCTRL.CTRLA = NVMCTRL_CMD_PAGEERASEWRITE_gc;
+  }
+  return true;
+}
@@ -0,0 +1,25 @@
+/**
+ * EEPROM layout and non-blocking EEPROM writes.
+ *
+ * A write loads the bytes into the NVM controller's page buffer and starts
+ * an erase/write, then returns while the hardware programs the cells
+ * (a few milliseconds). Only the bytes loaded into the buffer are erased and
+ * written. One write can be in progress at a time: nvmWrite() returns false
+ * while the controller is busy, and the caller retries from its poll routine.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* EEPROM map */
+#define NVM_SETTINGS_ADDR   0x00  /* settings journal (settings.c) */
+#define NVM_SETTINGS_SIZE   0x80
+#define NVM_LOG_ADDR        0x80  /* test result log (resultlog.c) */
+#define NVM_LOG_SIZE        0x80
+
+bool nvmBusy(void);
+void nvmRead(uint8_t addr, void *dst, uint8_t len);
+/* The range must not cross an EEPROM page boundary. Runs with interrupts */
+/* off (a few microseconds), so it may also be used from an interrupt. */
+bool nvmWrite(uint8_t addr, const void *src, uint8_t len);
@@ -0,0 +1,252 @@
+#include "panel.h"
+#include "capture.h"
+#include "charset.h"
+#include "display.h"
+#include "font.h"
+#include "pins.h"
+#include "profile.h"
+#include "pin_xmega.h"
+
+#include <string.h>
+
+#define GLYPH_MASK  0b00011111
+
+/* a cell value the panel can never be showing */
+#define CELL_UNKNOWN  0xFF
+
+struct panel_cell panel_fb[PANEL_ROWS][PANEL_COLS];
+/* what the panel is showing */
+static struct panel_cell shown[PANEL_ROWS][PANEL_COLS];
+static uint8_t dirty_rows;
+static uint8_t cursor_row = PANEL_NO_CURSOR;
+static uint8_t cursor_col;
+static bool resetting;
+/* where the next flush starts */
+static uint8_t flush_row;
+static uint8_t flush_col;
+static uint16_t visited;
+
+
+void panelSelect(uint8_t chip) {
+  VPORT(PANEL_SEL_PORT).OUT = (VPORT(PANEL_SEL_PORT).OUT & ~PANEL_SEL_MASK) | chip;
+}
+
+
+void panelReset(void) {
+  /* ~DRST resets (and clears) every chip at once */
+  resetStart(RESET_HARD);
+  resetting = true;
+  /* first flush rewrites every cell */
+  memset(shown, CELL_UNKNOWN, sizeof(shown));
+  for (uint8_t row = 0; row < PANEL_ROWS; row++) {
+    panelFill(row, 0, PANEL_COLS-1, 0);
+  }
+  cursor_row = PANEL_NO_CURSOR;
+}
+
+
+void panelSync(void) {
+  resetStart(RESET_HARD);
+  resetting = true;
+  /* the chips come out of reset showing blanks without flashing; the next */
+  /* flush puts back everything else */
+  for (uint8_t row = 0; row < PANEL_ROWS; row++) {
+    for (uint8_t col = 0; col < PANEL_COLS; col++) {
+      shown[row][col].c = ' ';
+      shown[row][col].attr = 0;
+    }
+  }
+  dirty_rows = _BV(PANEL_ROWS)-1;
+}
+
+
+/* Finishes a reset once ~DRST has been released */
+bool panelReady(void) {
+  if (!resetting) { return true; }
+  if (!resetPoll()) { return false; }
+  /* the chips come out of reset blank, so only the control word and the */
+  /* fallback glyphs need writing */
+  for (uint8_t chip = 0; chip < PANEL_ROWS*PANEL_CHIPS_PER_ROW; chip++) {
+    panelSelect(chip);
+    writeControlRegister(CR_HDSP_BRIGHTNESS_100|CR_HDSP_FLASH_ON);
+    charsetLoadGlyphs();
+  }
+  resetting = false;
+  return true;
+}
+
+
+void panelInit(void) {
+  VPORT(PANEL_SEL_PORT).DIR |= PANEL_SEL_MASK;
+  setDisplayType(HDSP2xxx);
+  panelReset();
+  while (!panelReady()) {}
+}
+
+
+void panelPut(uint8_t row, uint8_t col, uint8_t c, uint8_t attr) {
+  panel_fb[row][col].c = c;
+  panel_fb[row][col].attr = attr;
+  dirty_rows |= _BV(row);
+}
+
+
+void panelFill(uint8_t row, uint8_t from, uint8_t to, uint8_t attr) {
+  for (uint8_t col = from; col <= to; col++) {
+    panel_fb[row][col].c = ' ';
+    panel_fb[row][col].attr = attr;
+  }
+  dirty_rows |= _BV(row);
+}
+
+
+void panelScroll(uint8_t top, uint8_t bottom, int8_t n, uint8_t attr) {
+  uint8_t lines = bottom - top + 1;
+  uint8_t count = (n < 0) ? -n : n;
+  if (count > lines) { count = lines; }
+  uint8_t kept = lines - count;
+  if (n > 0) {
+    memmove(panel_fb[top], panel_fb[top+count], kept*sizeof(panel_fb[0]));
+    for (uint8_t row = top+kept; row <= bottom; row++) {
+      panelFill(row, 0, PANEL_COLS-1, attr);
+    }
+  } else {
+    memmove(panel_fb[top+count], panel_fb[top], kept*sizeof(panel_fb[0]));
+    for (uint8_t row = top; row < top+count; row++) {
+      panelFill(row, 0, PANEL_COLS-1, attr);
+    }
+  }
+  for (uint8_t row = top; row <= bottom; row++) {
+    dirty_rows |= _BV(row);
+  }
+}
+
+
+void panelSetCursor(uint8_t row, uint8_t col) {
+  if (row == cursor_row && col == cursor_col) { return; }
+  if (cursor_row != PANEL_NO_CURSOR) { dirty_rows |= _BV(cursor_row); }
+  cursor_row = row;
+  cursor_col = col;
+  if (row != PANEL_NO_CURSOR) { dirty_rows |= _BV(row); }
+}
+
+
+/* Character c drawn with the attributes */
+static void glyphRows(uint8_t c, uint8_t attr, uint8_t rows[FONT_ROWS]) {
+  fontGlyph(c, rows);
+  for (uint8_t row = 0; row < FONT_ROWS; row++) {
+    uint8_t pattern = rows[row];
+    if (attr & PANEL_ATTR_BOLD) { pattern |= pattern >> 1; }
+    if ((attr & PANEL_ATTR_UNDERLINE) && row == FONT_ROWS-1) { pattern = GLYPH_MASK; }
+    if (attr & PANEL_ATTR_REVERSE) { pattern = ~pattern; }
+    rows[row] = pattern & GLYPH_MASK;
+  }
+}
+
+
+/* Loads the digit's own UDC with character c, drawn with the attributes */
+static void writeGlyph(uint8_t digit, uint8_t c, uint8_t attr) {
+  uint8_t rows[FONT_ROWS];
+  glyphRows(c, attr, rows);
+  setUserDefinedChar(digit, rows);
+}
+
+
+static void writeCell(uint8_t row, uint8_t col, struct panel_cell cell, struct panel_cell old) {
+  panelSelect(row*PANEL_CHIPS_PER_ROW + col/PANEL_CHIP_DIGITS);
+  uint8_t digit = col % PANEL_CHIP_DIGITS;
+  uint8_t c = cell.c;
+  if (cell.attr & PANEL_ATTR_GLYPH) {
+    writeGlyph(digit, c, cell.attr);
+    c = CHAR_ATTR|digit;
+  }
+  if ((cell.attr ^ old.attr) & PANEL_ATTR_BLINK) {
+    /* flash RAM */
+    writeByte(digit|_BV(ADDR_A4)|_BV(ADDR_A3), (cell.attr & PANEL_ATTR_BLINK) != 0);
+  }
+  displayChar(digit, c);
+}
+
+
+/* What the cell should show, with the cursor */
+static struct panel_cell wanted(uint8_t row, uint8_t col) {
+  struct panel_cell cell = panel_fb[row][col];
+  if (row == cursor_row && col == cursor_col) { cell.attr |= PANEL_ATTR_BLINK; }
+  return cell;
+}
+
+
+bool panelFlush(uint8_t budget) {
+  if (!panelReady()) { return false; }
+  PROF_BEGIN();
+  /* carry on where the last flush ran out of budget, so cells that keep */
+  /* changing can't hold back the rest; the first row may be visited again */
+  /* from its start */
+  for (uint8_t n = 0; n <= PANEL_ROWS && budget && dirty_rows; n++) {
+    uint8_t row = flush_row;
+    uint8_t col = PANEL_COLS;
+    if (dirty_rows & _BV(row)) {
+      for (col = flush_col; col < PANEL_COLS; col++) {
+        struct panel_cell cell = wanted(row, col);
+        struct panel_cell old = shown[row][col];
+        if (cell.c == old.c && cell.attr == old.attr) { continue; }
+        if (!budget) { break; }
+        writeCell(row, col, cell, old);
+        shown[row][col] = cell;
+        budget--;
+      }
+      /* only a row compared all the way through is clean */
+      if (col == PANEL_COLS && flush_col == 0) { dirty_rows &= ~_BV(row); }
+    }
+    visited += col - flush_col;
+    if (col < PANEL_COLS) {
+      flush_col = col;
+      break;
+    }
+    flush_col = 0;
+    flush_row = (row + 1) % PANEL_ROWS;
+  }
+  PROF_END(PROF_FLUSH);
+  return dirty_rows == 0;
+}
+
+
+uint8_t panelPending(void) {
+  uint8_t n = 0;
+  for (uint8_t row = 0; row < PANEL_ROWS; row++) {
+    if (!(dirty_rows & _BV(row))) { continue; }
+    for (uint8_t col = 0; col < PANEL_COLS; col++) {
+      struct panel_cell cell = wanted(row, col);
+      if (cell.c != shown[row][col].c || cell.attr != shown[row][col].attr) { n++; }
+    }
+  }
+  return n;
+}
+
+
+uint16_t panelVisited(void) {
+  return visited;
+}
+
+
+/* What a chip's UDC holds: a digit's attributed glyph, or a fallback glyph */
+static void udcRows(uint8_t chip, uint8_t idx, uint8_t rows[FONT_ROWS]) {
+  if (idx >= PANEL_CHIP_DIGITS) {
+    fontGlyph(CHAR_ATTR|idx, rows);
+    return;
+  }
+  uint8_t row = chip / PANEL_CHIPS_PER_ROW;
+  uint8_t col = (chip % PANEL_CHIPS_PER_ROW)*PANEL_CHIP_DIGITS + idx;
+  glyphRows(shown[row][col].c, shown[row][col].attr, rows);
+}
+
+
+void panelCapture(void) {
+  while (!panelReady()) {}
+  struct capture_device devs[PANEL_ROWS*PANEL_CHIPS_PER_ROW];
+  for (uint8_t chip = 0; chip < PANEL_ROWS*PANEL_CHIPS_PER_ROW; chip++) {
+    panelSelect(chip);
+    captureRead(&devs[chip]);
+  }
+  captureSend(devs, PANEL_ROWS*PANEL_CHIPS_PER_ROW, CAPTURE_READBACK|CAPTURE_PANEL, udcRows);
+}
@@ -0,0 +1,75 @@
+/**
+ * 4x4 PDSP1881 panel (pdsp1881_4x4): 16 chips, 4 rows of 32 characters.
+ *
+ * Everything draws into a framebuffer of characters and attributes. A copy
+ * of what the panel currently shows is kept alongside it, and
+ * panelFlush() only writes the cells that differ, a few at a time, so a
+ * caller can keep servicing the serial port between calls. Each call
+ * carries on from the cell where the last one stopped, so every cell is
+ * written within one pass over the panel however often others change.
+ * Rows are tracked as dirty so unchanged rows aren't even compared.
+ *
+ * Blinking uses each chip's flash RAM. Bold, underline and reverse video
+ * are drawn with the chip's user-defined characters: every digit has its
+ * own UDC (8 digits, 16 UDCs per chip), built from the 5x7 font in
+ * font.def with the attributes applied.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define PANEL_ROWS          4
+#define PANEL_COLS          32
+#define PANEL_CHIP_DIGITS   8
+#define PANEL_CHIPS_PER_ROW (PANEL_COLS/PANEL_CHIP_DIGITS)
+
+/* Cell attributes */
+#define PANEL_ATTR_BOLD       0b00000001
+#define PANEL_ATTR_UNDERLINE  0b00000010
+#define PANEL_ATTR_REVERSE    0b00000100
+#define PANEL_ATTR_BLINK      0b00001000
+/* attributes that need a user-defined character */
+#define PANEL_ATTR_GLYPH      (PANEL_ATTR_BOLD|PANEL_ATTR_UNDERLINE|PANEL_ATTR_REVERSE)
+
+#define PANEL_NO_CURSOR  0xFF
+
+struct panel_cell {
+  uint8_t c;
+  uint8_t attr;
+};
+
+extern struct panel_cell panel_fb[PANEL_ROWS][PANEL_COLS];
+
+/* Sets up the panel, resets all chips and clears the framebuffer */
+void panelInit(void);
+/* Resets all chips together and clears the framebuffer without waiting: */
+/* panelFlush() finishes the reset (one ~DRST pulse for the whole panel) */
+/* and writes nothing until then */
+void panelReset(void);
+/* Resets all chips together to bring their blinking into phase (see */
+/* blink.h), keeping the framebuffer: panelFlush() puts it back */
+void panelSync(void);
+void panelPut(uint8_t row, uint8_t col, uint8_t c, uint8_t attr);
+/* Fills columns from..to (inclusive) of a row */
+void panelFill(uint8_t row, uint8_t from, uint8_t to, uint8_t attr);
+/* Moves rows top..bottom (inclusive) up by n (n > 0) or down by -n, */
+/* filling the rows left behind with blanks */
+void panelScroll(uint8_t top, uint8_t bottom, int8_t n, uint8_t attr);
+/* The cursor is shown by blinking its cell; row PANEL_NO_CURSOR hides it */
+void panelSetCursor(uint8_t row, uint8_t col);
+/* Writes at most "budget" changed cells; returns true if the panel is */
+/* up to date */
+bool panelFlush(uint8_t budget);
+/* Cells that differ from what the panel shows */
+uint8_t panelPending(void);
+/* Cells panelFlush() has compared so far (wraps): once it has gone up by */
+/* PANEL_ROWS*PANEL_COLS, everything drawn before has been written */
+uint16_t panelVisited(void);
+/* Sends a snapshot of all 16 chips (see capture.h) */
+void panelCapture(void);
+/* For drawing on the chips directly (bitmap.c): selects chip */
+/* row*PANEL_CHIPS_PER_ROW + column of chips for the display.h calls */
+void panelSelect(uint8_t chip);
+/* Finishes a pending reset; false until the chips can be written */
+bool panelReady(void);
@@ -0,0 +1,60 @@
+/**
+ * Tester board pin assignments.
+ *
+ * Every build checks these against the schematic's netlist
+ * (../alphadisplays.net): tools/pinmap.py writes pins_net.h, which stops
+ * the build if a signal here isn't on the pin the board connects it to.
+ */
+#pragma once
+
+/* active high */
+#define LED_PORT        D
+#define LED_PIN         7
+/* ~WR - write (active low) */
+#define nWR_PORT        E
+#define nWR_PIN         1
+/* ~CE - chip enable (active low) */
+#define nCE_PORT        E
+#define nCE_PIN         2
+/* ~CLR (2416/3416/3422) / ~RST (HDSP-2xxx/PD2816) - clear/reset display (active low) */
+#define nCLR_PORT       E
+#define nCLR_PIN        3
+/* ~RD (HDSP-2xxx/PD2816) - read (active low) */
+#define nRD_PORT        B
+#define nRD_PIN         0
+/* CUE (2416/3416/3422) - cursor enable (active high) */
+#define CUE_PORT        B
+#define CUE_PIN         2
+/* ~BL (2416/3416/3422) - blank display (active low) */
+#define nBL_PORT        B
+#define nBL_PIN         3
+/* Button 1 (left) */
+#define nSW1_PORT       C
+#define nSW1_PIN        1
+/* Button 2 (right) */
+#define nSW2_PORT       C
+#define nSW2_PIN        0
+/* HDSP-2xxx clock detect */
+#define HDSPCLK_PORT    C
+#define HDSPCLK_PIN     2
+/* PD2816 clock detect */
+#define PD2816CLK_PORT  C
+#define PD2816CLK_PIN   3
+/* Data lines D0-D7 */
+#define DATA_PORT       A
+/* Address lines A0-A4 and ~FL. ~CU is A3. */
+#define ADDRESS_PORT    F
+/* Serial port (USART1 on its alternate pins), wired by hand to pins 16 */
+/* and 17, which the board leaves free (see uart.h) */
+#define TXD_PORT        C
+#define TXD_PIN         4
+#define RXD_PORT        C
+#define RXD_PIN         5
+
+/* 4x4 PDSP1881 panel (pdsp1881_4x4), cabled to the tester in place of a  */
+/* socketed part. D0-D7, A0-A4, ~FL, ~WR and ~RD go to the tester's bus,  */
+/* ~DRST to ~CLR, and ~DISPEN to ~CE, so ~CE strobes whichever chip the   */
+/* panel's 74AHC138s decode from S0-S3. */
+/* S0-S3 - panel chip select (unused pins on the tester board) */
+#define PANEL_SEL_PORT  D
+#define PANEL_SEL_MASK  0b00001111
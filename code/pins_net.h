@@ -0,0 +1,158 @@
+/* Generated by tools/pinmap.py from alphadisplays.net -- do not edit. */
+/*
+ * The tester board as wired in the schematic (U1, ATmega4809-A). Including this
+ * stops the build if pins.h or display.h disagree with it.
+ * pdsp1881_4x4.kicad_pcb: select code S3..S0 = row*4 + column (checked).
+ */
+#pragma once
+
+#include "pins.h"
+#include "display.h"
+
+#define NET_PORT_A 0
+#define NET_PORT_B 1
+#define NET_PORT_C 2
+#define NET_PORT_D 3
+#define NET_PORT_E 4
+#define NET_PORT_F 5
+#define NET_PORT_(p) NET_PORT_##p
+#define NET_PORT(p)  NET_PORT_(p)
+
+/* via D9 */
+#define NET_LED_PORT D
+#define NET_LED_PIN  7
+#if NET_PORT(LED_PORT) != NET_PORT_D || LED_PIN != 7
+#error "pins.h: LED should be PD7 (via D9 in alphadisplays.net)"
+#endif
+
+/* /~WR */
+#define NET_nWR_PORT E
+#define NET_nWR_PIN  1
+#if NET_PORT(nWR_PORT) != NET_PORT_E || nWR_PIN != 1
+#error "pins.h: nWR should be PE1 (/~WR in alphadisplays.net)"
+#endif
+
+/* /~CE */
+#define NET_nCE_PORT E
+#define NET_nCE_PIN  2
+#if NET_PORT(nCE_PORT) != NET_PORT_E || nCE_PIN != 2
+#error "pins.h: nCE should be PE2 (/~CE in alphadisplays.net)"
+#endif
+
+/* /~CLR */
+#define NET_nCLR_PORT E
+#define NET_nCLR_PIN  3
+#if NET_PORT(nCLR_PORT) != NET_PORT_E || nCLR_PIN != 3
+#error "pins.h: nCLR should be PE3 (/~CLR in alphadisplays.net)"
+#endif
+
+/* /~RD */
+#define NET_nRD_PORT B
+#define NET_nRD_PIN  0
+#if NET_PORT(nRD_PORT) != NET_PORT_B || nRD_PIN != 0
+#error "pins.h: nRD should be PB0 (/~RD in alphadisplays.net)"
+#endif
+
+/* /CUE */
+#define NET_CUE_PORT B
+#define NET_CUE_PIN  2
+#if NET_PORT(CUE_PORT) != NET_PORT_B || CUE_PIN != 2
+#error "pins.h: CUE should be PB2 (/CUE in alphadisplays.net)"
+#endif
+
+/* /~BL */
+#define NET_nBL_PORT B
+#define NET_nBL_PIN  3
+#if NET_PORT(nBL_PORT) != NET_PORT_B || nBL_PIN != 3
+#error "pins.h: nBL should be PB3 (/~BL in alphadisplays.net)"
+#endif
+
+/* /~SW1 */
+#define NET_nSW1_PORT C
+#define NET_nSW1_PIN  1
+#if NET_PORT(nSW1_PORT) != NET_PORT_C || nSW1_PIN != 1
+#error "pins.h: nSW1 should be PC1 (/~SW1 in alphadisplays.net)"
+#endif
+
+/* /~SW2 */
+#define NET_nSW2_PORT C
+#define NET_nSW2_PIN  0
+#if NET_PORT(nSW2_PORT) != NET_PORT_C || nSW2_PIN != 0
+#error "pins.h: nSW2 should be PC0 (/~SW2 in alphadisplays.net)"
+#endif
+
+/* /HDSPCLK */
+#define NET_HDSPCLK_PORT C
+#define NET_HDSPCLK_PIN  2
+#if NET_PORT(HDSPCLK_PORT) != NET_PORT_C || HDSPCLK_PIN != 2
+#error "pins.h: HDSPCLK should be PC2 (/HDSPCLK in alphadisplays.net)"
+#endif
+
+/* /PD2816CLK */
+#define NET_PD2816CLK_PORT C
+#define NET_PD2816CLK_PIN  3
+#if NET_PORT(PD2816CLK_PORT) != NET_PORT_C || PD2816CLK_PIN != 3
+#error "pins.h: PD2816CLK should be PC3 (/PD2816CLK in alphadisplays.net)"
+#endif
+
+/* USART1 TXD, pin 16 (wired by hand) */
+#define NET_TXD_PORT C
+#define NET_TXD_PIN  4
+#if NET_PORT(TXD_PORT) != NET_PORT_C || TXD_PIN != 4
+#error "pins.h: TXD should be PC4 (USART1 alternate pin 16)"
+#endif
+
+/* USART1 RXD, pin 17 (wired by hand) */
+#define NET_RXD_PORT C
+#define NET_RXD_PIN  5
+#if NET_PORT(RXD_PORT) != NET_PORT_C || RXD_PIN != 5
+#error "pins.h: RXD should be PC5 (USART1 alternate pin 17)"
+#endif
+
+/* /D0-/D7 on bits 0-7 */
+#define NET_DATA_PORT A
+#if NET_PORT(DATA_PORT) != NET_PORT_A
+#error "pins.h: DATA_PORT should be A"
+#endif
+
+#define NET_ADDRESS_PORT F
+#if NET_PORT(ADDRESS_PORT) != NET_PORT_F
+#error "pins.h: ADDRESS_PORT should be F"
+#endif
+#if ADDR_A0 != 0
+#error "display.h: ADDR_A0 should be 0 (/A0)"
+#endif
+#if ADDR_A1 != 1
+#error "display.h: ADDR_A1 should be 1 (/A1)"
+#endif
+#if ADDR_A2 != 2
+#error "display.h: ADDR_A2 should be 2 (/A2)"
+#endif
+#if ADDR_A3 != 3
+#error "display.h: ADDR_A3 should be 3 (/A3)"
+#endif
+#if ADDR_A4 != 4
+#error "display.h: ADDR_A4 should be 4 (/A4)"
+#endif
+#if ADDR_FL != 5
+#error "display.h: ADDR_FL should be 5 (/~FL)"
+#endif
+
+/* pins not connected on the board (the panel select lines go here) */
+#define NET_FREE_A 0b00000000
+#define NET_FREE_B 0b00110010
+#define NET_FREE_C 0b11110000
+#define NET_FREE_D 0b01111111
+#define NET_FREE_E 0b00000001
+#define NET_FREE_F 0b00000000
+#define NET_FREE_(p) NET_FREE_##p
+#define NET_FREE(p)  NET_FREE_(p)
+#if PANEL_SEL_MASK & ~NET_FREE(PANEL_SEL_PORT)
+#error "pins.h: PANEL_SEL_MASK uses pins that are connected on the board"
+#endif
+#if (1 << TXD_PIN) & ~NET_FREE(TXD_PORT)
+#error "pins.h: TXD is on a pin that is connected on the board"
+#endif
+#if (1 << RXD_PIN) & ~NET_FREE(RXD_PORT)
+#error "pins.h: RXD is on a pin that is connected on the board"
+#endif
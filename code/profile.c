@@ -0,0 +1,102 @@
+#include "profile.h"
+#include "console.h"
+
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+
+#define STACK_PAINT  0xC5
+
+/* from the linker script: end of static data, and top of RAM */
+extern uint8_t _end;
+extern uint8_t __stack;
+
+static struct prof_stats stats[PROF_NUM_SITES];
+static uint16_t overhead;
+
+
+/* Runs before the C runtime is set up, so nothing is on the stack yet */
+__attribute__((naked, used, section(".init1")))
+static void paintStack(void) {
+  asm volatile(
+    "ldi r30, lo8(_end)\n\t"
+    "ldi r31, hi8(_end)\n\t"
+    "ldi r24, %[paint]\n\t"
+    "ldi r25, hi8(__stack)\n\t"
+    "1: st Z+, r24\n\t"
+    "cpi r30, lo8(__stack)\n\t"
+    "cpc r31, r25\n\t"
+    "brlo 1b\n\t"
+    "breq 1b\n\t"
+    :
+    : [paint] "M" (STACK_PAINT)
+  );
+}
+
+
+static uint16_t stackSize(void) {
+  return &__stack - &_end + 1;
+}
+
+
+/* Deepest stack use since reset: bytes no longer holding the paint pattern */
+static uint16_t stackUsed(void) {
+  const uint8_t *p = &_end;
+  while (p <= &__stack && *p == STACK_PAINT) { p++; }
+  return &__stack - p + 1;
+}
+
+
+void profReset(void) {
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    for (uint8_t i = 0; i < PROF_NUM_SITES; i++) {
+      stats[i] = (struct prof_stats){ .min = 0xFFFF };
+    }
+  }
+}
+
+
+void profInit(void) {
+  /* free-running cycle counter */
+  TCA0.SINGLE.PER = 0xFFFF;
+  TCA0.SINGLE.CTRLA = TCA_SINGLE_CLKSEL_DIV1_gc|TCA_SINGLE_ENABLE_bm;
+  /* calibrate with an empty block */
+  overhead = 0;
+  profReset();
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    PROF_BEGIN();
+    PROF_END(PROF_WRITE_BYTE);
+  }
+  overhead = stats[PROF_WRITE_BYTE].min;
+  profReset();
+}
+
+
+void profRecord(enum prof_site site, uint16_t start) {
+  uint16_t cycles = TCA0.SINGLE.CNT - start - overhead;
+  struct prof_stats *s = &stats[site];
+  s->calls++;
+  s->total += cycles;
+  if (cycles < s->min) { s->min = cycles; }
+  if (cycles > s->max) { s->max = cycles; }
+}
+
+
+void profDump(void) {
+  uint8_t hdr[8] = {
+    PROF_NUM_SITES, sizeof(struct prof_stats),
+    stackSize() & 0xFF, stackSize() >> 8,
+    0, 0,
+    overhead & 0xFF, overhead >> 8
+  };
+  struct prof_stats copy[PROF_NUM_SITES];
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    for (uint8_t i = 0; i < PROF_NUM_SITES; i++) { copy[i] = stats[i]; }
+  }
+  uint16_t used = stackUsed();
+  hdr[4] = used & 0xFF;
+  hdr[5] = used >> 8;
+  consoleFrameBegin('P', sizeof(hdr) + sizeof(copy));
+  consoleFrameData(hdr, sizeof(hdr));
+  consoleFrameData(copy, sizeof(copy));
+  consoleFrameEnd();
+}
@@ -0,0 +1,64 @@
+/**
+ * Optional cycle-count instrumentation of the hot paths ("make profile").
+ *
+ * In a profiling build (PROFILE defined), TCA0 free-runs at the CPU clock
+ * and each instrumented site records its call count and total, minimum and
+ * maximum cycles in a RAM table. The time taken by the instrumentation
+ * itself is measured at startup and subtracted. Times are inclusive: a
+ * displayChar() includes its writeByte(), and any interrupt that fires
+ * during a call is counted in that call. Single calls longer than 65535
+ * cycles (3.3ms) wrap.
+ *
+ * The RAM above the static data is also painted at startup so the deepest
+ * stack use can be found later. Console command 'P' dumps everything as
+ * frame 'P' (tools/tester.py PORT profile); 'p' clears the counters.
+ *
+ * In a normal build the macros compile to nothing.
+ */
+#pragma once
+
+#include <stdint.h>
+
+/* Instrumented sites */
+enum prof_site {
+  PROF_WRITE_BYTE,
+  PROF_READ_BYTE,
+  PROF_DISPLAY_CHAR,
+  PROF_SET_UDC,
+  PROF_FLUSH,         /* framebuffer flush */
+  PROF_SCHED_TICK,    /* scheduler tick interrupt */
+  PROF_WRITE_BURST,
+  PROF_NUM_SITES
+};
+
+struct prof_stats {
+  uint32_t calls;
+  uint32_t total;     /* cycles */
+  uint16_t min;
+  uint16_t max;
+};
+
+#ifdef PROFILE
+
+#include <avr/io.h>
+
+/* Place at the start of an instrumented block, and PROF_END() at each exit */
+#define PROF_BEGIN()    uint16_t prof_start_ = TCA0.SINGLE.CNT
+#define PROF_END(site)  profRecord((site), prof_start_)
+
+void profInit(void);
+void profRecord(enum prof_site site, uint16_t start);
+/* Sends frame 'P': number of sites, record size, stack size, deepest stack */
+/* use, instrumentation overhead (2 bytes each), then one struct prof_stats */
+/* per site */
+void profDump(void);
+void profReset(void);
+
+#else
+
+#define PROF_BEGIN()
+#define PROF_END(site)
+
+static inline void profInit(void) {}
+
+#endif
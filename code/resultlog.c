@@ -0,0 +1,127 @@
+#include "resultlog.h"
+#include "console.h"
+#include "nvm.h"
+#include "settings.h"
+
+#include <avr/io.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <util/crc16.h>
+
+#define LOG_ENTRIES  (NVM_LOG_SIZE/sizeof(struct result_entry))
+#define SEQ_ERASED   0xFF
+
+_Static_assert(sizeof(struct result_entry) == 8, "result log entries must be 8 bytes");
+_Static_assert(EEPROM_PAGE_SIZE % sizeof(struct result_entry) == 0,
+               "result log entries must not cross EEPROM pages");
+
+static uint8_t head;      /* slot for the next entry */
+static uint8_t next_seq;
+static struct result_entry pending;
+static bool has_pending;
+
+
+static uint8_t seqAfter(uint8_t seq) {
+  return (seq == SEQ_ERASED-1) ? 0 : seq+1;
+}
+
+
+static uint8_t entryCrc(const struct result_entry *e) {
+  const uint8_t *p = (const uint8_t *)e;
+  uint8_t crc = 0;
+  for (uint8_t i = 0; i < offsetof(struct result_entry, crc); i++) {
+    crc = _crc8_ccitt_update(crc, p[i]);
+  }
+  return crc;
+}
+
+
+/* The entry in a slot, or false if it fails its CRC (or is erased) */
+static bool readEntry(uint8_t slot, struct result_entry *e) {
+  nvmRead(NVM_LOG_ADDR + slot*sizeof(*e), e, sizeof(*e));
+  return e->seq != SEQ_ERASED && e->crc == entryCrc(e);
+}
+
+
+static uint8_t entrySeq(uint8_t slot) {
+  uint8_t seq;
+  nvmRead(NVM_LOG_ADDR + slot*sizeof(struct result_entry), &seq, 1);
+  return seq;
+}
+
+
+void resultlogInit(void) {
+  /* the newest entry is the first one not followed by its successor */
+  uint8_t prev = SEQ_ERASED;
+  head = 0;
+  next_seq = 0;
+  for (uint8_t slot = 0; slot < LOG_ENTRIES; slot++) {
+    uint8_t seq = entrySeq(slot);
+    if (prev != SEQ_ERASED && seq != seqAfter(prev)) {
+      head = slot;
+      next_seq = seqAfter(prev);
+      return;
+    }
+    prev = seq;
+  }
+  /* ring is empty, or the newest entry is in the last slot */
+  if (prev != SEQ_ERASED) { next_seq = seqAfter(prev); }
+}
+
+
+void resultlogAppend(struct result_entry *e) {
+  /* at most one entry is waiting for the EEPROM */
+  while (has_pending) { resultlogPoll(); }
+  e->seq = next_seq;
+  next_seq = seqAfter(next_seq);
+  e->crc = entryCrc(e);
+  pending = *e;
+  has_pending = true;
+  consoleFrameBegin('R', sizeof(*e));
+  consoleFrameData(e, sizeof(*e));
+  consoleFrameEnd();
+  resultlogPoll();
+}
+
+
+void resultlogPoll(void) {
+  if (!has_pending) { return; }
+  if (nvmWrite(NVM_LOG_ADDR + head*sizeof(pending), &pending, sizeof(pending))) {
+    has_pending = false;
+    head++;
+    if (head >= LOG_ENTRIES) { head = 0; }
+  }
+}
+
+
+void resultlogFlush(void) {
+  while (has_pending || nvmBusy()) {
+    resultlogPoll();
+  }
+}
+
+
+void resultlogDump(void) {
+  /* an entry in the slot about to be overwritten means the ring is full */
+  bool full = entrySeq(head) != SEQ_ERASED;
+  uint8_t slots = full ? LOG_ENTRIES : head;
+  uint8_t first = full ? head : 0;
+  struct result_entry e;
+  uint8_t count = 0;
+  for (uint8_t i = 0, slot = first; i < slots; i++) {
+    if (readEntry(slot, &e)) { count++; }
+    if (++slot >= LOG_ENTRIES) { slot = 0; }
+  }
+  uint8_t hdr[6] = {
+    settings.parts_tested & 0xFF, settings.parts_tested >> 8,
+    settings.parts_failed & 0xFF, settings.parts_failed >> 8,
+    sizeof(struct result_entry), count
+  };
+  consoleFrameBegin('L', sizeof(hdr) + count*sizeof(struct result_entry));
+  consoleFrameData(hdr, sizeof(hdr));
+  for (uint8_t i = 0, slot = first; i < slots; i++) {
+    if (readEntry(slot, &e)) { consoleFrameData(&e, sizeof(e)); }
+    if (++slot >= LOG_ENTRIES) { slot = 0; }
+  }
+  consoleFrameEnd();
+}
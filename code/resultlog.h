@@ -0,0 +1,51 @@
+/**
+ * Persistent test result log.
+ *
+ * One fixed-size entry per tested part, appended to a ring in EEPROM so the
+ * most recent results survive a reset. Each entry is also sent over the
+ * serial console as soon as it is logged, so a host capturing the port
+ * (tools/tester.py watch) gets every part of a batch, not just the ones
+ * still in the ring. The whole ring can be dumped with the 'L' command.
+ *
+ * Each entry ends with a CRC-8/CCITT over the bytes before it, so an entry
+ * torn by a power loss during its EEPROM write is left out of the dump.
+ * The timestamp is uptime only: the tester has no real-time clock, and it
+ * reboots after every test, so it tells how long the run took since power-
+ * up, not when it happened.
+ */
+#pragma once
+
+#include <stdint.h>
+
+/* Which test failed first */
+enum result_test {
+  RESULT_PASS,
+  RESULT_READBACK_DATA,     /* character RAM readback */
+  RESULT_READBACK_CONTROL,  /* control register readback */
+  RESULT_SELFTEST,          /* HDSP-2xxx built-in self-test */
+};
+
+struct result_entry {
+  uint8_t seq;            /* 0-254, wraps; 0xFF = erased */
+  uint8_t display_type;   /* enum display_type */
+  uint8_t test;           /* enum result_test */
+  uint8_t fail_addr;      /* failing digit/address */
+  uint8_t fail_bits;      /* bits that read back wrong */
+  uint8_t selftest_time;  /* HDSP-2xxx self-test duration, 50ms units */
+  uint8_t timestamp;      /* uptime, 1024ms ticks; RESULT_TIMESTAMP_MAX if longer */
+  uint8_t crc;            /* CRC-8/CCITT of the bytes above */
+};
+
+#define RESULT_SELFTEST_TIME_MS  50
+#define RESULT_TIMESTAMP_MAX     0xFF
+
+void resultlogInit(void);
+/* Queues an entry (seq and crc are filled in); the EEPROM write does not */
+/* block */
+void resultlogAppend(struct result_entry *e);
+void resultlogPoll(void);
+/* Blocks until a queued entry is written (use before a reset) */
+void resultlogFlush(void);
+/* Sends frame 'L': parts tested/failed, entry size, count, then the entries */
+/* from oldest to newest, leaving out those that fail their CRC */
+void resultlogDump(void);
@@ -0,0 +1,53 @@
+#include "sched.h"
+#include "console.h"
+#include "profile.h"
+#include "resultlog.h"
+#include "settings.h"
+
+#include <avr/interrupt.h>
+#include <avr/io.h>
+#include <util/atomic.h>
+
+static volatile uint32_t ticks;
+
+
+ISR(TCB0_INT_vect) {
+  PROF_BEGIN();
+  TCB0.INTFLAGS = TCB_CAPT_bm;
+  ticks++;
+  PROF_END(PROF_SCHED_TICK);
+}
+
+
+void schedInit(void) {
+  /* periodic interrupt mode */
+  TCB0.CCMP = F_CPU/SCHED_TICK_HZ - 1;
+  TCB0.INTCTRL = TCB_CAPT_bm;
+  TCB0.CTRLA = TCB_CLKSEL_CLKDIV1_gc|TCB_ENABLE_bm;
+}
+
+
+uint32_t schedMillis(void) {
+  uint32_t t;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { t = ticks; }
+  return t;
+}
+
+
+uint16_t schedMicros(void) {
+  uint16_t t, cnt;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    t = ticks;
+    cnt = TCB0.CNT;
+    /* the counter has wrapped but the tick hasn't been counted yet */
+    if ((TCB0.INTFLAGS & TCB_CAPT_bm) && cnt < (F_CPU/SCHED_TICK_HZ)/2) { t++; }
+  }
+  return t*(1000000/SCHED_TICK_HZ) + cnt/(F_CPU/1000000);
+}
+
+
+void schedPoll(void) {
+  settingsPoll();
+  resultlogPoll();
+  consolePoll();
+}
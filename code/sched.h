@@ -0,0 +1,19 @@
+/**
+ * System tick and background task scheduler.
+ *
+ * TCB0 generates a 1 kHz tick. Anything that waits (waitMillis(), button
+ * polling, menus) calls schedPoll() in its loop, which services the
+ * background tasks: deferred EEPROM writes and serial console commands.
+ */
+#pragma once
+
+#include <stdint.h>
+
+#define SCHED_TICK_HZ  1000
+
+void schedInit(void);
+/* Milliseconds since power-up */
+uint32_t schedMillis(void);
+/* Microseconds, wrapping every 65.536 ms; for timing short intervals */
+uint16_t schedMicros(void);
+void schedPoll(void);
@@ -0,0 +1,92 @@
+#include "settings.h"
+#include "nvm.h"
+
+#include <avr/io.h>
+#include <util/crc16.h>
+
+/* change when struct settings changes, so old records are not misread */
+#define SETTINGS_CRC_INIT  0xA1
+
+struct settings_record {
+  uint8_t seq;            /* incremented (mod 256) with each save */
+  struct settings s;
+  uint8_t crc;
+};
+
+#define SETTINGS_SLOTS  (NVM_SETTINGS_SIZE/sizeof(struct settings_record))
+
+_Static_assert(sizeof(struct settings_record) == 32, "settings record must be 32 bytes");
+_Static_assert(EEPROM_PAGE_SIZE % sizeof(struct settings_record) == 0,
+               "settings records must not cross EEPROM pages");
+
+struct settings settings;
+
+static uint8_t slot;  /* slot holding the current record */
+static uint8_t seq;   /* sequence number of the current record */
+static bool dirty;
+
+
+static uint8_t recordCrc(const struct settings_record *r) {
+  const uint8_t *p = (const uint8_t *)r;
+  uint8_t crc = SETTINGS_CRC_INIT;
+  for (uint8_t i = 0; i < sizeof(*r)-1; i++) {
+    crc = _crc8_ccitt_update(crc, p[i]);
+  }
+  return crc;
+}
+
+
+void settingsLoad(void) {
+  struct settings_record r;
+  bool found = false;
+  for (uint8_t i = 0; i < SETTINGS_SLOTS; i++) {
+    nvmRead(NVM_SETTINGS_ADDR + i*sizeof(r), &r, sizeof(r));
+    if (r.crc != recordCrc(&r)) { continue; }
+    /* valid records are consecutive, so "newer" is a short step forward */
+    if (!found || (uint8_t)(r.seq - seq) < 0x80) {
+      found = true;
+      slot = i;
+      seq = r.seq;
+      settings = r.s;
+    }
+  }
+  if (!found) {
+    /* no journal yet: import the fixed addresses used by earlier firmware */
+    uint8_t swap;
+    nvmRead(1, settings.menu_idx, SETTINGS_NUM_MENUS);
+    nvmRead(7, &swap, 1);
+    settings.flags = (swap & 1) ? SETTINGS_A0_A1_NOT_SWAPPED : 0;
+    settings.display_type = 0xFF;
+    slot = SETTINGS_SLOTS-1;
+    seq = 0xFF;
+  }
+}
+
+
+void settingsSave(void) {
+  dirty = true;
+  settingsPoll();
+}
+
+
+void settingsPoll(void) {
+  if (!dirty || nvmBusy()) { return; }
+  struct settings_record r;
+  uint8_t next = slot+1;
+  if (next >= SETTINGS_SLOTS) { next = 0; }
+  r.seq = seq+1;
+  r.s = settings;
+  r.crc = recordCrc(&r);
+  if (nvmWrite(NVM_SETTINGS_ADDR + next*sizeof(r), &r, sizeof(r))) {
+    slot = next;
+    seq = r.seq;
+    dirty = false;
+  }
+}
+
+
+void settingsFlush(void) {
+  while (dirty || nvmBusy()) {
+    settingsPoll();
+  }
+}
@@ -0,0 +1,56 @@
+/**
+ * Nonvolatile settings.
+ *
+ * All settings are kept in one packed, CRC-protected record. Each save
+ * appends a new copy of the record to the next slot of a round-robin
+ * journal in EEPROM, so frequently-changed values (last display type,
+ * production counters) are spread across the whole window instead of
+ * wearing out one cell. At boot, one scan of the window finds the newest
+ * valid record; a record torn by a reset during a write fails its CRC and
+ * the previous one is used instead.
+ *
+ * Saves never block: settingsSave() marks the record dirty, and
+ * settingsPoll() starts the EEPROM write once the NVM controller is free.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* settings.flags */
+#define SETTINGS_A0_A1_NOT_SWAPPED  0b00000001
+#define SETTINGS_LAST_FRAME         0b00000010  /* last_frame is valid (boot.h) */
+
+/* Menus that remember their last selection */
+enum settings_menu {
+  SETTINGS_MENU_MAIN,
+  SETTINGS_MENU_DL1414,
+  SETTINGS_MENU_DL1416,
+  SETTINGS_MENU_DL2416,
+  SETTINGS_MENU_DL3416,
+  SETTINGS_NUM_MENUS
+};
+
+struct settings {
+  uint8_t menu_idx[SETTINGS_NUM_MENUS]; /* last selection in each menu */
+  uint8_t flags;
+  uint8_t display_type;                 /* last tested display type, or the */
+                                        /* one last_frame was shown on */
+  uint16_t parts_tested;                /* production counters */
+  uint16_t parts_failed;
+  uint8_t bus_timing[2][3];             /* characterized bus timing, PD2816 and */
+                                        /* HDSP-2xxx (see shmoo.h); 0 = none */
+  uint8_t node_id;                      /* address on a ring of boards (net.h); */
+                                        /* 0 = not on one */
+  uint8_t last_frame[8];                /* last characters committed from the */
+                                        /* ring, by position (boot.h) */
+  uint8_t reserved[4];                  /* keeps the record at 32 bytes */
+};
+
+extern struct settings settings;
+
+void settingsLoad(void);
+void settingsSave(void);
+void settingsPoll(void);
+/* Blocks until all saved settings are written (use before a reset) */
+void settingsFlush(void);
@@ -0,0 +1,154 @@
+#include "shmoo.h"
+#include "console.h"
+#include "settings.h"
+
+#include <avr/io.h>
+
+_Static_assert(sizeof(struct bus_timing) == sizeof(settings.bus_timing[0]),
+               "settings.bus_timing must hold a struct bus_timing");
+
+
+/* Stored timing for a display type, or NULL if it can't be characterized */
+static struct bus_timing *storedTiming(enum display_type type) {
+  switch (type) {
+    case PD2816:   return (struct bus_timing *)settings.bus_timing[0];
+    case HDSP2xxx: return (struct bus_timing *)settings.bus_timing[1];
+    default:       return NULL;
+  }
+}
+
+
+bool shmooAvailable(void) {
+  return storedTiming(disp_type) != NULL;
+}
+
+
+/* Characterized minimum plus the margin, if that beats the default */
+static uint8_t derate(uint8_t cycles) {
+  uint8_t derated = (cycles * (100 + SHMOO_DERATE_PERCENT) + 99) / 100;
+  return derated < BUS_DEFAULT_CYCLES ? derated : BUS_DEFAULT_CYCLES;
+}
+
+
+void shmooApplyTiming(void) {
+  const struct bus_timing *t = storedTiming(disp_type);
+  if (!t || t->setup == 0) {
+    busSetDefaultTiming();
+    return;
+  }
+  struct bus_timing derated = {
+    derate(t->setup),
+    derate(t->strobe),
+    derate(t->hold)
+  };
+  busSetTiming(&derated);
+}
+
+
+void shmooForget(void) {
+  struct bus_timing *t = storedTiming(disp_type);
+  if (!t) { return; }
+  *t = (struct bus_timing){0};
+  settingsSave();
+  shmooApplyTiming();
+}
+
+
+/* Die temperature from the internal sensor, using the factory calibration */
+static int8_t dieTemperature(void) {
+  VREF.CTRLA = VREF_ADC0REFSEL_1V1_gc;
+  ADC0.CTRLC = ADC_SAMPCAP_bm|ADC_REFSEL_INTREF_gc|ADC_PRESC_DIV16_gc;
+  ADC0.CTRLD = ADC_INITDLY_DLY32_gc;
+  ADC0.SAMPCTRL = 31; /* datasheet wants >= 32us sampling for the sensor */
+  ADC0.MUXPOS = ADC_MUXPOS_TEMPSENSE_gc;
+  ADC0.CTRLA = ADC_ENABLE_bm;
+  ADC0.COMMAND = ADC_STCONV_bm;
+  while (!(ADC0.INTFLAGS & ADC_RESRDY_bm)) {}
+  uint16_t reading = ADC0.RES;
+  ADC0.CTRLA = 0;
+  /* from the datasheet */
+  uint32_t kelvin = reading - (int8_t)SIGROW.TEMPSENSE1;
+  kelvin *= SIGROW.TEMPSENSE0;
+  kelvin += 0x80;
+  kelvin >>= 8;
+  return (int16_t)kelvin - 273;
+}
+
+
+/* Pattern for one character position: walking ones, walking zeros, then alternating bits */
+static uint8_t pattern(uint8_t set, uint8_t pos) {
+  uint8_t k = (set + pos) & 7;
+  if (set < 8)  { return _BV(k); }
+  if (set < 16) { return ~_BV(k); }
+  return (k & 1) ? 0x55 : 0xAA;
+}
+
+#define NUM_PATTERN_SETS  18
+
+
+/* Writes and reads back every pattern set through the character RAM */
+static bool verify(void) {
+  for (uint8_t rep = 0; rep < SHMOO_REPEAT; rep++) {
+    for (uint8_t set = 0; set < NUM_PATTERN_SETS; set++) {
+      for (uint8_t pos = 0; pos < disp.num_digits; pos++) {
+        writeByte(pos|_BV(ADDR_FL)|_BV(ADDR_A4)|_BV(ADDR_A3), pattern(set, pos));
+      }
+      for (uint8_t pos = 0; pos < disp.num_digits; pos++) {
+        if (readByte(pos|_BV(ADDR_FL)|_BV(ADDR_A4)|_BV(ADDR_A3)) != pattern(set, pos)) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+
+void shmooRun(void) {
+  struct shmoo_result r = {0};
+  r.display_type = disp_type;
+  r.temperature = dieTemperature();
+  struct bus_timing *stored = storedTiming(disp_type);
+
+  if (stored) {
+    struct bus_timing t;
+    busSetDefaultTiming();
+    t = bus_timing;
+    r.passed = verify();
+    if (r.passed) {
+      /* sweep each interval down, keeping the ones already found */
+      uint8_t *sweep[3] = {&t.strobe, &t.setup, &t.hold};
+      for (uint8_t i = 0; i < 3; i++) {
+        while (*sweep[i] > BUS_MIN_CYCLES) {
+          (*sweep[i])--;
+          busSetTiming(&t);
+          if (!verify()) {
+            (*sweep[i])++;
+            break;
+          }
+        }
+      }
+      r.min = t;
+      /* the sweep stopped at the floor, not at a failure */
+      if (t.setup == BUS_MIN_CYCLES)  { r.at_floor |= SHMOO_FLOOR_SETUP; }
+      if (t.strobe == BUS_MIN_CYCLES) { r.at_floor |= SHMOO_FLOOR_STROBE; }
+      if (t.hold == BUS_MIN_CYCLES)   { r.at_floor |= SHMOO_FLOOR_HOLD; }
+      /* keep the worst case over all runs */
+      if (stored->setup == 0) {
+        *stored = t;
+      } else {
+        if (t.setup > stored->setup)   { stored->setup = t.setup; }
+        if (t.strobe > stored->strobe) { stored->strobe = t.strobe; }
+        if (t.hold > stored->hold)     { stored->hold = t.hold; }
+      }
+      settingsSave();
+    }
+    r.stored = *stored;
+    shmooApplyTiming();
+    softResetDisplay();
+  }
+
+  consoleFrameBegin('T', sizeof(r));
+  consoleFrameData(&r, sizeof(r));
+  consoleFrameEnd();
+}
@@ -0,0 +1,56 @@
+/**
+ * Bus timing characterization ("shmoo") for parts that can be read back.
+ *
+ * Starting from the default timing, each bus interval is shortened one CPU
+ * cycle at a time (strobe width first, then setup, then hold, keeping the
+ * shortest passing value of each before moving to the next) until a
+ * write/readback of the character RAM fails. The result is reported over
+ * the console as frame 'T', together with the die temperature, so a batch
+ * of parts can be characterized across temperature runs.
+ *
+ * The worst case (longest) minimum over all runs is kept in the settings for
+ * each part type. Production tests then run at that minimum plus
+ * SHMOO_DERATE_PERCENT, rounded up to whole cycles. Only intervals that come
+ * out shorter than the default are used; the others stay at the default, so
+ * characterization never makes a test slower.
+ *
+ * The sweep cannot go below BUS_MIN_CYCLES (200 ns, the shortest interval
+ * the bus code can produce), well above the 100 ns write pulse of the
+ * datasheets, so most parts pass all the way down. An interval that does
+ * is flagged in at_floor: its value is the limit of the tester, not a
+ * measurement of the part, and tools/tester.py shows it as "<=".
+ */
+#pragma once
+
+#include "display.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* margin added to the characterized minimum for production tests */
+#define SHMOO_DERATE_PERCENT 25
+/* every step must pass this many complete pattern sets */
+#define SHMOO_REPEAT         8
+
+/* struct shmoo_result.at_floor */
+#define SHMOO_FLOOR_SETUP    0b00000001
+#define SHMOO_FLOOR_STROBE   0b00000010
+#define SHMOO_FLOOR_HOLD     0b00000100
+
+struct shmoo_result {
+  uint8_t display_type;       /* enum display_type */
+  uint8_t passed;             /* 0 if the part fails even at default timing */
+  int8_t temperature;         /* die temperature, degrees C */
+  struct bus_timing min;      /* shortest passing timing in this run */
+  struct bus_timing stored;   /* worst case over all runs so far */
+  uint8_t at_floor;           /* SHMOO_FLOOR_*: min passed at BUS_MIN_CYCLES */
+};
+
+/* True if the current display type can be characterized (it reads back) */
+bool shmooAvailable(void);
+/* Characterizes the current display, then sends frame 'T' */
+void shmooRun(void);
+/* Forgets the stored timing of the current display type */
+void shmooForget(void);
+/* Selects the bus timing for the current display type */
+void shmooApplyTiming(void);
@@ -0,0 +1,332 @@
+#include "term.h"
+#include "charset.h"
+#include "panel.h"
+#include "pins.h"
+#include "settings.h"
+#include "uart.h"
+#include "pin_xmega.h"
+
+#include <stdbool.h>
+#include <avr/io.h>
+
+#define ESC  0x1B
+#define TAB_WIDTH  8
+
+enum term_state {
+  TERM_NORMAL,
+  TERM_ESC,     /* after ESC */
+  TERM_CSI,     /* after ESC [ */
+};
+
+static struct {
+  uint8_t row, col;
+  uint8_t top, bottom;      /* scroll region, inclusive */
+  uint8_t attr;
+  bool wrap_pending;        /* last column written, wrap before the next character */
+  bool cursor_visible;
+  uint8_t saved_row, saved_col, saved_attr;
+  enum term_state state;
+  bool private_params;      /* CSI ? ... */
+  uint8_t nparams;
+  uint8_t params[TERM_MAX_PARAMS];
+  struct utf8 utf8;
+} term;
+
+
+void termReset(void) {
+  term.row = term.col = 0;
+  term.top = 0;
+  term.bottom = PANEL_ROWS-1;
+  term.attr = 0;
+  term.wrap_pending = false;
+  term.cursor_visible = true;
+  term.saved_row = term.saved_col = term.saved_attr = 0;
+  term.state = TERM_NORMAL;
+  for (uint8_t row = 0; row < PANEL_ROWS; row++) {
+    panelFill(row, 0, PANEL_COLS-1, 0);
+  }
+}
+
+
+/* Parameter i, or def if it is missing or 0 */
+static uint8_t param(uint8_t i, uint8_t def) {
+  uint8_t p = (i < term.nparams) ? term.params[i] : 0;
+  return p ? p : def;
+}
+
+
+/* Clamps to the panel; parameters go up to 255, so row and col can be */
+/* far outside it */
+static void moveTo(int16_t row, int16_t col) {
+  if (row < 0) { row = 0; }
+  if (row >= PANEL_ROWS) { row = PANEL_ROWS-1; }
+  if (col < 0) { col = 0; }
+  if (col >= PANEL_COLS) { col = PANEL_COLS-1; }
+  term.row = row;
+  term.col = col;
+  term.wrap_pending = false;
+}
+
+
+static void lineFeed(void) {
+  if (term.row == term.bottom) {
+    panelScroll(term.top, term.bottom, 1, 0);
+  } else if (term.row < PANEL_ROWS-1) {
+    term.row++;
+  }
+  term.wrap_pending = false;
+}
+
+
+static void reverseLineFeed(void) {
+  if (term.row == term.top) {
+    panelScroll(term.top, term.bottom, -1, 0);
+  } else if (term.row > 0) {
+    term.row--;
+  }
+  term.wrap_pending = false;
+}
+
+
+static void printable(uint8_t c) {
+  if (term.wrap_pending) {
+    term.col = 0;
+    lineFeed();
+  }
+  panelPut(term.row, term.col, c, term.attr);
+  if (term.col < PANEL_COLS-1) {
+    term.col++;
+  } else {
+    term.wrap_pending = true;
+  }
+}
+
+
+static void eraseInDisplay(uint8_t mode) {
+  if (mode == 0) {
+    panelFill(term.row, term.col, PANEL_COLS-1, 0);
+    for (uint8_t row = term.row+1; row < PANEL_ROWS; row++) {
+      panelFill(row, 0, PANEL_COLS-1, 0);
+    }
+  } else if (mode == 1) {
+    for (uint8_t row = 0; row < term.row; row++) {
+      panelFill(row, 0, PANEL_COLS-1, 0);
+    }
+    panelFill(term.row, 0, term.col, 0);
+  } else if (mode == 2) {
+    for (uint8_t row = 0; row < PANEL_ROWS; row++) {
+      panelFill(row, 0, PANEL_COLS-1, 0);
+    }
+  }
+}
+
+
+static void eraseInLine(uint8_t mode) {
+  if (mode == 0) {
+    panelFill(term.row, term.col, PANEL_COLS-1, 0);
+  } else if (mode == 1) {
+    panelFill(term.row, 0, term.col, 0);
+  } else if (mode == 2) {
+    panelFill(term.row, 0, PANEL_COLS-1, 0);
+  }
+}
+
+
+static void selectGraphicRendition(void) {
+  if (term.nparams == 0) { term.attr = 0; }
+  for (uint8_t i = 0; i < term.nparams; i++) {
+    switch (term.params[i]) {
+      case 0:  term.attr = 0; break;
+      case 1:  term.attr |= PANEL_ATTR_BOLD; break;
+      case 4:  term.attr |= PANEL_ATTR_UNDERLINE; break;
+      case 5:  term.attr |= PANEL_ATTR_BLINK; break;
+      case 7:  term.attr |= PANEL_ATTR_REVERSE; break;
+      case 22: term.attr &= ~PANEL_ATTR_BOLD; break;
+      case 24: term.attr &= ~PANEL_ATTR_UNDERLINE; break;
+      case 25: term.attr &= ~PANEL_ATTR_BLINK; break;
+      case 27: term.attr &= ~PANEL_ATTR_REVERSE; break;
+      default: break; /* colors etc. */
+    }
+  }
+}
+
+
+static void reply(const char *s) {
+  uartPutc(ESC);
+  uartPutc('[');
+  while (*s) { uartPutc(*s++); }
+}
+
+
+static void replyNumber(uint8_t n) {
+  if (n >= 10) { uartPutc('0' + n/10); }
+  uartPutc('0' + n%10);
+}
+
+
+static void deviceStatusReport(uint8_t what) {
+  if (what == 5) {
+    reply(uartDropped() ? "3n" : "0n");
+  } else if (what == 6) {
+    uartPutc(ESC);
+    uartPutc('[');
+    replyNumber(term.row+1);
+    uartPutc(';');
+    replyNumber(term.col+1);
+    uartPutc('R');
+  } else if (what == 99) {
+    panelCapture();
+  }
+}
+
+
+static void saveCursor(void) {
+  term.saved_row = term.row;
+  term.saved_col = term.col;
+  term.saved_attr = term.attr;
+}
+
+
+static void restoreCursor(void) {
+  moveTo(term.saved_row, term.saved_col);
+  term.attr = term.saved_attr;
+}
+
+
+static void controlSequence(uint8_t final) {
+  uint8_t n = param(0, 1);
+  if (term.private_params) {
+    /* only DECTCEM (cursor visibility) */
+    if (param(0, 0) == 25 && (final == 'h' || final == 'l')) {
+      term.cursor_visible = (final == 'h');
+    }
+    return;
+  }
+  switch (final) {
+    case 'A': moveTo(term.row - n, term.col); break;
+    case 'B': moveTo(term.row + n, term.col); break;
+    case 'C': moveTo(term.row, term.col + n); break;
+    case 'D': moveTo(term.row, term.col - n); break;
+    case 'H':
+    case 'f': moveTo(param(0, 1)-1, param(1, 1)-1); break;
+    case 'J': eraseInDisplay(param(0, 0)); break;
+    case 'K': eraseInLine(param(0, 0)); break;
+    case 'L':
+    case 'M':
+      if (term.row >= term.top && term.row <= term.bottom) {
+        /* no more lines than the region below the cursor has, so n */
+        /* fits panelScroll()'s int8_t */
+        uint8_t lines = term.bottom - term.row + 1;
+        if (n > lines) { n = lines; }
+        panelScroll(term.row, term.bottom, (final == 'L') ? -(int8_t)n : (int8_t)n, 0);
+      }
+      break;
+    case 'm': selectGraphicRendition(); break;
+    case 'n': deviceStatusReport(param(0, 0)); break;
+    case 'r': {
+      uint8_t top = param(0, 1)-1;
+      uint8_t bottom = param(1, PANEL_ROWS)-1;
+      if (bottom >= PANEL_ROWS) { bottom = PANEL_ROWS-1; }
+      if (top < bottom) {
+        term.top = top;
+        term.bottom = bottom;
+        moveTo(0, 0);
+      }
+      break;
+    }
+    case 's': saveCursor(); break;
+    case 'u': restoreCursor(); break;
+    default: break;
+  }
+}
+
+
+static void escape(uint8_t c) {
+  term.state = TERM_NORMAL;
+  switch (c) {
+    case '[':
+      term.state = TERM_CSI;
+      term.private_params = false;
+      term.nparams = 0;
+      term.params[0] = 0;
+      break;
+    case '7': saveCursor(); break;
+    case '8': restoreCursor(); break;
+    case 'D': lineFeed(); break;
+    case 'M': reverseLineFeed(); break;
+    case 'E': term.col = 0; lineFeed(); break;
+    case 'c': panelReset(); termReset(); break;
+    default: break;
+  }
+}
+
+
+static void csiByte(uint8_t c) {
+  if (c >= '0' && c <= '9') {
+    if (term.nparams == 0) { term.nparams = 1; }
+    uint8_t *p = &term.params[term.nparams-1];
+    uint16_t v = *p*10 + (c-'0');
+    *p = (v > 255) ? 255 : v;
+  } else if (c == ';') {
+    if (term.nparams == 0) { term.nparams = 1; }
+    if (term.nparams < TERM_MAX_PARAMS) {
+      term.params[term.nparams++] = 0;
+    }
+  } else if (c == '?') {
+    term.private_params = true;
+  } else if (c >= 0x40 && c <= 0x7E) {
+    term.state = TERM_NORMAL;
+    controlSequence(c);
+  } else if (c < ' ') {
+    /* controls are executed in the middle of a sequence */
+    term.state = TERM_NORMAL;
+    termPutc(c);
+    term.state = TERM_CSI;
+  }
+  /* other intermediate bytes are ignored */
+}
+
+
+void termPutc(uint8_t c) {
+  if (c == ESC) {
+    term.state = TERM_ESC;
+    return;
+  }
+  if (term.state == TERM_ESC) { escape(c); return; }
+  if (term.state == TERM_CSI) { csiByte(c); return; }
+  switch (c) {
+    case '\r': term.col = 0; term.wrap_pending = false; break;
+    case '\n':
+    case '\v':
+    case '\f': lineFeed(); break;
+    case '\b': if (term.col > 0) { term.col--; } term.wrap_pending = false; break;
+    case '\t': moveTo(term.row, (term.col/TAB_WIDTH + 1)*TAB_WIDTH); break;
+    default: {
+      uint8_t latin1;
+      if (c >= ' ' && utf8Decode(&term.utf8, c, &latin1) && latin1 >= ' ' && latin1 != 0x7F) {
+        printable(charsetMap(latin1));
+      }
+      break;
+    }
+  }
+}
+
+
+void termRun(void) {
+  /* pressing SW1 reboots the tester */
+  pin_ctrl(nSW1) |= PORT_ISC0_bm|PORT_ISC1_bm;
+  panelInit();
+  termReset();
+  uartDropped();
+  while (1) {
+    int16_t c;
+    uint8_t n = 0;
+    while (n++ < TERM_RX_BATCH && (c = uartGetc()) >= 0) {
+      termPutc(c);
+    }
+    panelSetCursor(term.cursor_visible ? term.row : PANEL_NO_CURSOR, term.col);
+    panelFlush(TERM_FLUSH_CELLS);
+    /* not schedPoll(): the console must not see the terminal's input */
+    settingsPoll();
+  }
+}
@@ -0,0 +1,52 @@
+/**
+ * VT100-subset terminal on the 4x4 PDSP1881 panel (see panel.h).
+ *
+ * Selected with "TERM" in the main menu. From then on, every byte received
+ * on the serial port (see uart.h) goes to the terminal instead of the
+ * console; press SW1 to return to the tester.
+ *
+ * Supported:
+ *   CR, LF, VT, FF, BS, HT (stops every 8 columns); other controls ignored
+ *   ESC 7, ESC 8       save/restore cursor and attributes
+ *   ESC D, ESC M       index, reverse index (scroll at region edges)
+ *   ESC E              next line
+ *   ESC c              reset, clearing the panel
+ *   CSI n A/B/C/D      cursor up/down/right/left
+ *   CSI r;c H, f       cursor position
+ *   CSI n J, CSI n K   erase in display / line (0, 1, 2)
+ *   CSI n L, CSI n M   insert / delete lines within the scroll region
+ *   CSI t;b r          set scroll region
+ *   CSI s, CSI u       save/restore cursor
+ *   CSI n m            SGR 0, 1, 4, 5, 7, 22, 24, 25, 27 (colors ignored)
+ *   CSI ?25 h/l        show/hide cursor
+ *   CSI 5 n            status: ESC[0n, or ESC[3n if received bytes were
+ *                      lost since the last report
+ *   CSI 6 n            cursor position report
+ *   CSI 99 n           snapshot of the panel as a console frame 'C' (see
+ *                      capture.h)
+ *
+ * Text is UTF-8; characters outside Latin-1 show as '?' unless charset.def
+ * has an alias for them, and a few accented letters use fallback glyphs.
+ *
+ * Lines wrap at the last column the way a VT100 does: the cursor stays on
+ * the last column until the next printable character arrives.
+ *
+ * "tools/tester.py PORT termbench" measures the sustained character rate
+ * at 1 Mbaud: the highest rate at which no received byte is lost. No
+ * figure has been measured on hardware yet, so none is given here.
+ */
+#pragma once
+
+#include <stdint.h>
+
+#define TERM_MAX_PARAMS  4
+/* bytes handled from the serial port between flushes */
+#define TERM_RX_BATCH    16
+/* cells written per flush, small enough that the receive buffer can't */
+/* overflow at 1 Mbaud while the flush runs */
+#define TERM_FLUSH_CELLS 4
+
+void termReset(void);
+void termPutc(uint8_t c);
+/* Runs the terminal; does not return */
+void termRun(void) __attribute__((noreturn));
@@ -0,0 +1,265 @@
+#!/usr/bin/env python3
+"""
+Encodes character/5x7 frame sequences into the tester's animation format.
+
+The source is a text file:
+
+  digits 8            display width (1-31 digits)
+  duration 50         default frame duration, ms (1-255)
+  keyframes 0         emit a keyframe every N frames (0: first frame only)
+
+  frame [ms]          starts as a copy of the previous frame
+    text "ABCD\\x80"   sets every digit (padded with spaces)
+    glyph 3           digit 3 shows a 5x7 bitmap, 7 rows of '#'/'.'
+    ..#..
+    (6 more rows)
+  end
+
+Glyphs are placed in HDSP-2xxx user-defined characters; the encoder
+reuses a UDC that already holds the bitmap and never overwrites one that
+another digit is showing. Text-only animations play on any part.
+
+Stream format (all multi-byte values little-endian)
+  header     'A', version (1), digits, default duration (ms),
+             frame count (2 bytes)
+  per frame  flags: bit 7 keyframe, bit 6 UDC updates follow,
+                    bit 5 duration byte follows,
+                    bits 0-4 number of changed cells (not keyframes)
+             [duration (ms)]
+             [UDC count, then per UDC: index, 7 rows of 5 bits packed
+              LSB-first into 5 bytes]
+             keyframe: one character code per digit
+             otherwise: (digit, character code) per changed cell
+  A frame is shown as soon as it is decoded and held for its duration.
+
+Usage: animenc.py SOURCE [-o OUT.h --name NAME | -b OUT.bin] [--report]
+"""
+
+import argparse
+import ast
+import os
+import sys
+
+from packmsg import BitWriter, DefError, QUOTED, c_bytes, parse_row
+
+MAGIC = ord('A')
+VERSION = 1
+FLAG_KEY = 0x80
+FLAG_UDC = 0x40
+FLAG_DURATION = 0x20
+MAX_CELLS = 0x1F
+NUM_UDCS = 16
+UDC_BASE = 0x80
+GLYPH_HEIGHT = 7
+
+
+class AnimError(Exception):
+    pass
+
+
+def parse(path):
+    """Returns (settings, frames); each frame is (duration or None, cells)."""
+    settings = {'digits': 8, 'duration': 50, 'keyframes': 0}
+    frames = []
+    cells = None
+    current = None
+    glyph = None
+    with open(path, encoding='utf-8') as f:
+        for lineno, line in enumerate(f, 1):
+            stripped = line.strip()
+            if glyph is not None:
+                glyph['rows'].append(parse_row(stripped, lineno))
+                if len(glyph['rows']) == GLYPH_HEIGHT:
+                    current[1][glyph['digit']] = tuple(glyph['rows'])
+                    glyph = None
+                continue
+            if not stripped or (current is None and stripped.startswith('#')):
+                continue
+            word, _, rest = stripped.partition(' ')
+            rest = rest.strip()
+            if current is None:
+                if word in settings:
+                    settings[word] = int(rest, 0)
+                elif word == 'frame':
+                    if cells is None:
+                        cells = [' '] * settings['digits']
+                    current = (int(rest, 0) if rest else None, list(cells))
+                else:
+                    raise AnimError("line %d: unexpected %r" % (lineno, word))
+            elif word == 'text':
+                tokens = QUOTED.findall(rest)
+                if len(tokens) != 1:
+                    raise AnimError("line %d: expected quoted text" % lineno)
+                text = ast.literal_eval(tokens[0])
+                if len(text) > settings['digits']:
+                    raise AnimError("line %d: text is longer than %d digits" % (lineno, settings['digits']))
+                current[1][:] = list(text.ljust(settings['digits']))
+            elif word == 'glyph':
+                digit = int(rest, 0)
+                if not 0 <= digit < settings['digits']:
+                    raise AnimError("line %d: no digit %d" % (lineno, digit))
+                glyph = {'digit': digit, 'rows': []}
+            elif word == 'end':
+                frames.append(current)
+                cells = current[1]
+                current = None
+            else:
+                raise AnimError("line %d: unexpected %r in frame" % (lineno, word))
+    if current is not None or glyph is not None:
+        raise AnimError("frame is missing 'end'")
+    if not 1 <= settings['digits'] <= MAX_CELLS:
+        raise AnimError("digits must be 1-%d" % MAX_CELLS)
+    if not 1 <= settings['duration'] <= 255:
+        raise AnimError("duration must be 1-255 ms")
+    if not frames:
+        raise AnimError("no frames")
+    return settings, frames
+
+
+def pack_udc(rows):
+    bits = BitWriter()
+    for row in rows:
+        bits.put(row, 5)
+    return bits.flush()
+
+
+def encode(settings, frames):
+    digits = settings['digits']
+    out = bytearray([MAGIC, VERSION, digits, settings['duration'],
+                     len(frames) & 0xFF, len(frames) >> 8])
+    udcs = [None] * NUM_UDCS
+    last_used = [-1] * NUM_UDCS
+    shown = None
+    for n, (duration, cells) in enumerate(frames):
+        key = n == 0 or (settings['keyframes'] and n % settings['keyframes'] == 0)
+        if duration is not None and not 1 <= duration <= 255:
+            raise AnimError("frame %d: duration must be 1-255 ms" % n)
+        # place glyphs, keeping UDCs that this frame shows
+        wanted = [c for c in cells if isinstance(c, tuple)]
+        keep = {i for i, u in enumerate(udcs) if u in wanted}
+        updates = {}
+        codes = []
+        for c in cells:
+            if not isinstance(c, tuple):
+                code = ord(c)
+                if code > 0xFF:
+                    raise AnimError("frame %d: character %r out of range" % (n, c))
+                codes.append(code)
+                continue
+            if c in udcs:
+                idx = udcs.index(c)
+            else:
+                free = [i for i in range(NUM_UDCS) if i not in keep]
+                if not free:
+                    raise AnimError("frame %d: more than %d different glyphs" % (n, NUM_UDCS))
+                # prefer UDCs the previous frame wasn't showing, then the least recently used
+                on_screen = {code - UDC_BASE for code in (shown or []) if code >= UDC_BASE}
+                idx = min(free, key=lambda i: (i in on_screen, last_used[i]))
+                udcs[idx] = c
+                updates[idx] = c
+                keep.add(idx)
+            last_used[idx] = n
+            codes.append(UDC_BASE + idx)
+        if key:
+            # a keyframe carries everything it shows
+            for code in codes:
+                if code >= UDC_BASE and code - UDC_BASE < NUM_UDCS:
+                    updates[code - UDC_BASE] = udcs[code - UDC_BASE]
+            changed = []
+        else:
+            changed = [(d, code) for d, code in enumerate(codes) if code != shown[d]]
+        flags = (FLAG_KEY if key else len(changed))
+        if updates:
+            flags |= FLAG_UDC
+        if duration is not None and duration != settings['duration']:
+            flags |= FLAG_DURATION
+        out.append(flags)
+        if flags & FLAG_DURATION:
+            out.append(duration)
+        if updates:
+            out.append(len(updates))
+            for idx in sorted(updates):
+                out.append(idx)
+                out += pack_udc(updates[idx])
+        if key:
+            out += bytes(codes)
+        else:
+            for d, code in changed:
+                out += bytes((d, code))
+        shown = codes
+    return bytes(out)
+
+
+def iter_frames(data):
+    """Splits an encoded stream into (header, [(duration ms, frame bytes)])."""
+    if len(data) < 6 or data[0] != MAGIC or data[1] != VERSION:
+        raise AnimError("not an animation stream")
+    digits, default = data[2], data[3]
+    count = data[4] | (data[5] << 8)
+    pos = 6
+    frames = []
+    for _ in range(count):
+        start = pos
+        flags = data[pos]
+        pos += 1
+        duration = default
+        if flags & FLAG_DURATION:
+            duration = data[pos]
+            pos += 1
+        if flags & FLAG_UDC:
+            pos += 1 + data[pos] * 6
+        pos += digits if flags & FLAG_KEY else 2 * (flags & MAX_CELLS)
+        frames.append((duration, data[start:pos]))
+    return data[:6], frames
+
+
+def emit(name, data, source, report):
+    out = ["/* Generated by tools/animenc.py from %s -- do not edit. */" % source,
+           "/*"]
+    out += [" * " + line for line in report]
+    out += [" */",
+            "#pragma once",
+            "",
+            "static const char %s[] PROGMEM = {" % name,
+            c_bytes(data),
+            "};",
+            ""]
+    return '\n'.join(out)
+
+
+def size_report(settings, frames, data):
+    ms = sum(d if d is not None else settings['duration'] for d, _ in frames)
+    # every character and glyph of every frame, a byte per row
+    raw = sum(len(cells) + GLYPH_HEIGHT * sum(isinstance(c, tuple) for c in cells)
+              for _, cells in frames)
+    return ["%d frames, %d digits, %.2f s" % (len(frames), settings['digits'], ms / 1000.0),
+            "%d bytes encoded, %d as full frames" % (len(data), raw)]
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split('\n\n')[0].strip())
+    ap.add_argument('source')
+    ap.add_argument('-o', '--output', help="C header to write")
+    ap.add_argument('--name', help="array name in the header (default: from the source name)")
+    ap.add_argument('-b', '--binary', help="raw stream to write (for tester.py anim)")
+    ap.add_argument('--report', action='store_true', help="print the size report")
+    args = ap.parse_args()
+    try:
+        settings, frames = parse(args.source)
+        data = encode(settings, frames)
+    except (OSError, AnimError, DefError) as e:
+        sys.exit("animenc: %s: %s" % (args.source, e))
+    report = size_report(settings, frames, data)
+    if args.output:
+        name = args.name or os.path.splitext(os.path.basename(args.source))[0]
+        with open(args.output, 'w', encoding='ascii') as f:
+            f.write(emit(name, data, os.path.basename(args.source), report))
+    if args.binary:
+        with open(args.binary, 'wb') as f:
+            f.write(data)
+    if args.report:
+        print('\n'.join(report))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,394 @@
+#!/usr/bin/env python3
+"""
+Analyzes a captured display bus trace: timing against the part's spec,
+bus utilization, idle gaps, writes per frame and redundant writes, with
+VCD export for GTKWave.
+
+The trace is a CSV file from a logic analyzer, one row per sample or per
+change, with a header row naming the columns:
+  time                  first column (or one named "time..."), in seconds
+                        unless --time-unit says otherwise
+  D0..D7, A0..A4, FL    data and address lines, 0/1
+  WR, RD, CE, CLR       the strobes (active low, as on the bus), 0/1
+  S0..S3                optional: panel chip select (pins.h)
+  D, A                  instead of the single lines: hex bus values
+Names may carry a ~, / or n prefix for the active-low lines ("~WR").
+
+A bus cycle runs from ~CE low to ~CE high, with one ~WR or ~RD pulse
+inside. Each is checked against the minimum intervals of display.h's
+struct bus_timing:
+  setup     address valid to ~CE low
+  ce_strobe ~CE low to ~WR/~RD low
+  strobe    ~WR/~RD low to high
+  hold      ~WR/~RD high to ~CE high
+  recovery  ~CE high to the next ~CE low
+The spec of a display type is its datasheet minimums (DATASHEET_NS:
+address setup, chip enable setup, write pulse width and address hold,
+like the reset figures in display.h), so the slack of an interval (its
+shortest measured value minus the spec) is the margin the firmware's
+timing really has. The datasheets give no recovery time between cycles,
+so any is accepted. --spec overrides single figures, e.g. --spec
+strobe=150,hold=20 for a part whose datasheet differs.
+
+A write is redundant if the chip already holds that value at that
+address: an earlier write with nothing since (~CLR low, or a clear bit in
+the control word, forgets everything). UDC rows count per UDC address.
+Writes are sorted by region of the HDSP-2xxx register map (which the
+panel shares) so the callers wasting bandwidth show
+up; for other types the regions are only approximate.
+
+A frame is a run of cycles with no idle gap longer than --frame-gap.
+
+Usage: bustrace.py TRACE.csv [--type TYPE] [--spec NAME=NS,...]
+                   [--violations N] [--vcd OUT.vcd]
+"""
+
+import argparse
+import csv
+import statistics
+import sys
+
+from tester import DISPLAY_TYPES
+
+INTERVALS = ['setup', 'ce_strobe', 'strobe', 'hold', 'recovery']
+
+# datasheet minimums in ns, in the order of INTERVALS: tAS, tCES, tW,
+# tAH, and no recovery time
+DL1414_NS = (10, 0, 130, 20, 0)      # HPDL-1414; no ~CE, tied low
+DL1416_NS = (50, 0, 250, 50, 0)      # DL1416B/T
+DL2416_NS = (10, 0, 100, 20, 0)      # DL2416 and its kin, PD2816, HDSP-2111
+DATASHEET_NS = {
+    'DL1414': DL1414_NS, 'DLX1414': DL1414_NS,
+    'DL1416T': DL1416_NS, 'DL1416B': DL1416_NS,
+    'DL1814': DL2416_NS, 'DL2416': DL2416_NS, 'DLX2416': DL2416_NS,
+    'DL3416': DL2416_NS, 'DLX3416': DL2416_NS, 'DL3422': DL2416_NS,
+    'HDLX2416': DL2416_NS, 'HDLX3416': DL2416_NS,
+    'PD2816': DL2416_NS, 'HDSP2xxx': DL2416_NS,
+}
+
+TIME_UNITS = {'s': 1e9, 'ms': 1e6, 'us': 1e3, 'ns': 1.0}
+LINES = ['D%d' % i for i in range(8)] + ['A%d' % i for i in range(5)] + \
+    ['FL', 'WR', 'RD', 'CE', 'CLR'] + ['S%d' % i for i in range(4)]
+
+ADDR_FL = 0x20
+ADDR_A4 = 0x10
+ADDR_A3 = 0x08
+CR_CLEAR = 0x80
+DEFAULT_FRAME_GAP_US = 1000
+
+
+class TraceError(Exception):
+    pass
+
+
+def signal_name(header):
+    name = header.strip().split('[')[0].strip().upper()
+    for prefix in ('~', '/'):
+        name = name.lstrip(prefix)
+    if name.startswith('N') and name[1:] in ('WR', 'RD', 'CE', 'CLR', 'FL'):
+        name = name[1:]
+    if name in ('DATA',):
+        name = 'D'
+    if name in ('ADDR', 'ADDRESS'):
+        name = 'A'
+    return name
+
+
+def read_trace(path, unit):
+    """Yields (time_ns, {signal: value}) with D, A and S as bus values."""
+    scale = TIME_UNITS[unit]
+    with open(path, newline='') as f:
+        rows = csv.reader(f)
+        try:
+            header = next(rows)
+        except StopIteration:
+            raise TraceError('%s is empty' % path)
+        names = [signal_name(h) for h in header]
+        tcol = next((i for i, n in enumerate(names) if n.startswith('TIME')), 0)
+        for need in ('WR', 'RD', 'CE'):
+            if need not in names:
+                raise TraceError('no %s column' % need)
+        if 'D' not in names and 'D0' not in names:
+            raise TraceError('no data columns (D0..D7 or D)')
+        if 'A' not in names and 'A0' not in names:
+            raise TraceError('no address columns (A0..A4 or A)')
+        for lineno, row in enumerate(rows, 2):
+            if not row:
+                continue
+            try:
+                values = {n: row[i].strip() for i, n in enumerate(names) if i != tcol}
+                t = float(row[tcol]) * scale
+                sig = {}
+                for n in ('WR', 'RD', 'CE', 'CLR'):
+                    sig[n] = int(values.get(n, '1'))
+                if 'D' in values:
+                    sig['D'] = int(values['D'], 16)
+                else:
+                    sig['D'] = sum(int(values.get('D%d' % i, '0')) << i for i in range(8))
+                if 'A' in values:
+                    sig['A'] = int(values['A'], 16)
+                else:
+                    sig['A'] = sum(int(values.get('A%d' % i, '0')) << i for i in range(5))
+                    sig['A'] |= ADDR_FL if int(values.get('FL', '0')) else 0
+                sig['S'] = sum(int(values.get('S%d' % i, '0')) << i for i in range(4))
+            except (ValueError, IndexError):
+                raise TraceError('line %d: %s' % (lineno, ','.join(row)))
+            yield t, sig
+
+
+class Cycle:
+    def __init__(self, start, addr_since, addr, sel):
+        self.start = start            # ~CE low
+        self.addr_since = addr_since  # last address change before it
+        self.addr = addr
+        self.sel = sel
+        self.kind = None              # 'W' or 'R'
+        self.strobe_start = None
+        self.strobe_end = None
+        self.data = None
+        self.end = None               # ~CE high
+        self.addr_changed = False
+
+    def intervals(self):
+        out = {}
+        if self.addr_since is not None:
+            out['setup'] = self.start - self.addr_since
+        if self.strobe_start is not None:
+            out['ce_strobe'] = self.strobe_start - self.start
+        if self.strobe_end is not None:
+            out['strobe'] = self.strobe_end - self.strobe_start
+            if self.end is not None:
+                out['hold'] = self.end - self.strobe_end
+        return out
+
+
+def parse_cycles(samples):
+    """Bus cycles, ~CLR pulses (start times) and the trace's time span."""
+    cycles = []
+    clears = []
+    prev = None
+    addr_since = None
+    cur = None
+    first = last = None
+    for t, sig in samples:
+        if first is None:
+            first = t
+        last = t
+        if prev is None:
+            if not sig['CLR']:
+                clears.append(t)
+            prev = sig
+            continue
+        if sig['A'] != prev['A'] or sig['S'] != prev['S']:
+            addr_since = t
+            if cur is not None:
+                cur.addr_changed = True
+        if prev['CLR'] and not sig['CLR']:
+            clears.append(t)
+        if prev['CE'] and not sig['CE']:
+            cur = Cycle(t, addr_since, sig['A'], sig['S'])
+        if cur is not None:
+            for strobe, kind in (('WR', 'W'), ('RD', 'R')):
+                if prev[strobe] and not sig[strobe] and cur.strobe_start is None:
+                    cur.kind = kind
+                    cur.strobe_start = t
+                if not prev[strobe] and sig[strobe] and cur.kind == kind and cur.strobe_end is None:
+                    cur.strobe_end = t
+                    # data is latched (or sampled) on the rising edge
+                    cur.data = prev['D']
+            if not prev['CE'] and sig['CE']:
+                cur.end = t
+                cycles.append(cur)
+                cur = None
+        prev = sig
+    if first is None:
+        raise TraceError('no samples')
+    return cycles, clears, first, last
+
+
+def region(addr):
+    if not addr & ADDR_FL:
+        return 'flash RAM'
+    hi = addr & (ADDR_A4 | ADDR_A3)
+    return {ADDR_A4 | ADDR_A3: 'character RAM', ADDR_A4: 'control word',
+            ADDR_A3: 'UDC rows', 0: 'UDC address'}[hi]
+
+
+def redundant_writes(cycles, clears):
+    """(cycle, region) of every write that didn't change anything."""
+    held = {}
+    udc_addr = {}
+    clears = list(clears)
+    out = []
+    for c in cycles:
+        while clears and clears[0] <= c.start:
+            clears.pop(0)
+            held.clear()
+            udc_addr.clear()
+        if c.kind != 'W' or c.data is None:
+            continue
+        r = region(c.addr)
+        key = (c.sel, c.addr, udc_addr.get(c.sel) if r == 'UDC rows' else None)
+        if held.get(key) == c.data:
+            out.append((c, r))
+        held[key] = c.data
+        if r == 'UDC address':
+            udc_addr[c.sel] = c.data
+        if r == 'control word' and c.data & CR_CLEAR:
+            # clears character and flash RAM of this chip
+            held = {k: v for k, v in held.items()
+                    if k[0] != c.sel or region(k[1]) not in ('character RAM', 'flash RAM')}
+    return out
+
+
+def spec_for(dtype, overrides):
+    spec = dict(zip(INTERVALS, DATASHEET_NS[dtype]))
+    for item in overrides:
+        name, _, value = item.partition('=')
+        if name not in spec:
+            raise TraceError("unknown interval '%s' (%s)" % (name, ', '.join(INTERVALS)))
+        try:
+            spec[name] = float(value)
+        except ValueError:
+            raise TraceError("bad value in '%s'" % item)
+    return spec
+
+
+def timing_report(cycles, spec, nviolations):
+    measured = {name: [] for name in INTERVALS}
+    violations = []
+    for i, c in enumerate(cycles):
+        iv = c.intervals()
+        if i + 1 < len(cycles):
+            iv['recovery'] = cycles[i + 1].start - c.end
+        for name, ns in iv.items():
+            measured[name].append(ns)
+            if ns < spec[name]:
+                violations.append((c.start, name, ns))
+        if c.addr_changed:
+            violations.append((c.start, 'address changed with ~CE low', None))
+    print('timing (ns)   spec      min     mean   slack  violations')
+    for name in INTERVALS:
+        m = measured[name]
+        if not m:
+            print('  %-10s %5.0f        -        -       -  -' % (name, spec[name]))
+            continue
+        count = sum(1 for _, n, _ in violations if n == name)
+        print('  %-10s %5.0f %8.1f %8.1f %7.1f  %d' % (
+            name, spec[name], min(m), statistics.mean(m), min(m) - spec[name], count))
+    for t, name, ns in violations[:nviolations]:
+        print('  at %.3f us: %s%s' % (t / 1000, name, '' if ns is None else ' %.1f ns' % ns))
+    if len(violations) > nviolations:
+        print('  (%d more violations)' % (len(violations) - nviolations))
+    return len(violations)
+
+
+def usage_report(cycles, first, last, frame_gap_us):
+    span = last - first
+    busy = sum(c.end - c.start for c in cycles)
+    gaps = [(b.start - a.end, a.end) for a, b in zip(cycles, cycles[1:])]
+    print('utilization: %.1f%% of %.3f ms with ~CE low' % (
+        100.0 * busy / span if span else 0, span / 1e6))
+    if gaps:
+        longest = max(gaps)
+        print('idle gaps (us): min %.3f, median %.3f, max %.3f (at %.3f us)' % (
+            min(gaps)[0] / 1000, statistics.median(g for g, _ in gaps) / 1000,
+            longest[0] / 1000, longest[1] / 1000))
+    frames = [[cycles[0]]]
+    for (gap, _), c in zip(gaps, cycles[1:]):
+        if gap > frame_gap_us * 1000:
+            frames.append([])
+        frames[-1].append(c)
+    writes = [sum(1 for c in f if c.kind == 'W') for f in frames]
+    print('frames (gaps over %d us): %d, writes per frame min %d, mean %.1f, max %d' % (
+        frame_gap_us, len(frames), min(writes), statistics.mean(writes), max(writes)))
+
+
+def redundancy_report(cycles, clears):
+    writes = sum(1 for c in cycles if c.kind == 'W')
+    redundant = redundant_writes(cycles, clears)
+    print('redundant writes: %d of %d (%.1f%%)' % (
+        len(redundant), writes, 100.0 * len(redundant) / writes if writes else 0))
+    by_region = {}
+    by_addr = {}
+    for c, r in redundant:
+        by_region[r] = by_region.get(r, 0) + 1
+        by_addr[(c.sel, c.addr)] = by_addr.get((c.sel, c.addr), 0) + 1
+    for r, n in sorted(by_region.items(), key=lambda x: -x[1]):
+        print('  %-14s %d' % (r, n))
+    top = sorted(by_addr.items(), key=lambda x: -x[1])[:5]
+    if top:
+        print('  most: ' + ', '.join('chip %d addr 0x%02x x%d' % (s, a, n) for (s, a), n in top))
+
+
+def vcd_id(i):
+    return chr(33 + i)
+
+
+def write_vcd(path, samples):
+    """Every bus signal, with the timescale in ns."""
+    buses = [('D', 8), ('A', 6), ('S', 4)]
+    lines = ['WR', 'RD', 'CE', 'CLR']
+    ids = {name: vcd_id(i) for i, name in enumerate([b for b, _ in buses] + lines)}
+    names = {'D': 'data', 'A': 'addr', 'S': 'sel', 'WR': 'nWR', 'RD': 'nRD',
+             'CE': 'nCE', 'CLR': 'nCLR'}
+    with open(path, 'w') as f:
+        f.write('$timescale 1ns $end\n$scope module bus $end\n')
+        for name, width in buses:
+            f.write('$var wire %d %s %s $end\n' % (width, ids[name], names[name]))
+        for name in lines:
+            f.write('$var wire 1 %s %s $end\n' % (ids[name], names[name]))
+        f.write('$upscope $end\n$enddefinitions $end\n')
+        prev = {}
+        origin = None
+        for t, sig in samples:
+            if origin is None:
+                origin = t
+            changes = []
+            for name, width in buses:
+                if prev.get(name) != sig[name]:
+                    changes.append('b%s %s' % (format(sig[name], '0%db' % width), ids[name]))
+            for name in lines:
+                if prev.get(name) != sig[name]:
+                    changes.append('%d%s' % (sig[name], ids[name]))
+            if changes:
+                f.write('#%d\n%s\n' % (round(t - origin), '\n'.join(changes)))
+            prev = sig
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split('\n\n')[0].strip())
+    ap.add_argument('trace')
+    ap.add_argument('--type', choices=DISPLAY_TYPES, default='HDSP2xxx',
+                    help='display type whose spec applies (default HDSP2xxx, the panel)')
+    ap.add_argument('--spec', default='',
+                    help='override datasheet minimums in ns, e.g. strobe=150,hold=20')
+    ap.add_argument('--time-unit', choices=sorted(TIME_UNITS), default='s',
+                    help='unit of the time column (default s)')
+    ap.add_argument('--frame-gap', type=int, default=DEFAULT_FRAME_GAP_US,
+                    help='idle time in us that ends a frame (default %d)' % DEFAULT_FRAME_GAP_US)
+    ap.add_argument('--violations', type=int, default=10, help='violations to list (default 10)')
+    ap.add_argument('--vcd', help='VCD file to write')
+    args = ap.parse_args()
+    try:
+        spec = spec_for(args.type, [s for s in args.spec.split(',') if s])
+        samples = list(read_trace(args.trace, args.time_unit))
+        cycles, clears, first, last = parse_cycles(samples)
+        if args.vcd:
+            write_vcd(args.vcd, samples)
+    except (OSError, TraceError) as e:
+        sys.exit('bustrace: %s' % e)
+    if not cycles:
+        sys.exit('bustrace: no bus cycles in the trace')
+    print('%s: %d cycles (%d writes, %d reads), %d ~CLR pulses' % (
+        args.trace, len(cycles), sum(1 for c in cycles if c.kind == 'W'),
+        sum(1 for c in cycles if c.kind == 'R'), len(clears)))
+    violations = timing_report(cycles, spec, args.violations)
+    usage_report(cycles, first, last, args.frame_gap)
+    redundancy_report(cycles, clears)
+    if violations:
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,209 @@
+#!/usr/bin/env python3
+"""
+Builds the character-set translation tables from charset.def.
+
+Writes charset_tables.h, which is included by charset.c:
+
+  charset_NAME     256 bytes per character set: the code to write to the
+                   part for each Latin-1 character
+  charset_glyphs   the fallback glyphs, packed like the glyph tables in
+                   messages.h (see tools/packmsg.py)
+  charset_aliases  (code point, Latin-1 character) pairs for the UTF-8
+                   decoder, sorted by code point
+
+Fallback glyph i is shown as code CHARSET_UDC_CODE+i (user-defined
+character 8+i); CHARSET_UDC_CODE in charset.h must match UDC_CODE here.
+
+Usage: mkcharset.py charset.def [-o charset_tables.h] [--report]
+"""
+
+import argparse
+import ast
+import re
+import sys
+import unicodedata
+
+from packmsg import DefError, GLYPH_HEIGHT, c_bytes, pack_rows, parse_row
+
+UDC_CODE = 0x88
+MAX_GLYPHS = 8
+UNKNOWN = ord('?')
+SUB = 0x1A   # the UTF-8 decoder's "no such character"
+COMMENT = re.compile(r'\s+#.*$')
+
+
+def parse_chars(token, lineno):
+    if token.startswith('"'):
+        try:
+            return ast.literal_eval(token)
+        except (SyntaxError, ValueError):
+            raise DefError("line %d: bad string %s" % (lineno, token))
+    return token
+
+
+def parse(path):
+    charsets = []
+    translit = {}
+    aliases = {}
+    glyphs = []
+    current = None
+    with open(path, encoding='utf-8') as f:
+        for lineno, line in enumerate(f, 1):
+            stripped = line.strip()
+            if current is not None:
+                if stripped == 'end':
+                    if len(current['rows']) != GLYPH_HEIGHT:
+                        raise DefError("line %d: glyph %s has %d rows"
+                                       % (current['lineno'], current['char'], len(current['rows'])))
+                    glyphs.append(current)
+                    current = None
+                elif stripped:
+                    current['rows'].append(parse_row(stripped, lineno))
+                continue
+            stripped = COMMENT.sub('', stripped)
+            if not stripped or stripped.startswith('#'):
+                continue
+            kind, _, rest = stripped.partition(' ')
+            args = rest.split()
+            if kind == 'charset':
+                if len(args) < 2 or not args[0].isidentifier():
+                    raise DefError("line %d: expected charset NAME FIRST-LAST [options]" % lineno)
+                try:
+                    first, last = (int(x, 16) for x in args[1].split('-'))
+                except ValueError:
+                    raise DefError("line %d: bad range %r" % (lineno, args[1]))
+                options = set(args[2:])
+                if options - {'fold', 'glyphs'}:
+                    raise DefError("line %d: unknown options %s" % (lineno, ' '.join(options)))
+                charsets.append({'name': args[0], 'first': first, 'last': last,
+                                 'fold': 'fold' in options, 'glyphs': 'glyphs' in options})
+            elif kind == 'translit':
+                tokens = QUOTED_OR_WORD.findall(rest)
+                if len(tokens) != 2:
+                    raise DefError("line %d: expected translit CHARS ASCII" % lineno)
+                chars, ascii_chars = (parse_chars(t, lineno) for t in tokens)
+                if len(chars) != len(ascii_chars) or any(ord(c) > 0x7E for c in ascii_chars):
+                    raise DefError("line %d: each character needs one ASCII replacement" % lineno)
+                translit.update(zip(chars, ascii_chars))
+            elif kind == 'alias':
+                if len(args) != 2 or not args[0].startswith('U+') or len(args[1]) != 1:
+                    raise DefError("line %d: expected alias U+XXXX CHAR" % lineno)
+                cp = int(args[0][2:], 16)
+                if cp < 0x100 or cp > 0xFFFF or ord(args[1]) > 0xFF:
+                    raise DefError("line %d: aliases map U+0100-U+FFFF to Latin-1" % lineno)
+                aliases[cp] = ord(args[1])
+            elif kind == 'glyph':
+                if len(args) != 1 or len(args[0]) != 1 or ord(args[0]) > 0xFF:
+                    raise DefError("line %d: expected glyph CHAR (Latin-1)" % lineno)
+                current = {'char': args[0], 'rows': [], 'lineno': lineno}
+            else:
+                raise DefError("line %d: unknown entry type %r" % (lineno, kind))
+    if current is not None:
+        raise DefError("line %d: glyph %s is missing 'end'" % (current['lineno'], current['char']))
+    if len(glyphs) > MAX_GLYPHS:
+        raise DefError("%d glyphs; at most %d fit in the UDCs" % (len(glyphs), MAX_GLYPHS))
+    return charsets, translit, aliases, glyphs
+
+
+QUOTED_OR_WORD = re.compile(r'"(?:[^"\\]|\\.)*"|\S+')
+
+
+def fallback(c, translit):
+    """ASCII stand-in for a Latin-1 character, or None."""
+    if c in translit:
+        return translit[c]
+    base = unicodedata.normalize('NFD', c)[0]
+    return base if base != c and ord(base) < 0x7F else None
+
+
+def build_table(cs, translit, glyph_chars):
+    def shown(code):
+        if cs['first'] <= code <= cs['last']:
+            return code
+        if cs['fold'] and ord('a') <= code <= ord('z'):
+            code -= ord('a') - ord('A')
+            if cs['first'] <= code <= cs['last']:
+                return code
+        return None
+
+    table = bytearray()
+    for cp in range(256):
+        c = chr(cp)
+        code = shown(cp)
+        if code is None and cs['glyphs'] and c in glyph_chars:
+            code = UDC_CODE + glyph_chars.index(c)
+        if code is None and cp >= 0xA0:
+            alt = fallback(c, translit)
+            if alt is not None:
+                code = shown(ord(alt))
+        if code is None:
+            code = UNKNOWN if cp == SUB or cp >= 0xA0 else ord(' ')
+        table.append(code)
+    return table
+
+
+def report(charsets, tables, glyphs, aliases):
+    lines = []
+    for cs in charsets:
+        table = tables[cs['name']]
+        direct = sum(1 for cp in range(256) if table[cp] == cp)
+        unknown = sum(1 for cp in range(0xA0, 256) if table[cp] == UNKNOWN)
+        lines.append("%-8s %3d direct, %3d Latin-1 unknown" % (cs['name'], direct, unknown))
+    lines.append("%d glyphs, %d aliases" % (len(glyphs), len(aliases)))
+    return lines
+
+
+def emit(charsets, tables, glyphs, aliases, source):
+    out = []
+    out.append("/* Generated by tools/mkcharset.py from %s -- do not edit. */" % source)
+    out.append("/*")
+    for line in report(charsets, tables, glyphs, aliases):
+        out.append(" *   " + line)
+    out.append(" */")
+    out.append("#pragma once")
+    out.append("")
+    out.append("#define CHARSET_GLYPH_COUNT %d" % len(glyphs))
+    out.append("#define CHARSET_ALIAS_COUNT %d" % len(aliases))
+    out.append("")
+    for cs in charsets:
+        out.append("/* %s: %02X-%02X%s%s */" % (cs['name'], cs['first'], cs['last'],
+                                                ", fold" if cs['fold'] else "",
+                                                ", glyphs" if cs['glyphs'] else ""))
+        out.append("static const uint8_t charset_%s[256] PROGMEM = {" % cs['name'])
+        out.append(c_bytes(tables[cs['name']], per_line=16))
+        out.append("};")
+        out.append("")
+    out.append("/* %s */" % ' '.join('U+%04X' % ord(g['char']) for g in glyphs))
+    out.append("static const char charset_glyphs[] PROGMEM = {")
+    out.append(c_bytes(pack_rows([r for g in glyphs for r in g['rows']])))
+    out.append("};")
+    out.append("")
+    out.append("static const struct charset_alias charset_aliases[] PROGMEM = {")
+    for cp in sorted(aliases):
+        out.append("  { 0x%04X, 0x%02X }," % (cp, aliases[cp]))
+    out.append("};")
+    out.append("")
+    return '\n'.join(out)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split('\n\n')[0].strip())
+    ap.add_argument('source')
+    ap.add_argument('-o', '--output', help="header to write")
+    ap.add_argument('--report', action='store_true', help="print a summary of the tables")
+    args = ap.parse_args()
+    try:
+        charsets, translit, aliases, glyphs = parse(args.source)
+    except (OSError, DefError) as e:
+        sys.exit("mkcharset: %s: %s" % (args.source, e))
+    glyph_chars = [g['char'] for g in glyphs]
+    tables = {cs['name']: build_table(cs, translit, glyph_chars) for cs in charsets}
+    if args.output:
+        with open(args.output, 'w', encoding='ascii') as f:
+            f.write(emit(charsets, tables, glyphs, aliases, args.source.rsplit('/', 1)[-1]))
+    if args.report:
+        print('\n'.join(report(charsets, tables, glyphs, aliases)))
+
+
+if __name__ == '__main__':
+    main()
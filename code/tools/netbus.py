@@ -0,0 +1,216 @@
+"""
+Host side of a ring of tester boards (see net.h).
+
+NetBus sends frames to the boards and sorts out what comes back around
+the ring: acknowledgements, identification replies, wrapped console
+frames, and the host's own broadcasts returning after every board has
+seen them. Unacknowledged unicast frames are retransmitted with a
+growing timeout; each board has at most one frame outstanding, but
+frames to different boards go out back to back without waiting.
+
+NodePort looks like tester.Port but talks to one board, so tester.py's
+console commands work unchanged over the ring ("tester.py --node").
+"""
+
+import random
+import time
+
+from tester import DISPLAY_TYPES, FrameError, crc8_ccitt
+
+SOF = 0xA6
+HOST = 0x00
+BROADCAST = 0xFF
+HEADER_LEN = 6
+MAX_PAYLOAD = 40
+
+ACK_STATUS = {0: 'ok', 1: 'unknown', 2: 'too long', 3: 'busy'}
+ACK_BUSY = 3             # taken, but the board's panel is behind (governor.h)
+TARGET_DISPLAY = 0
+TARGET_PANEL = 1
+PANEL_COLS = 32
+
+RETRIES = 6
+RETRY_TIMEOUT = 0.1      # seconds, doubled after every retry
+COMMIT_DELAY_US = 5000   # covers the forwarding time of ~40 boards
+DELAY_MAX_US = 32767     # NET_DELAY_MAX_US: boards cut longer delays to this
+QUIET_TIME = 0.05        # no more replies after this long
+
+
+class NetError(FrameError):
+    pass
+
+
+def frame(dst, src, seq, kind, payload=b''):
+    body = bytes([dst, src, seq, ord(kind), len(payload) & 0xFF, len(payload) >> 8]) + payload
+    return bytes([SOF]) + body + bytes([crc8_ccitt(body)])
+
+
+class NetBus:
+    def __init__(self, port):
+        self.port = port
+        self.buf = bytearray()
+        self.seq = {}            # next sequence number per board
+        self.pending = {}        # board -> [frame, seq, deadline, timeout, tries]
+        self.status = {}         # board -> status of its last ack
+        self.replies = {}        # board -> console bytes from 'r' frames
+        self.idents = {}         # board -> display type name
+        self.returned = []       # our broadcasts, back from the last board
+        self.busy = set()        # boards that asked for fewer frames at the last stage()
+
+    # --- receiving ---
+
+    def _frames(self, timeout):
+        """Yields (dst, src, seq, kind, payload) until nothing arrives for timeout."""
+        deadline = time.monotonic() + timeout
+        while True:
+            while True:
+                start = self.buf.find(SOF)
+                if start < 0:
+                    self.buf.clear()
+                    break
+                del self.buf[:start]
+                if len(self.buf) < 1 + HEADER_LEN:
+                    break
+                length = self.buf[5] | (self.buf[6] << 8)
+                if len(self.buf) < 1 + HEADER_LEN + length + 1:
+                    break
+                body = bytes(self.buf[1:1 + HEADER_LEN + length])
+                if crc8_ccitt(body) != self.buf[1 + HEADER_LEN + length]:
+                    # resynchronize on the next start byte
+                    del self.buf[0]
+                    continue
+                del self.buf[:1 + HEADER_LEN + length + 1]
+                yield body[0], body[1], body[2], chr(body[3]), body[HEADER_LEN:]
+                deadline = time.monotonic() + timeout
+            if time.monotonic() > deadline:
+                return
+            self.buf += self.port.read(256)
+
+    def _retransmit(self):
+        now = time.monotonic()
+        for node, p in self.pending.items():
+            if now < p[2]:
+                continue
+            if p[4] >= RETRIES:
+                raise NetError('board %d does not answer' % node)
+            p[3] *= 2
+            p[2] = now + p[3]
+            p[4] += 1
+            self.port.write(p[0])
+
+    def pump(self, timeout=0.01):
+        """Handles whatever arrives within timeout."""
+        for dst, src, seq, kind, payload in self._frames(timeout):
+            if dst == BROADCAST and src == HOST:
+                self.returned.append((kind, payload))
+            elif dst != HOST:
+                continue
+            elif kind == 'a':
+                p = self.pending.get(src)
+                if p and p[1] == seq:
+                    del self.pending[src]
+                    self.status[src] = payload[0] if payload else 0
+            elif kind == 'q' and len(payload) >= 2:
+                t = payload[1]
+                self.idents[payload[0]] = DISPLAY_TYPES[t] if t < len(DISPLAY_TYPES) else str(t)
+            elif kind == 'r':
+                self.replies.setdefault(src, bytearray()).extend(payload)
+        self._retransmit()
+
+    # --- sending ---
+
+    def send(self, node, kind, payload=b'', timeout=RETRY_TIMEOUT):
+        """Sends a unicast frame without waiting for its ack."""
+        while node in self.pending:
+            self.pump()
+        seq = self.seq.get(node, random.randrange(1, 256))
+        self.seq[node] = seq % 255 + 1
+        data = frame(node, HOST, seq, kind, payload)
+        self.pending[node] = [data, seq, time.monotonic() + timeout, timeout, 0]
+        self.port.write(data)
+
+    def wait(self):
+        """Waits for every outstanding ack."""
+        while self.pending:
+            self.pump()
+
+    def broadcast(self, kind, payload=b''):
+        """Sends a broadcast and returns its payload once it is back."""
+        # every broadcast can safely be repeated
+        data = frame(BROADCAST, HOST, random.randrange(256), kind, payload)
+        timeout = RETRY_TIMEOUT
+        for _ in range(RETRIES):
+            self.returned.clear()
+            self.port.write(data)
+            deadline = time.monotonic() + timeout
+            while time.monotonic() < deadline:
+                self.pump()
+                for k, p in self.returned:
+                    if k == kind:
+                        return p
+            timeout *= 2
+        raise NetError("broadcast '%s' did not come back around the ring" % kind)
+
+    # --- operations ---
+
+    def enumerate(self):
+        """Numbers the boards 1..n in ring order; returns n."""
+        self.seq.clear()
+        return self.broadcast('E', bytes([1]))[0] - 1
+
+    def leave(self):
+        self.broadcast('E', bytes([0]))
+
+    def identify(self):
+        """{board: display type} of every board on the ring."""
+        self.idents.clear()
+        self.broadcast('Q')
+        self.pump(QUIET_TIME)
+        return dict(sorted(self.idents.items()))
+
+    def stage(self, texts, target=TARGET_DISPLAY):
+        """Stages {board: text}; the frames go out together. Boards that are
+        still writing earlier frames are left in self.busy."""
+        self.status.clear()
+        for node, text in texts.items():
+            data = text.encode('latin-1', 'replace')
+            step = PANEL_COLS if target == TARGET_PANEL else MAX_PAYLOAD - 2
+            for pos in range(0, len(data), step):
+                self.send(node, 'W', bytes([target, pos]) + data[pos:pos + step])
+        self.wait()
+        self.busy = {n for n, s in self.status.items() if s == ACK_BUSY}
+        failed = {n: ACK_STATUS.get(s, s) for n, s in self.status.items()
+                  if s and s != ACK_BUSY}
+        if failed:
+            raise NetError('staging failed: %s' % failed)
+
+    def commit(self, delay_us=COMMIT_DELAY_US):
+        """Every board shows what it has staged, delay_us from now."""
+        delay_us = min(delay_us, DELAY_MAX_US)
+        self.broadcast('F', bytes([delay_us & 0xFF, delay_us >> 8]))
+
+    def sync(self, delay_us=COMMIT_DELAY_US):
+        """Every board resets its display delay_us from now, so they blink in phase."""
+        delay_us = min(delay_us, DELAY_MAX_US)
+        self.broadcast('Y', bytes([delay_us & 0xFF, delay_us >> 8]))
+
+
+class NodePort:
+    """A tester.Port for the console of one board on the ring."""
+
+    def __init__(self, bus, node):
+        self.bus = bus
+        self.node = node
+
+    def write(self, data):
+        for c in data:
+            # a slow command ('T') is only acknowledged once it is done
+            self.bus.send(self.node, 'K', bytes([c]), timeout=0.5)
+
+    def read(self, n):
+        self.bus.pump()
+        got = self.bus.replies.get(self.node, bytearray())
+        data = bytes(got[:n])
+        del got[:n]
+        return data
+
@@ -0,0 +1,238 @@
+#!/usr/bin/env python3
+"""
+Stands in for a ring of tester boards (see net.h) on a pseudo-terminal,
+for working on the host side without hardware.
+
+Each simulated board follows the firmware's rules: it keeps frames
+addressed to it, passes others on, acts on broadcasts and passes them
+on updated, and acknowledges unicast frames (once per sequence number).
+Console commands 'L', 'C', 'Y' and 'V' answer with an empty log, a
+snapshot of the display, the blink sync count (no clock) and the number of
+commits (nothing to govern: the display's digits are written at once); the
+others are only acknowledged. Every commit and blink sync is printed with the time each
+board would act on it, from the bytes on the wire, so the per-hop
+correction of the delay can be checked.
+
+Usage: netsim.py [--boards N] [--loss P] [--type TYPE]
+       then e.g. "tester.py /dev/pts/5 nodes" with the path it prints
+"""
+
+import argparse
+import os
+import random
+import struct
+import sys
+import time
+import tty
+
+from netbus import BROADCAST, HEADER_LEN, HOST, MAX_PAYLOAD, SOF, TARGET_DISPLAY, frame
+from tester import DISPLAY_TYPES, SOF as CONSOLE_SOF, crc8_ccitt
+
+US_PER_BYTE = 10
+HOP_EXTRA_US = 20           # NET_HOP_EXTRA_US
+DEFAULT_TYPE = 'HDSP2xxx'
+EIGHT_DIGIT_TYPES = ['DL1814', 'PD2816', 'HDSP2xxx']
+COMMANDS = b'LTtCPpBYV'
+
+
+def console_frame(ftype, payload):
+    body = bytes([ord(ftype), len(payload) & 0xFF, len(payload) >> 8]) + payload
+    return bytes([CONSOLE_SOF]) + body + bytes([crc8_ccitt(body)])
+
+
+class Board:
+    def __init__(self, index, dtype=DEFAULT_TYPE):
+        self.index = index
+        self.dtype = DISPLAY_TYPES.index(dtype)
+        self.digits = 8 if dtype in EIGHT_DIGIT_TYPES else 4
+        self.node_id = 0
+        self.last_seq = None
+        self.last_status = 0
+        self.chars = bytearray(b' ' * self.digits)
+        self.staged = {}
+        self.commit_delay = None
+        self.syncs = 0
+        self.synced_at = None
+        self.commits = 0
+
+    def handle(self, dst, src, seq, kind, payload):
+        """Returns the bytes this board sends on for one frame from upstream."""
+        out = b''
+        if dst == BROADCAST and len(payload) <= MAX_PAYLOAD:
+            if kind == 'E' and len(payload) == 1 and payload[0] != BROADCAST:
+                self.node_id = payload[0]
+                self.last_seq = None
+                payload = bytes([payload[0] + 1 if payload[0] else 0])
+            elif kind in 'FY' and len(payload) == 2:
+                delay = payload[0] | payload[1] << 8
+                hop = (1 + HEADER_LEN + 2 + 1) * US_PER_BYTE + HOP_EXTRA_US
+                self.commit_delay = delay
+                delay = max(delay - hop, 0)
+                payload = bytes([delay & 0xFF, delay >> 8])
+            elif kind == 'W':
+                self.stage(payload)
+            out = frame(dst, src, seq, kind, payload)
+            if kind == 'Q':
+                out += self.reply(seq, 'q', bytes([self.node_id, self.dtype]))
+            return out
+        if dst != self.node_id or dst == HOST:
+            return frame(dst, src, seq, kind, payload)
+        if kind == 'Q':
+            return self.reply(seq, 'q', bytes([self.node_id, self.dtype]))
+        if seq == self.last_seq:
+            return self.ack(seq, self.last_status)
+        self.last_seq = seq
+        if len(payload) > MAX_PAYLOAD:
+            return self.ack(seq, 2)
+        if kind == 'K':
+            if len(payload) != 1 or payload[0] not in COMMANDS:
+                return self.ack(seq, 1)
+            return self.command(seq, payload[0]) + self.ack(seq, 0)
+        if kind == 'W':
+            return self.ack(seq, self.stage(payload))
+        if kind == 'F' and len(payload) == 2:
+            self.commit_delay = payload[0] | payload[1] << 8
+            self.commit()
+            return self.ack(seq, 0)
+        return self.ack(seq, 1)
+
+    def reply(self, seq, kind, payload):
+        return frame(HOST, self.node_id, seq, kind, payload)
+
+    def ack(self, seq, status):
+        self.last_status = status
+        return self.reply(seq, 'a', bytes([status]))
+
+    def stage(self, payload):
+        if len(payload) < 2:
+            return 2
+        if payload[0] != TARGET_DISPLAY:
+            return 1
+        pos, text = payload[1], payload[2:]
+        if pos + len(text) > self.digits:
+            return 2
+        for i, c in enumerate(text):
+            self.staged[pos + i] = c
+        return 0
+
+    def commit(self):
+        self.commits += 1
+        for pos, c in self.staged.items():
+            self.chars[pos] = c
+        self.staged.clear()
+
+    def command(self, seq, c):
+        if c == ord('L'):
+            payload = struct.pack('<HHBB', 0, 0, 8, 0)
+        elif c == ord('C'):
+            payload = (bytes([1, self.dtype, 0, 1, self.digits, 0, 0, 0]) +
+                       bytes(self.chars) + bytes([0]))
+        elif c == ord('Y'):
+            since = int((time.monotonic() - self.synced_at) * 1000) if self.syncs else 0
+            payload = struct.pack('<HII', self.syncs, since, 0)
+        elif c == ord('V'):
+            payload = struct.pack('<8H', self.commits, 0, 0, 0, 0, 0, 0, 0)
+        else:
+            return b''
+        return self.reply(seq, 'r', console_frame(chr(c), payload))
+
+
+class Ring:
+    def __init__(self, n, dtype=DEFAULT_TYPE):
+        self.boards = [Board(i, dtype) for i in range(n)]
+        self.buf = bytearray()
+
+    def feed(self, data):
+        """Bytes from the host; returns the bytes that reach the host."""
+        self.buf += data
+        out = b''
+        while True:
+            start = self.buf.find(SOF)
+            if start < 0:
+                self.buf.clear()
+                return out
+            del self.buf[:start]
+            if len(self.buf) < 1 + HEADER_LEN:
+                return out
+            length = self.buf[5] | self.buf[6] << 8
+            if len(self.buf) < 1 + HEADER_LEN + length + 1:
+                return out
+            raw = bytes(self.buf[:1 + HEADER_LEN + length + 1])
+            del self.buf[:len(raw)]
+            if crc8_ccitt(raw[1:-1]) == raw[-1]:
+                out += self.around(raw)
+
+    def around(self, raw):
+        """Sends one frame from the host around the ring."""
+        frames = [raw]
+        commits = []
+        for board in self.boards:
+            passed = b''
+            for f in frames:
+                dst, src, seq, kind = f[1], f[2], f[3], chr(f[4])
+                board.commit_delay = None
+                passed += board.handle(dst, src, seq, kind, f[1 + HEADER_LEN:-1])
+                if kind in 'FY' and dst == BROADCAST and board.commit_delay is not None:
+                    commits.append((board, board.commit_delay))
+            frames = split(passed)
+        if commits:
+            self.report(commits, len(raw), chr(raw[4]))
+        return b''.join(frames)
+
+    def report(self, commits, frame_len, kind):
+        hop = frame_len * US_PER_BYTE + HOP_EXTRA_US
+        times = []
+        for i, (board, delay) in enumerate(commits):
+            if kind == 'Y':
+                board.syncs += 1
+                board.synced_at = time.monotonic()
+            else:
+                board.commit()
+            # received one store-and-forward hop after the previous board
+            times.append(frame_len * US_PER_BYTE + i * hop + delay)
+        if kind == 'Y':
+            shown = '%d boards' % len(commits)
+        else:
+            shown = ' '.join('%d:%s' % (b.node_id, bytes(b.chars).decode('latin-1'))
+                             for b, _ in commits)
+        print('%s at %s us (spread %d us): %s' % (
+            'sync' if kind == 'Y' else 'commit', '/'.join(str(t) for t in times),
+            max(times) - min(times), shown), flush=True)
+
+
+def split(data):
+    frames = []
+    while data:
+        length = data[5] | data[6] << 8
+        frames.append(data[:1 + HEADER_LEN + length + 1])
+        data = data[1 + HEADER_LEN + length + 1:]
+    return frames
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split('\n\n')[0].strip())
+    ap.add_argument('--boards', type=int, default=4)
+    ap.add_argument('--loss', type=float, default=0.0,
+                    help='probability that a frame from the host is lost')
+    ap.add_argument('--type', choices=DISPLAY_TYPES, default=DEFAULT_TYPE,
+                    help='display type the boards report')
+    args = ap.parse_args()
+    master, slave = os.openpty()
+    tty.setraw(slave)
+    print(os.ttyname(slave), flush=True)
+    ring = Ring(args.boards, args.type)
+    while True:
+        try:
+            data = os.read(master, 4096)
+        except OSError:
+            break
+        if args.loss and random.random() < args.loss:
+            print('dropped %d bytes' % len(data), file=sys.stderr, flush=True)
+            continue
+        out = ring.feed(data)
+        if out:
+            os.write(master, out)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,261 @@
+#!/usr/bin/env python3
+"""
+Packs the tester's PROGMEM messages, glyph tables and UDC animation strips.
+
+Reads messages.def and writes messages.h, which is included by main.c.
+The formats are decoded at runtime by the packed-text and packed-glyph
+routines in display.c; keep the two in sync.
+
+Packed text
+  byte 0     bits 0-5: number of characters (1-63)
+             bit 7: attribute runs follow
+  [byte 1]   number of attribute runs
+  [runs]     one byte per run: high nibble = characters to skip,
+             low nibble = characters that get the attribute bit (0x80)
+  codes      6-bit codes, packed LSB-first, 4 codes per 3 bytes.
+             Code c < 63 is the character c+0x20 (' '..'^'). Code 63 is an
+             escape: the next code c is the character c+0x5F ('_'..0x9E),
+             which covers lowercase and the HDSP-2xxx UDC range 0x80-0x8F.
+
+Packed glyph rows
+  5 bits per row, packed LSB-first into a continuous bit stream, followed
+  by one pad byte so the decoder can always fetch 16 bits. A glyph table is
+  a strip with a glyph every 7 rows; an animation strip is shown through a
+  sliding 7-row window, so each frame costs nothing beyond its new row.
+
+Usage: packmsg.py messages.def [-o messages.h] [--report]
+"""
+
+import argparse
+import ast
+import re
+import sys
+
+TEXT_MAX_LEN = 63
+TEXT_HAS_ATTRS = 0x80
+ATTR_BIT = 0x80
+CODE_ESCAPE = 63
+DIRECT_BASE = 0x20
+ESCAPE_BASE = 0x5F
+GLYPH_WIDTH = 5
+GLYPH_HEIGHT = 7
+QUOTED = re.compile(r'"(?:[^"\\]|\\.)*"')
+
+
+class DefError(Exception):
+    pass
+
+
+class BitWriter:
+    def __init__(self):
+        self.out = bytearray()
+        self.acc = 0
+        self.nbits = 0
+
+    def put(self, value, width):
+        self.acc |= value << self.nbits
+        self.nbits += width
+        while self.nbits >= 8:
+            self.out.append(self.acc & 0xFF)
+            self.acc >>= 8
+            self.nbits -= 8
+
+    def flush(self):
+        if self.nbits:
+            self.out.append(self.acc & 0xFF)
+            self.acc = 0
+            self.nbits = 0
+        return bytes(self.out)
+
+
+def text_codes(text, lineno):
+    codes = []
+    for ch in text:
+        c = ord(ch)
+        if DIRECT_BASE <= c < DIRECT_BASE + CODE_ESCAPE:
+            codes.append(c - DIRECT_BASE)
+        elif ESCAPE_BASE <= c < ESCAPE_BASE + 64:
+            codes += [CODE_ESCAPE, c - ESCAPE_BASE]
+        else:
+            raise DefError("line %d: character 0x%02x cannot be packed" % (lineno, c))
+    return codes
+
+
+def attr_runs(mask):
+    """Run-length encodes an attribute mask as (skip, count) nibble pairs."""
+    runs = []
+    skip = 0
+    i = 0
+    while i < len(mask):
+        if not mask[i]:
+            skip += 1
+            i += 1
+            continue
+        count = 0
+        while i < len(mask) and mask[i]:
+            count += 1
+            i += 1
+        while skip > 15:
+            runs.append((15, 0))
+            skip -= 15
+        while count > 15:
+            runs.append((skip, 15))
+            skip = 0
+            count -= 15
+        runs.append((skip, count))
+        skip = 0
+    return runs
+
+
+def pack_text(text, mask, lineno):
+    if not 1 <= len(text) <= TEXT_MAX_LEN:
+        raise DefError("line %d: text must be 1-%d characters" % (lineno, TEXT_MAX_LEN))
+    if mask is not None and len(mask) != len(text):
+        raise DefError("line %d: attribute mask length differs from text" % lineno)
+    runs = attr_runs([c != ' ' for c in mask]) if mask else []
+    out = bytearray([len(text) | (TEXT_HAS_ATTRS if runs else 0)])
+    if runs:
+        out.append(len(runs))
+        out += bytes((skip << 4) | count for skip, count in runs)
+    bits = BitWriter()
+    for code in text_codes(text, lineno):
+        bits.put(code, 6)
+    out += bits.flush()
+    raw = text.encode('latin-1')
+    raw = bytes((c | ATTR_BIT) if mask and mask[i] != ' ' else c for i, c in enumerate(raw))
+    return bytes(out), raw + b'\0'
+
+
+def pack_rows(rows):
+    bits = BitWriter()
+    for row in rows:
+        bits.put(row, GLYPH_WIDTH)
+    return bits.flush() + b'\0'
+
+
+def parse_row(line, lineno):
+    if len(line) != GLYPH_WIDTH or any(c not in '#.' for c in line):
+        raise DefError("line %d: glyph rows are %d characters of '#' or '.'" % (lineno, GLYPH_WIDTH))
+    value = 0
+    for c in line:
+        value = (value << 1) | (c == '#')
+    return value
+
+
+def parse(path):
+    entries = []
+    current = None
+    with open(path, encoding='utf-8') as f:
+        for lineno, line in enumerate(f, 1):
+            line = line.rstrip('\n')
+            stripped = line.strip()
+            if current is not None:
+                if stripped == 'end':
+                    entries.append(current)
+                    current = None
+                elif stripped:
+                    current['rows'].append(parse_row(stripped, lineno))
+                continue
+            if not stripped or stripped.startswith('#'):
+                continue
+            kind, _, rest = stripped.partition(' ')
+            name, _, args = rest.strip().partition(' ')
+            if not name.isidentifier():
+                raise DefError("line %d: bad name %r" % (lineno, name))
+            if kind == 'text':
+                tokens = QUOTED.findall(args)
+                if QUOTED.sub('', args).strip():
+                    raise DefError("line %d: expected quoted text" % lineno)
+                strings = [ast.literal_eval(t) for t in tokens]
+                if not 1 <= len(strings) <= 2:
+                    raise DefError("line %d: expected text and optional attribute mask" % lineno)
+                mask = strings[1] if len(strings) == 2 else None
+                packed, raw = pack_text(strings[0], mask, lineno)
+                entries.append({'kind': kind, 'name': name, 'packed': packed, 'raw': raw,
+                                'text': strings[0]})
+            elif kind in ('glyphs', 'strip'):
+                current = {'kind': kind, 'name': name, 'rows': [], 'lineno': lineno}
+            else:
+                raise DefError("line %d: unknown entry type %r" % (lineno, kind))
+    if current is not None:
+        raise DefError("line %d: %s is missing 'end'" % (current['lineno'], current['name']))
+    for e in entries:
+        if e['kind'] == 'text':
+            continue
+        nrows = len(e['rows'])
+        if nrows < GLYPH_HEIGHT or (e['kind'] == 'glyphs' and nrows % GLYPH_HEIGHT):
+            raise DefError("line %d: %s has %d rows" % (e['lineno'], e['name'], nrows))
+        e['packed'] = pack_rows(e['rows'])
+        e['raw'] = bytes(e['rows'])
+    return entries
+
+
+def report(entries):
+    lines = []
+    totals = {}
+    for e in entries:
+        t = totals.setdefault(e['kind'], [0, 0, 0])
+        t[0] += 1
+        t[1] += len(e['raw'])
+        t[2] += len(e['packed'])
+    lines.append("%-8s %5s %8s %8s" % ("kind", "count", "raw", "packed"))
+    raw_total = packed_total = 0
+    for kind in ('text', 'glyphs', 'strip'):
+        if kind in totals:
+            n, raw, packed = totals[kind]
+            raw_total += raw
+            packed_total += packed
+            lines.append("%-8s %5d %8d %8d" % (kind, n, raw, packed))
+    lines.append("%-8s %5s %8d %8d" % ("total", "", raw_total, packed_total))
+    return lines
+
+
+def c_bytes(data, indent='  ', per_line=12):
+    out = []
+    for i in range(0, len(data), per_line):
+        out.append(indent + ', '.join('0x%02X' % b for b in data[i:i + per_line]) + ',')
+    return '\n'.join(out)
+
+
+def emit(entries, source):
+    out = []
+    out.append("/* Generated by tools/packmsg.py from %s -- do not edit. */" % source)
+    out.append("/*")
+    out.append(" * Flash usage in bytes (raw = unpacked 8-bit PROGMEM equivalent):")
+    for line in report(entries):
+        out.append(" *   " + line)
+    out.append(" */")
+    out.append("#pragma once")
+    out.append("")
+    for e in entries:
+        if e['kind'] == 'text':
+            out.append("/* %s */" % ''.join(c if 0x20 <= ord(c) < 0x7F else '\\x%02x' % ord(c)
+                                           for c in e['text']).replace('*/', '*\\/'))
+        else:
+            out.append("#define %s_ROWS %d" % (e['name'].upper(), len(e['rows'])))
+        out.append("static const char %s[] PROGMEM = {" % e['name'])
+        out.append(c_bytes(e['packed']))
+        out.append("};")
+        out.append("")
+    return '\n'.join(out)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split('\n\n')[0].strip())
+    ap.add_argument('source')
+    ap.add_argument('-o', '--output', help="header to write")
+    ap.add_argument('--report', action='store_true', help="print the flash usage report")
+    args = ap.parse_args()
+    try:
+        entries = parse(args.source)
+    except (OSError, DefError) as e:
+        sys.exit("packmsg: %s: %s" % (args.source, e))
+    if args.output:
+        with open(args.output, 'w', encoding='ascii') as f:
+            f.write(emit(entries, args.source.rsplit('/', 1)[-1]))
+    if args.report:
+        print('\n'.join(report(entries)))
+
+
+if __name__ == '__main__':
+    main()
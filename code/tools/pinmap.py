@@ -0,0 +1,325 @@
+#!/usr/bin/env python3
+"""
+Checks the firmware's pin assignments (pins.h) against the schematic.
+
+Reads the tester's netlist (alphadisplays.net), follows each signal from
+its net to a pin of the microcontroller, and writes pins_net.h: the
+netlist's port and pin for every signal in pins.h, with a preprocessor
+check that fails the build when pins.h says otherwise. Ports driven as a
+whole are checked bit by bit here (DATA_PORT bit n must be Dn; the
+ADDRESS_PORT bits must match ADDR_* in display.h, which the header checks
+too). The panel select lines and the serial port, which is wired by hand
+to USART1's alternate pins, must be on pins the board leaves free; the
+reset pin (PF6/~RESET) is never free.
+
+With --panel, the panel board (pdsp1881_4x4.kicad_pcb) is checked as
+well: its two 74AHC138s must decode select code S3..S0 = row*4 + column
+to the chip at that position, as panel.c assumes.
+
+Usage: pinmap.py NETLIST [--panel BOARD] [-o pins_net.h] [--list]
+"""
+
+import argparse
+import re
+import sys
+import time
+
+from sexpr import Document, SexprError
+
+MCU_REF = 'U1'
+
+# pins.h name -> net, or "via REF": the net that reaches part REF through
+# a two-pin part in series (the LED's resistor)
+SIGNALS = [
+    ('LED', 'via D9'),
+    ('nWR', '/~WR'),
+    ('nCE', '/~CE'),
+    ('nCLR', '/~CLR'),
+    ('nRD', '/~RD'),
+    ('CUE', '/CUE'),
+    ('nBL', '/~BL'),
+    ('nSW1', '/~SW1'),
+    ('nSW2', '/~SW2'),
+    ('HDSPCLK', '/HDSPCLK'),
+    ('PD2816CLK', '/PD2816CLK'),
+]
+
+# ports written as a whole: pins.h name -> nets by bit
+DATA_BITS = ['/D%d' % n for n in range(8)]
+# display.h ADDR_* name -> net
+ADDRESS_BITS = [('ADDR_A0', '/A0'), ('ADDR_A1', '/A1'), ('ADDR_A2', '/A2'),
+                ('ADDR_A3', '/A3'), ('ADDR_A4', '/A4'), ('ADDR_FL', '/~FL')]
+
+# USART1's alternate pins (PORTMUX ALT1), fixed by the chip: pins.h name
+# -> MCU pin name. The board doesn't connect them.
+UART_PINS = [('TXD', 'PC4'), ('RXD', 'PC5')]
+
+PORTS = 'ABCDEF'
+
+# 74x138 pins: select inputs A, B, C; enables ~E1, ~E2, E3; outputs ~Y0-~Y7
+DECODER_SELECT = ['1', '2', '3']
+DECODER_ENABLE_LOW = ['4', '5']
+DECODER_ENABLE_HIGH = '6'
+DECODER_OUTPUTS = ['15', '14', '13', '12', '11', '10', '9', '7']
+PANEL_SELECT = ['/S0', '/S1', '/S2', '/S3']
+PANEL_CHIPS_PER_ROW = 4
+
+
+class PinmapError(Exception):
+    pass
+
+
+class Netlist:
+    """Nets and the MCU's pin names from a KiCad netlist."""
+
+    def __init__(self, path, mcu=MCU_REF):
+        root = Document(path).root
+        comp = next((c for c in root.find('components').lists('comp')
+                     if c.value('ref') == mcu), None)
+        if comp is None:
+            raise PinmapError('no component %s' % mcu)
+        part = comp.find('libsource').value('part')
+        self.mcu = mcu
+        self.part = part
+        self.pin_names = {}
+        for lp in root.find('libparts').lists('libpart'):
+            aliases = lp.find('aliases')
+            names = [lp.value('part')] + ([a[1] for a in aliases.lists('alias')]
+                                          if aliases else [])
+            if part in names:
+                self.pin_names = {p.value('num'): p.value('name')
+                                  for p in lp.find('pins').lists('pin')}
+                break
+        if not self.pin_names:
+            raise PinmapError('no pin names for %s (%s)' % (mcu, part))
+        self.nets = {}
+        for net in root.find('nets').lists('net'):
+            self.nets[net.value('name')] = [(n.value('ref'), n.value('pin'))
+                                            for n in net.lists('node')]
+
+    def port_pins(self, net):
+        """(port, bit) of every MCU pin on a net."""
+        found = []
+        for ref, pin in self.nets.get(net, []):
+            m = re.match(r'P([A-F])([0-7])', self.pin_names.get(pin, '')) if ref == self.mcu else None
+            if m:
+                found.append((m.group(1), int(m.group(2))))
+        return found
+
+    def via(self, ref):
+        """Nets that reach part ref through a two-pin part in series (a net
+        joining only that part and ref)."""
+        nets = []
+        for link, nodes in self.nets.items():
+            parts = {r for r, _ in nodes}
+            if len(nodes) != 2 or ref not in parts:
+                continue
+            other = (parts - {ref}).pop()
+            ends = [n for n, ns in self.nets.items() if any(r == other for r, _ in ns)]
+            if len(ends) == 2:
+                nets.append(ends[1 - ends.index(link)])
+        return nets
+
+    def signal(self, name, net):
+        """(port, bit, description) of a pins.h signal."""
+        candidates = self.via(net[4:]) if net.startswith('via ') else [net]
+        pins = [pp for n in candidates for pp in self.port_pins(n)]
+        if len(pins) != 1:
+            raise PinmapError('%s (%s) is on %d microcontroller pins' % (name, net, len(pins)))
+        return pins[0]
+
+    def free_pins(self):
+        """Ports' pins that are on no net, or only on their own."""
+        used = {}
+        for nodes in self.nets.values():
+            if len(nodes) < 2:
+                continue
+            for ref, pin in nodes:
+                m = re.match(r'P([A-F])([0-7])', self.pin_names.get(pin, ''))
+                if ref == self.mcu and m:
+                    used[m.group(1)] = used.get(m.group(1), 0) | 1 << int(m.group(2))
+        present = {}
+        for name in self.pin_names.values():
+            # a pin with another function in its name (PF6/~RESET) isn't GPIO
+            m = re.fullmatch(r'P([A-F])([0-7])', name)
+            if m:
+                present[m.group(1)] = present.get(m.group(1), 0) | 1 << int(m.group(2))
+        return {p: present.get(p, 0) & ~used.get(p, 0) for p in PORTS}
+
+    def uart_pin(self, name, pin_name, free):
+        """(port, bit, pin number) of a serial port pin, which must be free."""
+        num = next((n for n, pn in self.pin_names.items() if pn == pin_name), None)
+        if num is None:
+            raise PinmapError('%s: %s has no pin %s' % (name, self.part, pin_name))
+        port, bit = pin_name[1], int(pin_name[2])
+        if not free[port] & 1 << bit:
+            raise PinmapError('%s: %s (pin %s) is connected on the board' % (name, pin_name, num))
+        return port, bit, num
+
+
+def whole_port(netlist, what, nets):
+    """The one port that carries all of nets; bit n of it must be nets[n]."""
+    pins = []
+    for net in nets:
+        pp = netlist.port_pins(net)
+        if len(pp) != 1:
+            raise PinmapError('%s line %s is on %d microcontroller pins' % (what, net, len(pp)))
+        pins.append(pp[0])
+    if len({p for p, _ in pins}) != 1:
+        raise PinmapError('%s lines are split across ports %s' % (
+            what, ', '.join(sorted({p for p, _ in pins}))))
+    return pins[0][0], [b for _, b in pins]
+
+
+def check_panel(path):
+    """Select code -> chip reference, checked against the chips' positions."""
+    modules = {}
+    for m in Document(path).root.lists('module'):
+        ref = m.find('fp_text', 'reference')[2]
+        at = m.find('at')
+        pads = {}
+        for pad in m.lists('pad'):
+            net = pad.find('net')
+            if net is not None:
+                pads[pad[1]] = net[2]
+        modules[ref] = (float(at[1]), float(at[2]), pads)
+    code_to_net = {}
+    decoders = set()
+    for ref, (_, _, pads) in modules.items():
+        if [pads.get(p) for p in DECODER_SELECT] != PANEL_SELECT[:3]:
+            continue
+        decoders.add(ref)
+        if pads.get(DECODER_ENABLE_HIGH) == PANEL_SELECT[3]:
+            high = 8
+        elif PANEL_SELECT[3] in (pads.get(p) for p in DECODER_ENABLE_LOW):
+            high = 0
+        else:
+            raise PinmapError('%s: decoder %s is not enabled by %s' % (path, ref, PANEL_SELECT[3]))
+        for y, pin in enumerate(DECODER_OUTPUTS):
+            code_to_net[high + y] = pads.get(pin)
+    enables = set(code_to_net.values()) - {None}
+    # row-major by position: top to bottom, then left to right
+    chips = sorted((r for r, (_, _, pads) in modules.items()
+                    if r not in decoders and enables & set(pads.values())),
+                   key=lambda r: (modules[r][1], modules[r][0]))
+    if len(code_to_net) != 16 or len(chips) != 16:
+        raise PinmapError('%s: found %d decoded selects and %d chips, expected 16' % (
+            path, len(code_to_net), len(chips)))
+    table = {}
+    for code in range(16):
+        chip = chips[code]
+        if code_to_net[code] not in modules[chip][2].values():
+            actual = next(c for c in chips if code_to_net[code] in modules[c][2].values())
+            raise PinmapError('%s: select code %d enables %s, but panel.c expects %s '
+                              '(row %d, column %d)' % (path, code, actual, chip,
+                                                       code // PANEL_CHIPS_PER_ROW,
+                                                       code % PANEL_CHIPS_PER_ROW))
+        table[code] = chip
+    return table
+
+
+def emit(netlist, signals, uart, data, address, free, panel, source, panel_source):
+    out = ['/* Generated by tools/pinmap.py from %s -- do not edit. */' % source,
+           '/*',
+           ' * The tester board as wired in the schematic (%s, %s). Including this' % (
+               netlist.mcu, netlist.part),
+           ' * stops the build if pins.h or display.h disagree with it.']
+    if panel:
+        out.append(' * %s: select code S3..S0 = row*4 + column (checked).' % panel_source)
+    out += [' */', '#pragma once', '', '#include "pins.h"', '#include "display.h"', '']
+    for i, p in enumerate(PORTS):
+        out.append('#define NET_PORT_%s %d' % (p, i))
+    out += ['#define NET_PORT_(p) NET_PORT_##p',
+            '#define NET_PORT(p)  NET_PORT_(p)',
+            '']
+    for name, net, (port, bit) in signals:
+        out += ['/* %s */' % net,
+                '#define NET_%s_PORT %s' % (name, port),
+                '#define NET_%s_PIN  %d' % (name, bit),
+                '#if NET_PORT(%s_PORT) != NET_PORT_%s || %s_PIN != %d' % (name, port, name, bit),
+                '#error "pins.h: %s should be P%s%d (%s in %s)"' % (name, port, bit, net, source),
+                '#endif',
+                '']
+    for name, (port, bit, num) in uart:
+        out += ['/* USART1 %s, pin %s (wired by hand) */' % (name, num),
+                '#define NET_%s_PORT %s' % (name, port),
+                '#define NET_%s_PIN  %d' % (name, bit),
+                '#if NET_PORT(%s_PORT) != NET_PORT_%s || %s_PIN != %d' % (name, port, name, bit),
+                '#error "pins.h: %s should be P%s%d (USART1 alternate pin %s)"' % (
+                    name, port, bit, num),
+                '#endif',
+                '']
+    out += ['/* /D0-/D7 on bits 0-7 */',
+            '#define NET_DATA_PORT %s' % data,
+            '#if NET_PORT(DATA_PORT) != NET_PORT_%s' % data,
+            '#error "pins.h: DATA_PORT should be %s"' % data,
+            '#endif',
+            '',
+            '#define NET_ADDRESS_PORT %s' % address[0],
+            '#if NET_PORT(ADDRESS_PORT) != NET_PORT_%s' % address[0],
+            '#error "pins.h: ADDRESS_PORT should be %s"' % address[0],
+            '#endif']
+    for (name, net), bit in zip(ADDRESS_BITS, address[1]):
+        out += ['#if %s != %d' % (name, bit),
+                '#error "display.h: %s should be %d (%s)"' % (name, bit, net),
+                '#endif']
+    out += ['',
+            '/* pins not connected on the board (the panel select lines go here) */']
+    for p in PORTS:
+        out.append('#define NET_FREE_%s 0b%s' % (p, format(free[p], '08b')))
+    out += ['#define NET_FREE_(p) NET_FREE_##p',
+            '#define NET_FREE(p)  NET_FREE_(p)',
+            '#if PANEL_SEL_MASK & ~NET_FREE(PANEL_SEL_PORT)',
+            '#error "pins.h: PANEL_SEL_MASK uses pins that are connected on the board"',
+            '#endif']
+    for name, _ in uart:
+        out += ['#if (1 << %s_PIN) & ~NET_FREE(%s_PORT)' % (name, name),
+                '#error "pins.h: %s is on a pin that is connected on the board"' % name,
+                '#endif']
+    out.append('')
+    return '\n'.join(out)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split('\n\n')[0].strip())
+    ap.add_argument('netlist')
+    ap.add_argument('--panel', help='panel board (.kicad_pcb) to check')
+    ap.add_argument('-o', '--output', help='header to write')
+    ap.add_argument('--list', action='store_true', help='print the pin map and timings')
+    args = ap.parse_args()
+    t0 = time.perf_counter()
+    try:
+        netlist = Netlist(args.netlist)
+        signals = [(name, net, netlist.signal(name, net)) for name, net in SIGNALS]
+        data, bits = whole_port(netlist, 'data', DATA_BITS)
+        if bits != list(range(8)):
+            raise PinmapError('data lines are not D0-D7 on bits 0-7 of port %s' % data)
+        address = whole_port(netlist, 'address', [net for _, net in ADDRESS_BITS])
+        free = netlist.free_pins()
+        uart = [(name, netlist.uart_pin(name, pin, free)) for name, pin in UART_PINS]
+        t1 = time.perf_counter()
+        panel = check_panel(args.panel) if args.panel else None
+        t2 = time.perf_counter()
+    except (OSError, SexprError, PinmapError) as e:
+        sys.exit('pinmap: %s' % e)
+    if args.output:
+        with open(args.output, 'w', encoding='ascii') as f:
+            f.write(emit(netlist, signals, uart, data, address, free, panel,
+                         args.netlist.rsplit('/', 1)[-1],
+                         args.panel and args.panel.rsplit('/', 1)[-1]))
+    if args.list:
+        for name, net, (port, bit) in signals:
+            print('%-10s P%s%d  %s' % (name, port, bit, net))
+        for name, (port, bit, num) in uart:
+            print('%-10s P%s%d  pin %s (free)' % (name, port, bit, num))
+        print('%-10s port %s' % ('DATA', data))
+        print('%-10s port %s, bits %s' % ('ADDRESS', address[0], address[1]))
+        print('free       %s' % ' '.join('P%s:%s' % (p, format(m, '08b')) for p, m in free.items()))
+        if panel:
+            print('panel      %s' % ' '.join('%d:%s' % kv for kv in panel.items()))
+        print('netlist %.1f ms%s' % ((t1 - t0) * 1e3,
+                                     ', panel board %.1f ms' % ((t2 - t1) * 1e3) if panel else ''))
+
+
+if __name__ == '__main__':
+    main()
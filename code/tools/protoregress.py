@@ -0,0 +1,296 @@
+#!/usr/bin/env python3
+"""
+Runs a regression matrix of the host tools and the ring protocol against
+models of the boards, in parallel, and compares every cell against its
+golden file.
+
+No firmware runs here. The boards are Python models of net.c, display.c
+and resultlog.c (netsim.py's Board, with CellBoard below), kept in step
+with the firmware by hand. What the matrix guards is the host side:
+tester.py's frame handling, netbus.py's ring protocol, the snapshot
+renderer and the log format, against the protocol as the models speak
+it. A firmware regression only shows up here if the models are changed
+to match it; test the firmware itself on a board.
+
+The matrix is every display type x both a0_a1_not_swapped settings x the
+fault scenarios in FAULTS. Each cell is one isolated session in a worker
+process: a two-board ring simulated as in netsim.py, driven through the
+real host code (netbus.NetBus, tester.FrameReader, snapshot rendering).
+The boards numbered, identified, sent a text each and committed, then
+captured and their logs read. What a cell records is
+  - the trace: every frame on the wire, in both directions, the bus
+    cycles (address, data) each board would run for the characters it
+    shows, and the commit timing netsim reports
+  - the frames: the rendered snapshot of each board and its result log
+and this has to match golden/CELL.txt byte for byte.
+
+Faults are injected into the simulated part:
+  stuck-data  data bit 5 is stuck low; parts that can be read back show
+              (and log) what they really hold, the rest what was written
+  self-test   the HDSP-2xxx self-test fails (other types log a pass)
+  readback    digit 0 reads back with bit 0 flipped (readable parts only)
+a0_a1_not_swapped selects a rev 2 board; with it clear, the bus is wired
+as on rev 1 and the firmware's address fix-up (fixAddress() in display.c)
+shows up in the bus cycles, while the characters shown must not change.
+
+A change to the protocol or to what the boards report has to be made in
+the models here and in netsim.py as well as in the firmware.
+
+Cells go into one queue shared by all workers, so a worker that finishes
+early takes the next cell; the summary gives each cell's time and the
+total wall time against the sum of cell times.
+
+Usage: protoregress.py [--jobs N] [--update] [--golden DIR] [CELL...]
+       (CELL is a name or shell pattern, e.g. 'HDSP2xxx-*')
+"""
+
+import argparse
+import concurrent.futures
+import contextlib
+import difflib
+import fnmatch
+import itertools
+import os
+import random
+import struct
+import sys
+import time
+
+from netbus import NetBus, NodePort
+from netsim import EIGHT_DIGIT_TYPES, Board, Ring, console_frame
+from tester import DISPLAY_TYPES, RESULT_ENTRY, FrameError, FrameReader, crc8_ccitt, result_csv
+import snapshot
+
+GOLDEN_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'golden')
+FAULTS = ['none', 'stuck-data', 'self-test', 'readback']
+# has_read in DISPLAYS[] (display.c)
+READABLE_TYPES = ['PD2816', 'HDSP2xxx']
+# left_to_right_digit_numbering
+LEFT_TO_RIGHT_TYPES = ['HDSP2xxx']
+BOARDS = 2
+TEXTS = {1: 'Hello 42', 2: 'ring OK!'}
+
+CHAR_ADDRESS = 0b00111000   # ~FL, A4 and A3 high (charAddress())
+STUCK_LOW = 0x20
+READBACK_FLIP = 0x01
+SELFTEST_UNITS = 6          # a passing self-test, 50ms units
+# enum result_test
+RESULT_PASS, RESULT_READBACK_DATA, RESULT_SELFTEST = 0, 1, 3
+
+
+def swap_a0_a1(addr):
+    return (addr & ~0b11) | (addr & 1) << 1 | (addr & 2) >> 1
+
+
+class CellBoard(Board):
+    """A netsim board with the cell's wiring and fault."""
+
+    def __init__(self, index, dtype, not_swapped, fault, trace):
+        super().__init__(index, dtype)
+        self.name = dtype
+        self.not_swapped = not_swapped
+        self.fault = fault
+        self.trace = trace
+        self.held = bytearray(self.chars)    # what the part really holds
+
+    def address(self, pos):
+        if self.name not in LEFT_TO_RIGHT_TYPES:
+            pos = self.digits - 1 - pos
+        addr = pos | CHAR_ADDRESS
+        return addr if self.not_swapped else swap_a0_a1(addr)
+
+    def position(self, addr):
+        """Digit a bus address reaches, through the board's wiring."""
+        if not self.not_swapped:
+            addr = swap_a0_a1(addr)
+        pos = addr & (self.digits - 1)
+        return pos if self.name in LEFT_TO_RIGHT_TYPES else self.digits - 1 - pos
+
+    def commit(self):
+        for pos, c in sorted(self.staged.items()):
+            addr = self.address(pos)
+            self.trace.append('bus %d %02x %02x' % (self.index + 1, addr, c))
+            self.chars[pos] = c
+            if self.fault == 'stuck-data':
+                c &= ~STUCK_LOW
+            self.held[self.position(addr)] = c
+        self.staged.clear()
+
+    def readable(self):
+        return self.name in READABLE_TYPES
+
+    def read_chars(self):
+        chars = bytearray(self.held)
+        if self.fault == 'readback':
+            chars[0] ^= READBACK_FLIP
+        return chars
+
+    def result(self):
+        test, addr, bits = RESULT_PASS, 0, 0
+        if self.readable():
+            bad = [(pos, a ^ b) for pos, (a, b) in
+                   enumerate(zip(self.chars, self.read_chars())) if a != b]
+            if bad:
+                test, (addr, bits) = RESULT_READBACK_DATA, bad[0]
+        selftest = 0
+        if self.name == 'HDSP2xxx':
+            selftest = SELFTEST_UNITS
+            if self.fault == 'self-test' and test == RESULT_PASS:
+                test = RESULT_SELFTEST
+        entry = RESULT_ENTRY.pack(0, self.dtype, test, addr, bits, selftest, 0, 0)
+        return entry[:-1] + bytes([crc8_ccitt(entry[:-1])])
+
+    def command(self, seq, c):
+        if c == ord('L'):
+            entry = self.result()
+            failed = entry[2] != RESULT_PASS
+            payload = struct.pack('<HHBB', 1, failed, len(entry), 1) + entry
+        elif c == ord('C'):
+            readback = self.readable()
+            chars = self.read_chars() if readback else self.chars
+            payload = (bytes([snapshot.VERSION, self.dtype,
+                              snapshot.FLAG_READBACK if readback else 0,
+                              1, self.digits, 0, 0, 0]) + bytes(chars) + bytes([0]))
+        else:
+            return b''
+        return self.reply(seq, 'r', console_frame(chr(c), payload))
+
+
+class TraceLines:
+    """Collects what netsim prints (commit timing) into the trace, in order."""
+
+    def __init__(self, trace):
+        self.trace = trace
+        self.partial = ''
+
+    def write(self, s):
+        lines = (self.partial + s).split('\n')
+        self.partial = lines.pop()
+        self.trace += lines
+
+    def flush(self):
+        pass
+
+
+class LoopPort:
+    """A tester.Port wired straight to a simulated ring, recording the wire."""
+
+    def __init__(self, ring, trace):
+        self.ring = ring
+        self.trace = trace
+        self.rx = bytearray()
+
+    def write(self, data):
+        self.trace.append('> ' + data.hex())
+        out = self.ring.feed(data)
+        if out:
+            self.trace.append('< ' + out.hex())
+            self.rx += out
+
+    def read(self, n):
+        data = bytes(self.rx[:n])
+        del self.rx[:n]
+        return data
+
+
+def cell_name(dtype, not_swapped, fault):
+    return '%s-%s-%s' % (dtype, 'rev2' if not_swapped else 'rev1', fault)
+
+
+def all_cells():
+    return [(cell_name(*c), c) for c in
+            itertools.product(DISPLAY_TYPES, (False, True), FAULTS)]
+
+
+def run_cell(name, dtype, not_swapped, fault):
+    """One session; returns (name, output, seconds)."""
+    start = time.monotonic()
+    random.seed(name)
+    trace = []
+    ring = Ring(0)
+    ring.boards = [CellBoard(i, dtype, not_swapped, fault, trace) for i in range(BOARDS)]
+    bus = NetBus(LoopPort(ring, trace))
+    frames = []
+    digits = 8 if dtype in EIGHT_DIGIT_TYPES else 4
+    font = snapshot.default_font()
+    try:
+        with contextlib.redirect_stdout(TraceLines(trace)):
+            frames.append('boards %d: %s' % (bus.enumerate(), ' '.join(
+                '%d=%s' % i for i in bus.identify().items())))
+            bus.stage({node: text[:digits] for node, text in TEXTS.items()})
+            bus.commit()
+            for node in range(1, BOARDS + 1):
+                reader = FrameReader(NodePort(bus, node))
+                reader.port.write(b'C')
+                frames.append(snapshot.render_text(snapshot.decode(reader.expect('C')), font))
+                reader.port.write(b'L')
+                payload = reader.expect('L')
+                tested, failed, size, count = struct.unpack_from('<HHBB', payload)
+                frames.append('log %d/%d' % (failed, tested))
+                for i in range(count):
+                    frames.append(result_csv(payload[6 + i * size:6 + (i + 1) * size]))
+    except (FrameError, snapshot.SnapshotError) as e:
+        frames.append('error: %s' % e)
+    output = '\n'.join(['# %s' % name, '# trace'] + trace + ['# frames'] + frames) + '\n'
+    return name, output, time.monotonic() - start
+
+
+def check(name, output, golden_dir, update):
+    """'pass', 'FAIL', 'new' or 'updated', and a diff for a failure."""
+    path = os.path.join(golden_dir, name + '.txt')
+    try:
+        with open(path) as f:
+            golden = f.read()
+    except FileNotFoundError:
+        golden = None
+    if golden == output:
+        return 'pass', ''
+    if update or golden is None:
+        with open(path, 'w') as f:
+            f.write(output)
+        return ('updated' if golden is not None else 'new'), ''
+    diff = difflib.unified_diff(golden.splitlines(True), output.splitlines(True),
+                                'golden/' + name + '.txt', name)
+    return 'FAIL', ''.join(diff)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split('\n\n')[0].strip())
+    ap.add_argument('--jobs', type=int, default=os.cpu_count(),
+                    help='worker processes (default: one per CPU)')
+    ap.add_argument('--update', action='store_true',
+                    help='rewrite the golden files of cells that differ')
+    ap.add_argument('--golden', default=GOLDEN_DIR, help='golden file directory')
+    ap.add_argument('cells', nargs='*', help='cells to run (default: all)')
+    args = ap.parse_args()
+    cells = all_cells()
+    if args.cells:
+        cells = [c for c in cells if any(fnmatch.fnmatch(c[0], p) for p in args.cells)]
+        if not cells:
+            sys.exit('protoregress: no cell matches %s' % ' '.join(args.cells))
+    os.makedirs(args.golden, exist_ok=True)
+    start = time.monotonic()
+    results = {}
+    failed = 0
+    with concurrent.futures.ProcessPoolExecutor(max_workers=args.jobs) as pool:
+        jobs = [pool.submit(run_cell, name, *c) for name, c in cells]
+        for job in concurrent.futures.as_completed(jobs):
+            name, output, seconds = job.result()
+            status, diff = check(name, output, args.golden, args.update)
+            results[name] = (status, seconds)
+            if diff:
+                failed += 1
+                sys.stdout.write(diff)
+    wall = time.monotonic() - start
+    for name, _ in cells:
+        status, seconds = results[name]
+        print('%-26s %7.1f ms  %s' % (name, seconds * 1000, status))
+    total = sum(s for _, s in results.values())
+    print('%d cells, %d failed; %.2f s wall, %.2f s of cells on %d workers' % (
+        len(cells), failed, wall, total, args.jobs))
+    if failed:
+        sys.exit('protoregress: %d of %d cells differ from their golden files' % (failed, len(cells)))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,217 @@
+#!/usr/bin/env python3
+"""
+Renders display snapshots (console frame 'C', see capture.h) as text or
+PNG.
+
+Characters are drawn with the 5x7 font in font.def, so segmented parts
+come out as dot-matrix approximations; user-defined characters use the
+bitmaps in the snapshot. Flashing digits are drawn dimmed, cursors as a
+lit block, and the brightness in the control word scales the colour.
+
+Usage: snapshot.py SNAPSHOT [--png OUT.png] [--scale N]
+       (SNAPSHOT is a payload saved with "tester.py PORT capture --save")
+"""
+
+import argparse
+import os
+import struct
+import sys
+import zlib
+
+from packmsg import DefError, GLYPH_HEIGHT, GLYPH_WIDTH, parse as parse_def
+
+VERSION = 1
+FLAG_READBACK = 0x01
+FLAG_PANEL = 0x02
+PANEL_CHIPS_PER_ROW = 4
+CHAR_ATTR = 0x80
+FONT_FIRST = 0x20
+
+# order of enum display_type in display.h
+DISPLAY_TYPES = [
+    'DL1414', 'DLX1414', 'DL1416T', 'DL1416B', 'DL1814', 'DL2416', 'DLX2416',
+    'DL3416', 'DLX3416', 'DL3422', 'PD2816', 'HDSP2xxx', 'HDLX2416', 'HDLX3416',
+]
+
+# control word fields (display.h)
+HDSP_BRIGHTNESS = [1.0, 0.8, 0.53, 0.4, 0.27, 0.2, 0.13, 0.0]
+HDSP_FLASH_ON = 0x08
+HDSP_BLINK = 0x10
+PD2816_BRIGHTNESS = [0.0, 0.25, 0.5, 1.0]
+PD2816_ATTRS_ON = 0x10
+PD2816_BLINK = 0x20
+PD2816_LAMP_TEST = 0x40
+
+LIT = (255, 64, 16)
+UNLIT = (40, 12, 8)
+BACKGROUND = (16, 16, 16)
+UNKNOWN_GLYPH = [0x1F, 0x11, 0x11, 0x11, 0x11, 0x11, 0x1F]
+
+
+class SnapshotError(Exception):
+    pass
+
+
+def decode(payload):
+    """Returns a dict with the header fields and a list of devices."""
+    if len(payload) < 5 or payload[0] != VERSION:
+        raise SnapshotError("not a version %d snapshot" % VERSION)
+    _, dtype, flags, ndevs, digits = payload[:5]
+    pos = 5
+    devices = []
+    try:
+        for _ in range(ndevs):
+            control, cursor, flash = payload[pos:pos + 3]
+            chars = list(payload[pos + 3:pos + 3 + digits])
+            pos += 3 + digits
+            nudc = payload[pos]
+            pos += 1
+            udcs = {}
+            for _ in range(nudc):
+                udcs[payload[pos]] = list(payload[pos + 1:pos + 8])
+                pos += 8
+            devices.append({'control': control, 'cursor': cursor, 'flash': flash,
+                            'chars': chars, 'udcs': udcs})
+    except (ValueError, IndexError):
+        raise SnapshotError("snapshot is truncated")
+    if pos != len(payload) or any(len(d['chars']) != digits for d in devices):
+        raise SnapshotError("snapshot length doesn't match its contents")
+    name = DISPLAY_TYPES[dtype] if dtype < len(DISPLAY_TYPES) else str(dtype)
+    return {'type': name, 'flags': flags, 'digits': digits, 'devices': devices}
+
+
+def load_font(path):
+    entries = parse_def(path)
+    rows = next(e['rows'] for e in entries if e['kind'] == 'glyphs')
+    return [rows[i:i + GLYPH_HEIGHT] for i in range(0, len(rows), GLYPH_HEIGHT)]
+
+
+def device_grid(snap):
+    """Devices arranged as they are mounted: rows of devices."""
+    devs = snap['devices']
+    per_row = PANEL_CHIPS_PER_ROW if snap['flags'] & FLAG_PANEL else len(devs)
+    return [devs[i:i + per_row] for i in range(0, len(devs), per_row)]
+
+
+def brightness(snap, dev):
+    if snap['type'] == 'HDSP2xxx':
+        return HDSP_BRIGHTNESS[dev['control'] & 0x07]
+    if snap['type'] == 'PD2816':
+        return PD2816_BRIGHTNESS[dev['control'] & 0x03]
+    return 1.0
+
+
+def cell(snap, dev, digit, font):
+    """(glyph rows, dimmed) for one digit."""
+    c = dev['chars'][digit]
+    dimmed = False
+    underline = False
+    if snap['type'] == 'HDSP2xxx':
+        dimmed = bool(dev['control'] & HDSP_FLASH_ON and dev['flash'] >> digit & 1)
+    elif snap['type'] == 'PD2816':
+        underline = bool(dev['control'] & PD2816_ATTRS_ON and c & CHAR_ATTR)
+        c &= ~CHAR_ATTR
+    if dev['cursor'] >> digit & 1:
+        return [0x1F] * GLYPH_HEIGHT, dimmed
+    if snap['type'] == 'PD2816' and dev['control'] & PD2816_LAMP_TEST:
+        return [0x1F] * GLYPH_HEIGHT, dimmed
+    if snap['type'] == 'HDSP2xxx' and c & CHAR_ATTR:
+        rows = dev['udcs'].get(c & 0x0F, UNKNOWN_GLYPH)
+    elif FONT_FIRST <= c < FONT_FIRST + len(font):
+        rows = font[c - FONT_FIRST]
+    else:
+        rows = UNKNOWN_GLYPH
+    rows = list(rows)
+    if underline:
+        rows[-1] = 0x1F
+    return rows, dimmed
+
+
+def render_text(snap, font):
+    lines = ['%s, %s' % (snap['type'], 'read back' if snap['flags'] & FLAG_READBACK
+                         else 'as last written')]
+    for devs in device_grid(snap):
+        text = ''
+        marks = ''
+        for dev in devs:
+            for digit, c in enumerate(dev['chars']):
+                if snap['type'] == 'PD2816':
+                    c &= ~CHAR_ATTR
+                udc = snap['type'] == 'HDSP2xxx' and c & CHAR_ATTR
+                text += '#' if udc else chr(c) if 0x20 <= c < 0x7F else '?'
+                _, dimmed = cell(snap, dev, digit, font)
+                marks += '_' if dev['cursor'] >> digit & 1 else '~' if dimmed else ' '
+        lines.append(text)
+        if marks.strip():
+            lines.append(marks)
+    return '\n'.join(lines)
+
+
+def render_pixels(snap, font, scale):
+    """Returns (width, height, rows of RGB bytes)."""
+    pitch_x = GLYPH_WIDTH + 1
+    pitch_y = GLYPH_HEIGHT + 2
+    grid = device_grid(snap)
+    cols = max(len(devs) for devs in grid) * snap['digits']
+    width = (cols * pitch_x + 1) * scale
+    height = (len(grid) * pitch_y) * scale
+    image = [bytearray(BACKGROUND * width) for _ in range(height)]
+
+    def dot(x, y, color):
+        for dy in range(scale):
+            row = image[y * scale + dy]
+            for dx in range(scale):
+                row[(x * scale + dx) * 3:(x * scale + dx) * 3 + 3] = bytes(color)
+
+    for gy, devs in enumerate(grid):
+        for gx, dev in enumerate(devs):
+            level = brightness(snap, dev)
+            for digit in range(snap['digits']):
+                rows, dimmed = cell(snap, dev, digit, font)
+                k = level * (0.4 if dimmed else 1.0)
+                lit = tuple(max(u, int(l * k)) for l, u in zip(LIT, UNLIT))
+                x0 = 1 + (gx * snap['digits'] + digit) * pitch_x
+                y0 = 1 + gy * pitch_y
+                for y, bits in enumerate(rows):
+                    for x in range(GLYPH_WIDTH):
+                        on = bits >> (GLYPH_WIDTH - 1 - x) & 1
+                        dot(x0 + x, y0 + y, lit if on else UNLIT)
+    return width, height, image
+
+
+def write_png(path, width, height, image):
+    def chunk(kind, data):
+        body = kind + data
+        return struct.pack('>I', len(data)) + body + struct.pack('>I', zlib.crc32(body))
+
+    raw = b''.join(b'\0' + bytes(row) for row in image)
+    with open(path, 'wb') as f:
+        f.write(b'\x89PNG\r\n\x1a\n')
+        f.write(chunk(b'IHDR', struct.pack('>IIBBBBB', width, height, 8, 2, 0, 0, 0)))
+        f.write(chunk(b'IDAT', zlib.compress(raw, 9)))
+        f.write(chunk(b'IEND', b''))
+
+
+def default_font():
+    return load_font(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'font.def'))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split('\n\n')[0].strip())
+    ap.add_argument('snapshot')
+    ap.add_argument('--png', help="image to write")
+    ap.add_argument('--scale', type=int, default=4, help="pixels per dot (default 4)")
+    args = ap.parse_args()
+    try:
+        with open(args.snapshot, 'rb') as f:
+            snap = decode(f.read())
+        font = default_font()
+    except (OSError, SnapshotError, DefError) as e:
+        sys.exit("snapshot: %s" % e)
+    print(render_text(snap, font))
+    if args.png:
+        write_png(args.png, *render_pixels(snap, font, args.scale))
+
+
+if __name__ == '__main__':
+    main()
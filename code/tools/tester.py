@@ -0,0 +1,562 @@
+#!/usr/bin/env python3
+"""
+Host side of the tester's serial console (see console.h).
+
+Usage:
+  tester.py PORT log      dump the test result log as CSV
+  tester.py PORT watch    print each result as CSV as it is logged
+  tester.py PORT shmoo    characterize the bus timing of the inserted part
+                          (prints one CSV line; --forget clears the stored
+                          timing first). "<=" marks an interval that passed
+                          at the shortest the tester can drive
+  tester.py PORT profile  print the cycle counters of a "make profile" build
+                          (--reset clears them afterwards)
+  tester.py PORT marquee [TEXT]
+                          scroll TEXT (or a built-in message) across the
+                          display; --mode left|right|bounce, Ctrl-C stops
+  tester.py PORT marquee --stream
+                          scroll lines from stdin as they arrive
+  tester.py PORT anim FILE
+                          play an animation (tools/animenc.py source, or an
+                          encoded stream from animenc.py -b) on the display
+  tester.py PORT capture  show what the display is showing as text; --png
+                          writes an image, --save the raw snapshot (see
+                          tools/snapshot.py), --panel captures the panel
+                          terminal instead ("TERM" in the menu)
+  tester.py PORT termbench
+                          measure the sustained character rate of the panel
+                          terminal ("TERM" in the menu)
+  tester.py PORT bitmap   benchmark bitmap mode on the panel (see bitmap.h):
+                          frame rates of a scrolling graph and of large
+                          numbers, as CSV
+  tester.py PORT boot     how long the last powerup took to show the last
+                          frame from the ring, and to detect the part
+                          (see boot.h), as CSV
+
+Several boards wired as a ring (see net.h):
+  tester.py PORT nodes    number the boards in ring order and list them
+  tester.py PORT show TEXT...
+                          one TEXT per board, all shown at the same moment
+                          (--panel: on their panel terminals); --stream
+                          shows each line of stdin in turn, with one text
+                          per board separated by tabs, and waits a little
+                          whenever a board says its panel is behind
+  tester.py PORT leave    take every board out of the ring
+  tester.py PORT sync     bring the blinking of every board into phase (see
+                          blink.h) and print each board's clock and its
+                          drift from the first board's, as CSV; --every S
+                          repeats it every S seconds
+  tester.py PORT flow     frame governor counters of every board (see
+                          governor.h): frames merged and dropped, busy
+                          answers, estimated cost and latency, as CSV
+  --node N                run log, watch, shmoo, profile, capture or boot
+                          on board N
+
+PORT is the USB-serial adapter, e.g. /dev/ttyUSB0. Uses pyserial if it is
+installed, otherwise raw termios (Linux).
+"""
+
+import argparse
+import os
+import struct
+import sys
+import time
+
+BAUD = 1000000
+SOF = 0xA5
+
+# order of enum display_type in main.c
+DISPLAY_TYPES = [
+    'DL1414', 'DLX1414', 'DL1416T', 'DL1416B', 'DL1814', 'DL2416', 'DLX2416',
+    'DL3416', 'DLX3416', 'DL3422', 'PD2816', 'HDSP2xxx', 'HDLX2416', 'HDLX3416',
+]
+
+# frame 'E' reasons (CONSOLE_REFUSED_* in console.h)
+REFUSED = {0: 'a test is running', 1: 'no part that can be read back is selected'}
+
+# order of enum result_test in resultlog.h
+RESULT_TESTS = ['pass', 'readback_data', 'readback_control', 'selftest']
+
+RESULT_ENTRY = struct.Struct('<BBBBBBBB')
+RESULT_SELFTEST_TIME_MS = 50
+RESULT_TIMESTAMP_MS = 1024
+
+# struct shmoo_result in shmoo.h
+SHMOO_RESULT = struct.Struct('<BBb3B3BB')
+SHMOO_FLOORS = 3            # at_floor bits: setup, strobe, hold
+BUS_MIN_CYCLES = 4          # display.h
+NS_PER_CYCLE = 50
+SHMOO_TYPES = ['PD2816', 'HDSP2xxx']
+
+# order of enum prof_site in profile.h
+PROF_SITES = ['writeByte', 'readByte', 'displayChar', 'setUserDefinedChar_P',
+              'flush', 'sched_tick', 'writeBurst']
+PROF_HEADER = struct.Struct('<BBHHH')
+PROF_STATS = struct.Struct('<IIHH')
+F_CPU = 20000000
+
+# marquee speed: one pixel column per 40ms frame, 6 columns per character
+MARQUEE_CPS = 1000.0 / (40 * 6)
+MARQUEE_MODES = {'left': b'<', 'right': b'>', 'bounce': b'='}
+MARQUEE_STOP = b'\x1b'
+
+# text streamed by termbench, and the rates tried (characters/second)
+TERMBENCH_TEXT = b'The quick brown fox jumps over the lazy dog. 0123456789\r\n'
+TERMBENCH_CHARS = 8192
+TERMBENCH_RATES = [100000, 80000, 60000, 40000, 20000, 10000]
+
+# struct bitmap_bench in bitmap.h, one per benchmark part in this order
+BITMAP_BENCH = struct.Struct('<HIHHH')
+BITMAP_PARTS = ['graph', 'numbers']
+
+# struct boot_times in boot.h
+BOOT_TIMES = struct.Struct('<BHH')
+BOOT_INSTANT = 0x01
+BOOT_CONFIRMED = 0x02
+BOOT_NO_TIME = 0xFFFF
+
+# struct blink_status in blink.h
+BLINK_STATUS = struct.Struct('<HII')
+
+# struct gov_status in governor.h
+GOV_STATUS = struct.Struct('<8H')
+GOV_FIELDS = ['frames', 'merged', 'dropped', 'busy', 'cell_ns', 'cost_us',
+              'latency_us', 'max_latency_us']
+# pause after a board answers that its panel is behind
+BUSY_BACKOFF = 0.02
+
+
+class FrameError(Exception):
+    pass
+
+
+def crc8_ccitt(data, crc=0):
+    for b in data:
+        crc ^= b
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07) & 0xFF if crc & 0x80 else (crc << 1) & 0xFF
+    return crc
+
+
+class Port:
+    """Minimal byte-oriented serial port."""
+
+    def __init__(self, path, baud=BAUD):
+        try:
+            import serial
+            self.ser = serial.Serial(path, baud, timeout=0.1)
+            self.fd = None
+        except ImportError:
+            self.ser = None
+            self.fd = self._open_termios(path, baud)
+
+    @staticmethod
+    def _open_termios(path, baud):
+        import termios
+        import tty
+        fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+        tty.setraw(fd)
+        attrs = termios.tcgetattr(fd)
+        speed = getattr(termios, 'B%d' % baud, None)
+        if speed is None:
+            raise SystemExit("termios has no %d baud setting; install pyserial" % baud)
+        attrs[4] = attrs[5] = speed
+        attrs[6][termios.VMIN] = 0
+        attrs[6][termios.VTIME] = 1
+        termios.tcsetattr(fd, termios.TCSANOW, attrs)
+        return fd
+
+    def write(self, data):
+        if self.ser:
+            self.ser.write(data)
+        else:
+            os.write(self.fd, data)
+
+    def read(self, n):
+        if self.ser:
+            return self.ser.read(n)
+        return os.read(self.fd, n)
+
+
+class FrameReader:
+    """Splits the console byte stream into (type, payload) frames."""
+
+    def __init__(self, port):
+        self.port = port
+        self.buf = bytearray()
+
+    def _fill(self, n, deadline):
+        while len(self.buf) < n:
+            if deadline is not None and time.monotonic() > deadline:
+                return False
+            self.buf += self.port.read(max(n - len(self.buf), 256))
+        return True
+
+    def next(self, timeout=None):
+        deadline = None if timeout is None else time.monotonic() + timeout
+        while True:
+            if not self._fill(1, deadline):
+                return None
+            if self.buf[0] != SOF:
+                del self.buf[0]
+                continue
+            if not self._fill(4, deadline):
+                return None
+            length = self.buf[2] | (self.buf[3] << 8)
+            if not self._fill(5 + length, deadline):
+                return None
+            frame = bytes(self.buf[1:4 + length])
+            crc = self.buf[4 + length]
+            if crc8_ccitt(frame) != crc:
+                # resynchronize on the next start byte
+                del self.buf[0]
+                continue
+            del self.buf[:5 + length]
+            return chr(frame[0]), frame[3:]
+
+    def expect(self, ftype, timeout=2.0):
+        deadline = time.monotonic() + timeout
+        while True:
+            frame = self.next(max(deadline - time.monotonic(), 0))
+            if frame is None:
+                raise FrameError("no '%s' frame received" % ftype)
+            if frame[0] == ftype:
+                return frame[1]
+            if frame[0] == 'E' and frame[1][:1] == ftype.encode():
+                reason = frame[1][1] if len(frame[1]) > 1 else None
+                raise FrameError("'%s' refused: %s" % (
+                    ftype, REFUSED.get(reason, 'reason %s' % reason)))
+
+
+def result_csv_header():
+    return 'seq,display_type,test,fail_addr,fail_bits,selftest_ms,uptime_s'
+
+
+def result_csv(entry):
+    seq, dtype, test, addr, bits, st_time, ts, _ = RESULT_ENTRY.unpack(entry)
+    dname = DISPLAY_TYPES[dtype] if dtype < len(DISPLAY_TYPES) else str(dtype)
+    tname = RESULT_TESTS[test] if test < len(RESULT_TESTS) else str(test)
+    return '%d,%s,%s,%d,0x%02x,%d,%.1f' % (
+        seq, dname, tname, addr, bits, st_time * RESULT_SELFTEST_TIME_MS,
+        ts * RESULT_TIMESTAMP_MS / 1000.0)
+
+
+def cmd_log(reader, args):
+    reader.port.write(b'L')
+    payload = reader.expect('L')
+    tested, failed, size, count = struct.unpack_from('<HHBB', payload)
+    print('# parts tested: %d, failed: %d' % (tested, failed))
+    print(result_csv_header())
+    for i in range(count):
+        print(result_csv(payload[6 + i * size:6 + (i + 1) * size]))
+
+
+def cmd_watch(reader, args):
+    print(result_csv_header(), flush=True)
+    while True:
+        frame = reader.next()
+        if frame and frame[0] == 'R':
+            print(result_csv(frame[1]), flush=True)
+
+
+def cmd_shmoo(reader, args):
+    if args.forget:
+        reader.port.write(b't')
+    reader.port.write(b'T')
+    # each step runs the full pattern set several times
+    payload = reader.expect('T', timeout=10.0)
+    dtype, passed, temp, *timing, at_floor = SHMOO_RESULT.unpack(payload)
+    dname = DISPLAY_TYPES[dtype] if dtype < len(DISPLAY_TYPES) else str(dtype)
+    if dname not in SHMOO_TYPES:
+        sys.exit('tester: %s can not be characterized' % dname)
+    if not passed:
+        sys.exit('tester: %s fails at the default timing' % dname)
+    print('display_type,temp_c,setup_ns,strobe_ns,hold_ns,'
+          'stored_setup_ns,stored_strobe_ns,stored_hold_ns')
+    # an interval that passed at the tester's floor was not measured
+    floored = [at_floor >> i & 1 for i in range(SHMOO_FLOORS)] + \
+        [c == BUS_MIN_CYCLES for c in timing[SHMOO_FLOORS:]]
+    print('%s,%d,%s' % (dname, temp, ','.join(
+        '%s%d' % ('<=' if f else '', c * NS_PER_CYCLE) for c, f in zip(timing, floored))))
+
+
+def cmd_profile(reader, args):
+    reader.port.write(b'P')
+    try:
+        payload = reader.expect('P')
+    except FrameError:
+        raise FrameError("no 'P' frame received (is this a 'make profile' build?)")
+    nsites, size, stack_size, stack_used, overhead = PROF_HEADER.unpack_from(payload)
+    print('%-22s %10s %12s %8s %8s %8s %8s' % (
+        'site', 'calls', 'total', 'min', 'avg', 'max', 'avg_us'))
+    for i in range(nsites):
+        calls, total, lo, hi = PROF_STATS.unpack_from(payload, PROF_HEADER.size + i * size)
+        name = PROF_SITES[i] if i < len(PROF_SITES) else str(i)
+        if not calls:
+            print('%-22s %10d' % (name, 0))
+            continue
+        avg = total / calls
+        print('%-22s %10d %12d %8d %8.1f %8d %8.2f' % (
+            name, calls, total, lo, avg, hi, avg * 1e6 / F_CPU))
+    print('stack: %d of %d bytes used at most; instrumentation overhead %d cycles (subtracted)'
+          % (stack_used, stack_size, overhead))
+    if args.reset:
+        reader.port.write(b'p')
+
+
+def terminal_status(port, timeout=5.0):
+    """Sends a VT100 status request; True if no input was lost since the last one."""
+    port.write(b'\x1b[5n')
+    deadline = time.monotonic() + timeout
+    buf = b''
+    while not buf.endswith(b'n'):
+        if time.monotonic() > deadline:
+            raise FrameError('terminal did not answer a status request')
+        buf += port.read(1)
+    return buf.endswith(b'\x1b[0n')
+
+
+def cmd_termbench(reader, args):
+    port = reader.port
+    data = (TERMBENCH_TEXT * (TERMBENCH_CHARS // len(TERMBENCH_TEXT) + 1))[:TERMBENCH_CHARS]
+    chunk = 64
+    best = None
+    print('requested_cps,achieved_cps,lossless')
+    for rate in TERMBENCH_RATES:
+        port.write(b'\x1b[2J\x1b[H')
+        terminal_status(port)  # clears the lost-byte count
+        start = time.monotonic()
+        for i in range(0, len(data), chunk):
+            port.write(data[i:i + chunk])
+            wait = start + (i + chunk) / rate - time.monotonic()
+            if wait > 0:
+                time.sleep(wait)
+        # answered only once every character has been handled
+        ok = terminal_status(port)
+        achieved = len(data) / (time.monotonic() - start)
+        print('%d,%d,%s' % (rate, achieved, 'yes' if ok else 'no'), flush=True)
+        if ok and best is None:
+            best = achieved
+    if best is None:
+        sys.exit('tester: input was lost at every rate')
+    print('# sustained: %d characters/s' % best)
+
+
+def cmd_marquee(reader, args):
+    port = reader.port
+    if args.stream:
+        port.write(b'S')
+        try:
+            for line in sys.stdin:
+                for c in line.rstrip('\n') + '   ':
+                    port.write(c.encode('utf-8'))
+                    time.sleep(1 / MARQUEE_CPS)
+        finally:
+            port.write(MARQUEE_STOP)
+        return
+    text = ' '.join(args.text)[:128].encode('utf-8')
+    port.write(b'M' + MARQUEE_MODES[args.mode] + text + b'\n')
+    try:
+        while True:
+            time.sleep(1)
+    finally:
+        port.write(MARQUEE_STOP)
+
+
+def cmd_anim(reader, args):
+    import animenc
+    if len(args.text) != 1:
+        sys.exit('tester: anim takes one file')
+    path = args.text[0]
+    try:
+        if path.endswith('.anim'):
+            data = animenc.encode(*animenc.parse(path))
+        else:
+            with open(path, 'rb') as f:
+                data = f.read()
+        header, frames = animenc.iter_frames(data)
+    except (OSError, animenc.AnimError, animenc.DefError) as e:
+        sys.exit('tester: %s: %s' % (path, e))
+    port = reader.port
+    port.write(b'A' + header)
+    # the receive buffer only holds a few frames: send each just before it is due
+    lead = 0.02
+    due = time.monotonic()
+    for duration, frame in frames:
+        wait = due - lead - time.monotonic()
+        if wait > 0:
+            time.sleep(wait)
+        port.write(frame)
+        due += duration / 1000.0
+
+
+def cmd_capture(reader, args):
+    import snapshot
+    # the panel terminal takes a private status request instead of 'C'
+    reader.port.write(b'\x1b[99n' if args.panel else b'C')
+    payload = reader.expect('C', timeout=5.0)
+    if args.save:
+        with open(args.save, 'wb') as f:
+            f.write(payload)
+    try:
+        snap = snapshot.decode(payload)
+        font = snapshot.default_font()
+    except (OSError, snapshot.SnapshotError, snapshot.DefError) as e:
+        sys.exit('tester: %s' % e)
+    print(snapshot.render_text(snap, font))
+    if args.png:
+        snapshot.write_png(args.png, *snapshot.render_pixels(snap, font, args.scale))
+
+
+def cmd_bitmap(reader, args):
+    reader.port.write(b'G')
+    payload = reader.expect('G', timeout=30.0)
+    print('content,frames,ms,fps,tiles_loaded,tiles_shared,tiles_blank')
+    for i, name in enumerate(BITMAP_PARTS):
+        frames, ms, loaded, shared, blank = BITMAP_BENCH.unpack_from(
+            payload, i * BITMAP_BENCH.size)
+        fps = frames * 1000.0 / ms if ms else 0
+        print('%s,%d,%d,%.1f,%d,%d,%d' % (name, frames, ms, fps, loaded, shared, blank))
+
+
+def cmd_boot(reader, args):
+    reader.port.write(b'B')
+    flags, frame_us, detect_us = BOOT_TIMES.unpack(reader.expect('B'))
+    print('instant,confirmed,frame_us,detect_us')
+    print('%d,%d,%s,%s' % (
+        bool(flags & BOOT_INSTANT), bool(flags & BOOT_CONFIRMED),
+        '' if frame_us == BOOT_NO_TIME else frame_us,
+        '' if detect_us == BOOT_NO_TIME else detect_us))
+
+
+def cmd_nodes(bus, args):
+    n = bus.enumerate()
+    idents = bus.identify()
+    print('%d board%s' % (n, '' if n == 1 else 's'))
+    for node in range(1, n + 1):
+        print('%3d  %s' % (node, idents.get(node, '(no answer)')))
+
+
+def cmd_show(bus, args):
+    import netbus
+    n = len(bus.identify())
+    if len(args.text) > n:
+        sys.exit('tester: %d texts for %d boards' % (len(args.text), n))
+    target = netbus.TARGET_PANEL if args.panel else netbus.TARGET_DISPLAY
+    if not args.stream:
+        bus.stage(dict(enumerate(args.text, 1)), target)
+        bus.commit()
+        return
+    for line in sys.stdin:
+        texts = line.rstrip('\n').split('\t')[:n]
+        bus.stage(dict(enumerate(texts, 1)), target)
+        bus.commit()
+        if bus.busy:
+            # the boards merge frames, so this only keeps them from lagging
+            time.sleep(BUSY_BACKOFF)
+
+
+def cmd_leave(bus, args):
+    bus.leave()
+
+
+def cmd_sync(bus, args):
+    import netbus
+    idents = bus.identify()
+    while True:
+        bus.sync()
+        print('node,display_type,syncs,since_ms,clock_hz,drift_ms_per_min', flush=True)
+        ref = None
+        for node, dtype in idents.items():
+            reader = FrameReader(netbus.NodePort(bus, node))
+            reader.port.write(b'Y')
+            syncs, since_ms, clock_hz = BLINK_STATUS.unpack(reader.expect('Y'))
+            drift = ''
+            if clock_hz:
+                # a clock that runs fast moves its blink phase ahead
+                ref = ref or clock_hz
+                drift = '%.2f' % ((clock_hz - ref) * 60000.0 / ref)
+            print('%d,%s,%d,%d,%s,%s' % (node, dtype, syncs, since_ms,
+                                         clock_hz or '', drift), flush=True)
+        if not args.every:
+            return
+        time.sleep(args.every)
+
+
+def cmd_flow(bus, args):
+    import netbus
+    print('node,display_type,' + ','.join(GOV_FIELDS))
+    for node, dtype in bus.identify().items():
+        reader = FrameReader(netbus.NodePort(bus, node))
+        reader.port.write(b'V')
+        values = GOV_STATUS.unpack(reader.expect('V'))
+        print('%d,%s,%s' % (node, dtype, ','.join(str(v) for v in values)))
+
+
+COMMANDS = {
+    'anim': cmd_anim,
+    'bitmap': cmd_bitmap,
+    'boot': cmd_boot,
+    'capture': cmd_capture,
+    'log': cmd_log,
+    'marquee': cmd_marquee,
+    'profile': cmd_profile,
+    'shmoo': cmd_shmoo,
+    'termbench': cmd_termbench,
+    'watch': cmd_watch,
+}
+
+# commands for the whole ring, and those that can run on one board of it
+RING_COMMANDS = {
+    'flow': cmd_flow,
+    'leave': cmd_leave,
+    'nodes': cmd_nodes,
+    'show': cmd_show,
+    'sync': cmd_sync,
+}
+NODE_COMMANDS = ['boot', 'capture', 'log', 'profile', 'shmoo', 'watch']
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Talk to the display tester's serial console.")
+    ap.add_argument('port')
+    ap.add_argument('command', choices=sorted(list(COMMANDS) + list(RING_COMMANDS)))
+    ap.add_argument('--forget', action='store_true',
+                    help='shmoo: discard timing stored by earlier runs')
+    ap.add_argument('--reset', action='store_true',
+                    help='profile: clear the counters after printing them')
+    ap.add_argument('--mode', choices=sorted(MARQUEE_MODES), default='left',
+                    help='marquee: scroll direction')
+    ap.add_argument('--stream', action='store_true',
+                    help='marquee: scroll stdin instead of TEXT; show: stream frames from stdin')
+    ap.add_argument('--panel', action='store_true',
+                    help='capture: snapshot the panel terminal; show: show on it')
+    ap.add_argument('--node', type=int, help='run the command on this board of a ring')
+    ap.add_argument('--png', help='capture: image to write')
+    ap.add_argument('--scale', type=int, default=4, help='capture: pixels per dot')
+    ap.add_argument('--save', help='capture: file for the raw snapshot')
+    ap.add_argument('--every', type=float, help='sync: repeat every EVERY seconds')
+    ap.add_argument('text', nargs='*',
+                    help='marquee: text to scroll; anim: file to play; show: text per board')
+    args = ap.parse_args()
+    port = Port(args.port)
+    import netbus
+    try:
+        if args.command in RING_COMMANDS or args.node is not None:
+            bus = netbus.NetBus(port)
+            if args.command in RING_COMMANDS:
+                RING_COMMANDS[args.command](bus, args)
+                return
+            if args.command not in NODE_COMMANDS or args.panel:
+                sys.exit('tester: %s%s can not run over the ring' % (
+                    args.command, ' --panel' if args.panel else ''))
+            port = netbus.NodePort(bus, args.node)
+        COMMANDS[args.command](FrameReader(port), args)
+    except (FrameError, netbus.NetError) as e:
+        sys.exit('tester: %s' % e)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == '__main__':
+    main()
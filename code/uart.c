@@ -0,0 +1,67 @@
+#include "uart.h"
+#include "pins.h"
+#include "pin_xmega.h"
+
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+
+#define RX_BUF_SIZE  64 /* power of 2 */
+
+static volatile uint8_t rx_buf[RX_BUF_SIZE];
+static volatile uint8_t rx_head;
+static volatile uint8_t rx_tail;
+static volatile uint8_t rx_dropped;
+
+
+ISR(USART1_RXC_vect) {
+  uint8_t c = USART1.RXDATAL;
+  uint8_t next = (rx_head+1) & (RX_BUF_SIZE-1);
+  /* drop the byte if the buffer is full */
+  if (next != rx_tail) {
+    rx_buf[rx_head] = c;
+    rx_head = next;
+  } else if (rx_dropped != 0xFF) {
+    rx_dropped++;
+  }
+}
+
+
+void uartInit(void) {
+  PORTMUX.USARTROUTEA |= PORTMUX_USART1_ALT1_gc;
+  pin_output_high(TXD);
+  pin_input_pullup(RXD);
+  USART1.BAUD = (uint16_t)((64UL*F_CPU + 8UL*UART_BAUD)/(16UL*UART_BAUD));
+  USART1.CTRLA = USART_RXCIE_bm;
+  USART1.CTRLB = USART_RXEN_bm|USART_TXEN_bm;
+}
+
+
+int16_t uartGetc(void) {
+  uint8_t tail = rx_tail;
+  if (tail == rx_head) { return -1; }
+  uint8_t c = rx_buf[tail];
+  rx_tail = (tail+1) & (RX_BUF_SIZE-1);
+  return c;
+}
+
+
+uint8_t uartDropped(void) {
+  uint8_t n;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    n = rx_dropped;
+    rx_dropped = 0;
+  }
+  return n;
+}
+
+
+void uartPutc(uint8_t c) {
+  while (!(USART1.STATUS & USART_DREIF_bm)) {}
+  USART1.TXDATAL = c;
+}
+
+
+void uartWrite(const void *buf, uint16_t len) {
+  const uint8_t *p = buf;
+  while (len--) { uartPutc(*p++); }
+}
@@ -0,0 +1,23 @@
+/**
+ * Serial port (USART1, 1 Mbaud 8N1).
+ *
+ * Uses the alternate USART1 pins, PC4 (TXD) and PC5 (RXD), which are not
+ * connected on the rev 1 tester board; the 6-pin "FTDI" header only carries
+ * UPDI. Wire a 5V USB-serial adapter's RXD to PC4 (pin 16) and TXD to PC5
+ * (pin 17). Several boards can share one adapter as a ring (see net.h).
+ * Received bytes are buffered by interrupt; transmission blocks
+ * until each byte is in the transmit register.
+ */
+#pragma once
+
+#include <stdint.h>
+
+#define UART_BAUD  1000000UL
+
+void uartInit(void);
+/* Returns the next received byte, or -1 if none is waiting */
+int16_t uartGetc(void);
+/* Bytes lost to a full receive buffer since the last call (saturates at 255) */
+uint8_t uartDropped(void);
+void uartPutc(uint8_t c);
+void uartWrite(const void *buf, uint16_t len);
@@ -0,0 +1,316 @@
+#!/usr/bin/env python3
+"""
+Generates the Display_IntelligentAlpha footprints, symbols and symbol
+documentation from the part table in parts.py.
+
+Each footprint and symbol is made by its own worker process; the
+library and documentation files are then put together from the symbols
+in name order. Files that come out the same are left alone, so
+regenerating after a table edit only touches what the edit changed.
+
+KiCad does not care in which order a footprint's lines and pads are
+listed, or in which direction a line or rectangle was drawn, and the
+hand-edited files in the library are in no particular order. So where a
+file already exists its order and directions are kept, and only what
+the table no longer produces is dropped and what it newly produces is
+added at the end. Everything else (every coordinate, name and string)
+comes from the table; --check regenerates in memory and fails if any
+file would change, so the table and the files cannot drift apart.
+
+The table is also checked against itself: every symbol must fit its
+footprint (same number of pins, and pins named no_pin exactly where the
+footprint has no hole).
+
+Usage: libgen.py [--check] [--jobs N] [-v]
+"""
+
+import argparse
+import concurrent.futures
+import difflib
+import os
+import sys
+import time
+
+import parts
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+LIBRARY = 'Display_IntelligentAlpha'
+
+SILK_WIDTH = 0.15
+COURTYARD_WIDTH = 0.0508
+PAD = '(size 1.6 1.6) (drill 0.8) (layers *.Cu *.Mask))'
+TEXT_EFFECTS = '    (effects (font (size 1 1) (thickness 0.15)))\n  )'
+TYPE_ORDER = {parts.Circle: 0, parts.Rect: 1, parts.Poly: 2, parts.Pin: 3}
+
+
+def mm(v):
+    s = ('%.4f' % v).rstrip('0').rstrip('.')
+    return '0' if s == '-0' else s
+
+
+def quote(s):
+    return '"%s"' % s.replace('\\', '\\\\').replace('"', '\\"')
+
+
+def arrange(elements, existing):
+    """
+    Lays out elements (each a list of equivalent spellings, the first
+    preferred) in the order and spelling they have in existing.
+    """
+    index = {}
+    for i, spellings in enumerate(elements):
+        for s in spellings:
+            index.setdefault(s, i)
+    out = []
+    placed = set()
+    for chunk in existing:
+        i = index.get(chunk)
+        if i is not None and i not in placed:
+            placed.add(i)
+            out.append(chunk)
+    out += [spellings[0] for i, spellings in enumerate(elements) if i not in placed]
+    return out
+
+
+def read(path):
+    try:
+        with open(path, encoding='utf-8', newline='') as f:
+            return f.read()
+    except FileNotFoundError:
+        return None
+
+
+# --- footprints ---
+
+def padPosition(fp, n):
+    half = fp.pins // 2
+    if n <= half:
+        return (n - 1) * fp.pitch, 0.0
+    return (fp.pins - n) * fp.pitch, -fp.row_spacing
+
+
+def fpLine(a, b, layer, width):
+    def spell(p, q):
+        return '  (fp_line (start %s %s) (end %s %s) (layer %s) (width %s))' % (
+            mm(p[0]), mm(p[1]), mm(q[0]), mm(q[1]), layer, mm(width))
+    return [spell(a, b), spell(b, a)]
+
+
+def fpText(kind, text, at, layer):
+    pos = ' '.join(mm(v) for v in at[:2])
+    if len(at) > 2:
+        pos += ' %d' % at[2]
+    return ['  (fp_text %s %s (at %s) (layer %s)\n%s' % (kind, text, pos, layer, TEXT_EFFECTS)]
+
+
+def fpElements(fp):
+    left, top, right, bottom = fp.body
+    ch = fp.chamfer
+    items = [
+        fpText('reference', 'REF**', fp.ref, 'F.SilkS'),
+        fpText('value', fp.name, fp.value, 'F.Fab'),
+        fpText('user', '%R', fp.user, 'F.Fab'),
+    ]
+    silk = [
+        ((left, top), (right, top)),
+        ((right, top), (right, bottom)),
+        ((left + ch, bottom), (right, bottom)),
+        ((left, bottom - ch), (left + ch, bottom)),
+        ((left, top), (left, bottom - ch)),
+    ] + [((left, y), (right, y)) for y in fp.dividers]
+    items += [fpLine(a, b, 'F.SilkS', SILK_WIDTH) for a, b in silk]
+    if fp.courtyard:
+        corners = [(left, top), (right, top), (right, bottom), (left, bottom)]
+        items += [fpLine(corners[i], corners[(i + 1) % 4], 'F.CrtYd', COURTYARD_WIDTH)
+                  for i in range(4)]
+    for n in range(1, fp.pins + 1):
+        if n in fp.missing:
+            continue
+        x, y = padPosition(fp, n)
+        items.append(['  (pad %d thru_hole %s (at %s %s 90) %s' % (
+            n, 'rect' if n == 1 else 'oval', mm(x), mm(y), PAD)])
+    return items
+
+
+def fpChunks(text):
+    """The elements of a .kicad_mod file after its header, as text."""
+    chunks = []
+    for line in text.splitlines()[3:-1]:
+        if line.startswith('  ('):
+            chunks.append(line)
+        elif chunks:
+            chunks[-1] += '\n' + line
+    return chunks
+
+
+def footprint(fp):
+    path = os.path.join(ROOT, LIBRARY + '.pretty', fp.name + '.kicad_mod')
+    old = read(path)
+    lines = [
+        '(module %s (layer F.Cu) (tedit %s)' % (fp.name, fp.tedit),
+        '  (descr %s)' % quote(fp.descr),
+        '  (tags %s)' % quote(fp.tags),
+    ]
+    lines += arrange(fpElements(fp), fpChunks(old) if old else [])
+    lines.append(')')
+    return path, '\n'.join(lines) + '\n'
+
+
+# --- symbols ---
+
+def drawItem(item):
+    """Spellings of one DRAW line."""
+    if isinstance(item, parts.Circle):
+        return ['C %d %d %d %d 1 0 %s' % (item.x, item.y, item.r, item.unit, item.fill)]
+    if isinstance(item, parts.Rect):
+        tail = ' %d 1 0 %s' % (item.unit, item.fill)
+        x1, y1, x2, y2 = item.x1, item.y1, item.x2, item.y2
+        return ['S %d %d %d %d' % c + tail
+                for c in ((x1, y1, x2, y2), (x1, y2, x2, y1), (x2, y1, x1, y2), (x2, y2, x1, y1))]
+    if isinstance(item, parts.Poly):
+        head = 'P %d %d 1 0 ' % (len(item.points), item.unit)
+        return [head + ' '.join('%d %d' % p for p in pts) + ' ' + item.fill
+                for pts in (item.points, item.points[::-1])]
+    pin = 'X %s %s %d %d 100 %s 50 %d 1 1 %s' % (
+        item.name, item.number, item.x, item.y, item.direction, item.name_size, item.type)
+    return [pin + ' N' if item.type == 'N' else pin]
+
+
+def symbolElements(sym):
+    items = [sym.body] + list(sym.art)
+    items.sort(key=lambda item: TYPE_ORDER[type(item)])
+    items += sorted(sym.pins, key=lambda p: p.number)
+    return [drawItem(item) for item in items]
+
+
+def symbol(sym, old):
+    def fieldLine(n, text, f, visible):
+        return 'F%d "%s" %d %d %d H %s %s CNN' % (
+            n, text, f.x, f.y, f.size, 'V' if visible else 'I', f.justify)
+    lines = [
+        '#',
+        '# ' + sym.name,
+        '#',
+        'DEF %s D 0 40 Y Y 1 F N' % sym.name,
+        fieldLine(0, 'D', sym.reference, True),
+        fieldLine(1, sym.name, sym.value, True),
+        fieldLine(2, '%s:%s' % (LIBRARY, sym.footprint), sym.footprint_at, False),
+        fieldLine(3, '', sym.datasheet_at, False),
+    ]
+    if sym.aliases:
+        lines.append('ALIAS ' + ' '.join(a.name for a in sym.aliases))
+    lines.append('DRAW')
+    lines += arrange(symbolElements(sym), old)
+    lines += ['ENDDRAW', 'ENDDEF']
+    return sym.name, '\n'.join(lines) + '\n'
+
+
+def oldDrawings(text):
+    """{symbol name: its DRAW lines} from a .lib file."""
+    out = {}
+    name = None
+    for line in (text or '').splitlines():
+        if line.startswith('DEF '):
+            name = line.split()[1]
+            out[name] = []
+        elif line in ('DRAW', 'ENDDRAW', 'ENDDEF'):
+            continue
+        elif name and line[:2] in ('C ', 'S ', 'P ', 'X ', 'A ', 'T '):
+            out[name].append(line)
+    return out
+
+
+def library(blocks):
+    return ('EESchema-LIBRARY Version 2.4\n#encoding utf-8\n' +
+            ''.join(text for _, text in sorted(blocks)) + '#\n#End Library\n')
+
+
+def documentation(symbols):
+    entries = sorted(d for sym in symbols for d in parts.docs(sym))
+    out = ['EESchema-DOCLIB  Version 2.0']
+    for name, descr, datasheet in entries:
+        out += ['#', '$CMP ' + name, 'D ' + descr]
+        if datasheet:
+            out.append('F ' + datasheet)
+        out.append('$ENDCMP')
+    out += ['#', '#End Doc Library']
+    return '\n'.join(out) + '\n'
+
+
+# --- checks ---
+
+def validate(footprints, symbols):
+    errors = []
+    by_name = {fp.name: fp for fp in footprints}
+    names = {}
+    for sym in symbols:
+        for name, _, _ in parts.docs(sym):
+            if name in names:
+                errors.append('%s: also an alias of %s' % (name, names[name]))
+            names[name] = sym.name
+        fp = by_name.get(sym.footprint)
+        if fp is None:
+            errors.append('%s: no footprint %s' % (sym.name, sym.footprint))
+            continue
+        numbers = sorted(int(p.number) for p in sym.pins)
+        if numbers != list(range(1, fp.pins + 1)):
+            errors.append('%s: pins are not 1..%d of %s' % (sym.name, fp.pins, fp.name))
+        no_pin = {int(p.number) for p in sym.pins if p.name == 'no_pin'}
+        if no_pin != set(fp.missing):
+            errors.append('%s: no_pin %s, but %s has no holes at %s' % (
+                sym.name, sorted(no_pin), fp.name, sorted(fp.missing)))
+    return errors
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.split('\n\n')[0].strip())
+    ap.add_argument('--check', action='store_true',
+                    help='write nothing; fail if any file would change')
+    ap.add_argument('--jobs', '-j', type=int, default=os.cpu_count())
+    ap.add_argument('-v', '--verbose', action='store_true')
+    args = ap.parse_args()
+    start = time.monotonic()
+
+    footprints = []
+    for fp in parts.FOOTPRINTS:
+        footprints.append(fp)
+        if fp.missing and fp.dip_tedit:
+            footprints.append(parts.dip(fp))
+    errors = validate(parts.FOOTPRINTS, parts.SYMBOLS)
+    if errors:
+        sys.exit('libgen: ' + '\nlibgen: '.join(errors))
+
+    lib_path = os.path.join(ROOT, LIBRARY + '.lib')
+    dcm_path = os.path.join(ROOT, LIBRARY + '.dcm')
+    drawings = oldDrawings(read(lib_path))
+    with concurrent.futures.ProcessPoolExecutor(args.jobs) as pool:
+        fps = [pool.submit(footprint, fp) for fp in footprints]
+        syms = [pool.submit(symbol, sym, drawings.get(sym.name, [])) for sym in parts.SYMBOLS]
+        outputs = [f.result() for f in fps]
+        outputs.append((lib_path, library(f.result() for f in syms)))
+    outputs.append((dcm_path, documentation(parts.SYMBOLS)))
+
+    changed = []
+    for path, text in outputs:
+        old = read(path)
+        if old == text:
+            continue
+        changed.append(path)
+        rel = os.path.relpath(path, ROOT)
+        if args.check:
+            diff = difflib.unified_diff((old or '').splitlines(), text.splitlines(),
+                                        rel, rel + ' (generated)', lineterm='', n=0)
+            print('\n'.join(list(diff)[:20]))
+        else:
+            with open(path, 'w', encoding='utf-8', newline='') as f:
+                f.write(text)
+            print('wrote', rel)
+    if args.verbose:
+        print('%d files, %d changed, %.0f ms' % (
+            len(outputs), len(changed), (time.monotonic() - start) * 1000))
+    if args.check and changed:
+        sys.exit('libgen: %d file(s) differ from the part table' % len(changed))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,532 @@
+"""
+The part table for the Display_IntelligentAlpha library.
+
+Every footprint, symbol and documentation entry in the library is made
+from this table by libgen.py; edit it here, then regenerate.
+
+Footprints are DIPs: pin 1 is at the origin, pins run along +x at the
+pin pitch and come back along the second row, row_spacing above.  Pins
+listed in `missing` are not populated; a footprint with missing pins
+also gets a _DIPnn twin with holes in every position (for sockets), if
+it is given a `dip_tedit`.  The body outline is a rectangle (left, top,
+right, bottom) with the pin-1 corner cut off by `chamfer`.
+
+Symbols are drawn from glyph cells (segments() or dot_matrix()) inside
+a body rectangle; pins are a table of "number name x y direction type".
+Aliases share the symbol's description, with their color put where the
+{} is.
+"""
+
+from collections import namedtuple
+
+
+# --- footprints ---
+
+Footprint = namedtuple('Footprint', [
+    'name', 'tedit', 'descr', 'tags', 'pins', 'row_spacing', 'body', 'ref',
+    'value', 'user', 'pitch', 'chamfer', 'missing', 'dividers', 'courtyard',
+    'dip_tedit'], defaults=[2.54, 2.54, (), (), True, None])
+
+
+def dip(fp):
+    """The twin of fp with every hole populated."""
+    return fp._replace(name='%s_DIP%d' % (fp.name, fp.pins), tedit=fp.dip_tedit,
+                       descr='%s (dual %d-hole rows)' % (fp.descr, fp.pins // 2),
+                       missing=(), dip_tedit=None)
+
+
+# --- symbols ---
+
+Circle = namedtuple('Circle', 'x y r unit fill')
+Rect = namedtuple('Rect', 'x1 y1 x2 y2 unit fill')
+Poly = namedtuple('Poly', 'points unit fill')
+Pin = namedtuple('Pin', 'number name x y direction type name_size')
+Alias = namedtuple('Alias', 'name color datasheet')
+Field = namedtuple('Field', 'x y justify size', defaults=['C', 50])
+
+Symbol = namedtuple('Symbol', [
+    'name', 'footprint', 'descr', 'datasheet', 'reference', 'value',
+    'footprint_at', 'datasheet_at', 'body', 'art', 'pins', 'aliases'],
+    defaults=[()])
+
+
+def docs(sym):
+    """(name, description, datasheet) of a symbol and its aliases."""
+    yield sym.name, sym.descr.format(''), sym.datasheet
+    for a in sym.aliases:
+        yield a.name, sym.descr.format(a.color + ' ' if a.color else ''), a.datasheet
+
+
+def pins(table):
+    """Parses a pin table: "number name x y direction type [name size]"."""
+    out = []
+    for line in table.strip().splitlines():
+        f = line.split()
+        out.append(Pin(f[0], f[1], int(f[2]), int(f[3]), f[4], f[5],
+                       int(f[6]) if len(f) > 6 else 50))
+    return out
+
+
+def aliases(datasheet, *entries):
+    """Aliases sharing a datasheet, from (name, color) pairs."""
+    return [Alias(name, color, datasheet) for name, color in entries]
+
+
+def cells(n, pitch, center=0):
+    """x of the centers of n character cells."""
+    return [center + pitch*i - pitch*(n - 1)//2 for i in range(n)]
+
+
+def segments(template, n, pitch=300):
+    """n segmented digits, each drawn from template inside a circle."""
+    art = []
+    for x in cells(n, pitch):
+        art.append(Circle(x, 0, 150, 0, 'N'))
+        for item in template:
+            if isinstance(item, Rect):
+                art.append(item._replace(x1=item.x1 + x, x2=item.x2 + x))
+            else:
+                art.append(item._replace(points=tuple((px + x, py) for px, py in item.points)))
+    return art
+
+
+def dot_matrix(n, pitch, center=0, unit=1):
+    """n 5x7 dot matrix characters."""
+    art = []
+    for x in cells(n, pitch, center):
+        for col in range(5):
+            for row in range(7):
+                left, bottom = x - 70 + 30*col, -100 + 30*row
+                art.append(Rect(left, bottom, left + 20, bottom + 20, unit, 'N'))
+    return art
+
+
+def seg(x1, y1, x2, y2):
+    return Poly(((x1, y1), (x2, y2)), 0, 'N')
+
+
+SEG16 = [
+    seg(-80, -100, 60, -100), seg(-70, 0, 70, 0), seg(-60, 100, -80, -100),
+    seg(-60, 100, 60, -100), seg(-60, 100, 80, 100), seg(10, 100, -10, -100),
+    seg(80, 100, -80, -100), seg(80, 100, 60, -100),
+]
+DECIMAL = [Rect(0, -90, 10, -80, 0, 'F')]
+UNDERLINE = [seg(-70, -120, 50, -120)]
+SEG22 = [
+    seg(-60, 100, 80, 100),
+    seg(-80, -60, 60, -60), seg(-80, -60, 80, 100), seg(-70, 20, -10, -60),
+    seg(-70, 20, 70, 20), seg(-65, -110, -15, -110), seg(-60, 100, -80, -60),
+    seg(-60, 100, 60, -60), seg(10, 100, -15, -110), seg(35, -110, -15, -110),
+    seg(80, 100, 60, -60),
+    Rect(-30, -80, -20, -70, 0, 'F'), Rect(-10, 90, 0, 80, 0, 'F'),
+]
+
+
+# --- the table ---
+
+DIP_600 = 'THT DIP DIL PDIP 2.54mm 15.24mm 600mil'
+
+FOOTPRINTS = [
+    Footprint('DL1414', '5E113150',
+              '.112" Red, 4-Character 16 Segment Plus Decimal Alphanumeric Intelligent Display With Memory/Decoder/Driver',
+              DIP_600, pins=12, row_spacing=15.24, body=(-2.54, -17.78, 15.24, 2.54),
+              ref=(6.35, -7.62, 180), value=(11.43, -7.62, 90), user=(13.97, -7.62, 90)),
+    Footprint('DL1416', '5E113157',
+              '.160" Red, 4-Digit 16-Segment Alphanumeric Intelligent Display With Memory/Decoder/Driver',
+              'THT DIP DIL PDIP 2.54mm 7.62mm 300mil', pins=20, row_spacing=27.94,
+              body=(-1.27, -29.21, 24.13, 1.27), chamfer=0.635, dividers=(-10.16, -25.4),
+              courtyard=False,
+              ref=(11.43, -18.415, 180), value=(20.955, -19.05, 90), user=(22.86, -19.05, 90)),
+    Footprint('DL1814', '5E113160',
+              '.112" Red, 8-Digit 17-Segment Alphanumeric Intelligent Display',
+              DIP_600, pins=26, row_spacing=22.86, missing=range(15, 26), dip_tedit='5E113166',
+              body=(-2.54, -25.273, 33.02, 2.413), dividers=(-21.59, -8.89),
+              ref=(15.24, -15.24, 180), value=(29.21, -15.24, 90), user=(31.75, -15.24, 90)),
+    Footprint('DL2416', '5E113172',
+              '.160" Red, 4-Character 16 Segment Plus Decimal Alphanumeric Intelligent Display With Memory/Decoder/Driver',
+              DIP_600, pins=18, row_spacing=15.24, body=(-2.54, -17.78, 22.86, 2.54),
+              ref=(10.16, -7.62, 180), value=(19.05, -7.62, 90), user=(21.59, -7.62, 90)),
+    Footprint('DL34xx', '5E113146',
+              '.225"/.170" Red, 4-Digit 16-Segment Plus Decimal/22-Segment Alphanumeric Intelligent Display With Memory/Decoder/Driver',
+              DIP_600, pins=22, row_spacing=15.24, body=(-3.683, -17.653, 29.083, 2.413),
+              ref=(13.97, -7.62, 180), value=(25.4, -7.62, 90), user=(27.94, -7.62, 90)),
+    Footprint('HDSP-21xx', '5E113178', '0.2" Eight Character Alphanumeric Display',
+              DIP_600 + ' Socket', pins=28, row_spacing=15.24, missing=(21, 22),
+              dip_tedit='5E11317E', body=(-4.7879, -17.4879, 37.8079, 2.1717),
+              ref=(16.51, -7.62), value=(34.29, -7.62, 90), user=(36.83, -7.62, 90)),
+    Footprint('HDSP-250x', '5E113184', '0.27" Eight Character Alphanumeric Display',
+              DIP_600 + ' Socket', pins=28, row_spacing=15.24, missing=(21, 22),
+              dip_tedit='5E11318C', body=(-18.923, -17.3228, 51.943, 2.0828),
+              ref=(16.51, -7.62), value=(48.26, -7.62, 90), user=(50.8, -7.62, 90)),
+    Footprint('PD2816', '5E1131B0',
+              '.112" Red, 8-Digit, 18-Segment Including Decimal Alphanumeric Programmable Display With Built In CMOS Control Functions',
+              DIP_600, pins=24, row_spacing=15.24, body=(-11.43, -20.32, 39.37, 5.08),
+              ref=(13.97, -7.62, 180), value=(35.56, -7.62, 90), user=(38.1, -7.62, 90)),
+    Footprint('PDSP188x', '5E3E0591',
+              '.180" 8-Character 5x7 Dot Matrix Alphanumeric Programmable Display',
+              'DIL DIP PDIP 2.54mm 7.62mm 300mil', pins=30, row_spacing=7.62,
+              missing=(7, 8, 9, 22, 23, 24), dip_tedit='5E13D231',
+              body=(-3.683, -9.525, 39.243, 1.905),
+              ref=(19.05, -3.81, 180), value=(34.925, -3.81, 180), user=(27.94, -3.81, 180)),
+]
+
+
+DL1414_PINS = pins('''
+    1   D5        300  -500 U I
+    2   D4        200  -500 U I
+    3   ~WR      -500  -500 U I
+    4   A1       -300  -500 U I
+    5   A0       -400  -500 U I
+    6   VCC      -500   550 D W
+    7   GND       500  -500 U W
+    8   D0       -200  -500 U I
+    9   D1       -100  -500 U I
+    10  D2          0  -500 U I
+    11  D3        100  -500 U I
+    12  D6        400  -500 U I
+''')
+
+DL1416_PINS = pins('''
+    1   D5        300  -800 U I
+    2   D4        200  -800 U I
+    3   D0       -200  -800 U I
+    4   D1       -100  -800 U I
+    5   D2          0  -800 U I
+    6   D3        100  -800 U I
+    7   ~CE       -50   550 D I
+    8   ~W       -500  -800 U I
+    9   ~CU        50   550 D I
+    10  A0       -400  -800 U I
+    11  A1       -300  -800 U I
+    12  nc        700   350 L N
+    13  nc        700   250 L N
+    14  nc        700  -200 L N
+    15  nc        700  -300 L N
+    16  nc        700  -400 L N
+    17  nc        700  -500 L N
+    18  VCC      -500   550 D W
+    19  GND       500  -800 U W
+    20  D6        400  -800 U I
+''')
+
+DL1814_PINS = pins('''
+    1   D0        -50  -800 U I
+    2   D1         50  -800 U I
+    3   D2        150  -800 U I
+    4   D3        250  -800 U I
+    5   D4        350  -800 U I
+    6   D5        450  -800 U I
+    7   D6        550  -800 U I
+    8   GND      1100  -800 U W
+    9   A0       -450  -800 U I
+    10  A1       -350  -800 U I
+    11  A2       -250  -800 U I
+    12  ~WR      -550  -800 U I
+    13  VCC     -1100   550 D W
+    14  ~BL        50   550 D I
+    15  no_pin    350   550 D N
+    16  no_pin    400   550 D N
+    17  no_pin    450   550 D N
+    18  no_pin    500   550 D N
+    19  no_pin    550   550 D N
+    20  no_pin    600   550 D N
+    21  no_pin    650   550 D N
+    22  no_pin    700   550 D N
+    23  no_pin    750   550 D N
+    24  no_pin    800   550 D N
+    25  no_pin    850   550 D N
+    26  ~CE       -50   550 D I
+''')
+
+DL2416_PINS = pins('''
+    1   ~CE1     -250   550 D I
+    2   ~CE2     -150   550 D I
+    3   ~CLR      -50   550 D I
+    4   CUE       250   550 D I
+    5   ~CU       150   550 D I
+    6   ~WR      -500  -500 U I
+    7   A1       -300  -500 U I
+    8   A0       -400  -500 U I
+    9   VCC      -500   550 D W
+    10  GND       500  -500 U W
+    11  D0       -200  -500 U I
+    12  D1       -100  -500 U I
+    13  D2          0  -500 U I
+    14  D3        100  -500 U I
+    15  D6        400  -500 U I
+    16  D5        300  -500 U I
+    17  D4        200  -500 U I
+    18  ~BL        50   550 D I
+''')
+
+DL3416_PINS = pins('''
+    1   CE1      -350   550 D I
+    2   CE2      -250   550 D I
+    3   ~CE3     -150   550 D I
+    4   ~CE4      -50   550 D I
+    5   ~CLR       50   550 D I
+    6   VCC      -500   550 D W
+    7   A0       -400  -500 U I
+    8   A1       -300  -500 U I
+    9   ~WR      -500  -500 U I
+    10  ~CU       250   550 D I
+    11  CUE       350   550 D I
+    12  GND       500  -500 U W
+    13  nc        700   300 L N
+    14  ~BL       150   550 D I
+    15  nc        700   200 L N
+    16  D0       -200  -500 U I
+    17  D1       -100  -500 U I
+    18  D2          0  -500 U I
+    19  D3        100  -500 U I
+    20  D4        200  -500 U I
+    21  D5        300  -500 U I
+    22  D6        400  -500 U I
+''')
+
+DL3422_PINS = pins('''
+    1   CE1      -250   550 D I
+    2   nc        700  -200 L N
+    3   ~CE2     -150   550 D I
+    4   nc        700  -300 L N
+    5   ~CLR      -50   550 D I
+    6   VCC      -500   550 D W
+    7   A0       -400  -500 U I
+    8   A1       -300  -500 U I
+    9   ~WR      -500  -500 U I
+    10  ~CU       150   550 D I
+    11  CUE       250   550 D I
+    12  GND       500  -500 U W
+    13  nc        700   300 L N
+    14  ~BL        50   550 D I
+    15  nc        700   200 L N
+    16  D0       -200  -500 U I
+    17  D1       -100  -500 U I
+    18  D2          0  -500 U I
+    19  D3        100  -500 U I
+    20  D4        200  -500 U I
+    21  D5        300  -500 U I
+    22  D6        400  -500 U I
+''')
+
+HDSP21XX_PINS = pins('''
+    1   ~RST     -150   550 D I
+    2   ~FL      -650  -500 U I
+    3   A0       -550  -500 U I
+    4   A1       -450  -500 U I
+    5   A2       -350  -500 U I
+    6   A3       -250  -500 U I
+    7   nc       1150   350 L N
+    8   nc       1150   300 L N
+    9   nc       1150   250 L N
+    10  A4       -150  -500 U I
+    11  CLS        50   550 D I
+    12  CLK       150   550 D B
+    13  ~WR      -750  -500 U I
+    14  VCC      -900   550 D W
+    15  SGND      850  -500 U W
+    16  LGND      950  -500 U W
+    17  ~CE       -50   550 D I
+    18  ~RD      -850  -500 U I
+    19  D0        -50  -500 U B
+    20  D1         50  -500 U B
+    21  no_pin   1150   200 L N
+    22  no_pin   1150   150 L N
+    23  D2        150  -500 U B
+    24  D3        250  -500 U B
+    25  D4        350  -500 U B
+    26  D5        450  -500 U B
+    27  D6        550  -500 U B
+    28  D7        650  -500 U B
+''')
+
+HDSP250X_PINS = pins('''
+    1   ~RST     -150   550 D I
+    2   ~FL      -750  -500 U I
+    3   A0       -650  -500 U I
+    4   A1       -550  -500 U I
+    5   A2       -450  -500 U I
+    6   A3       -350  -500 U I
+    7   nc       1300   350 L N
+    8   nc       1300   300 L N
+    9   nc       1300   250 L N
+    10  A4       -250  -500 U I
+    11  CLS        50   550 D I
+    12  CLK       150   550 D B
+    13  ~WR     -1000  -500 U I
+    14  VCC     -1100   550 D W
+    15  SGND     1000  -500 U W
+    16  LGND     1100  -500 U W
+    17  ~CE       -50   550 D I
+    18  ~RD     -1100  -500 U I
+    19  D0          0  -500 U B
+    20  D1        100  -500 U B
+    21  no_pin   1300   200 L N
+    22  no_pin   1300   150 L N
+    23  D2        200  -500 U B
+    24  D3        300  -500 U B
+    25  D4        400  -500 U B
+    26  D5        500  -500 U B
+    27  D6        600  -500 U B
+    28  D7        700  -500 U B
+''')
+
+PD2816_PINS = pins('''
+    1   ~RST     -300   550 D I
+    2   A0       -650  -550 U I
+    3   A1       -550  -550 U I
+    4   A2       -450  -550 U I
+    5   A3       -350  -550 U I
+    6   ~CE0     -200   550 D I
+    7   CE1      -100   550 D I
+    8   CLK       100   550 D B
+    9   CLS         0   550 D I
+    10  ~RD     -1100  -550 U I
+    11  OSCADJ    200   550 D I 39
+    12  GND      1100  -550 U W
+    13  DIM       300   550 D I
+    14  ~WR     -1000  -550 U I
+    15  D0          0  -550 U B
+    16  D1        100  -550 U B
+    17  D2        200  -550 U B
+    18  D3        300  -550 U B
+    19  D4        400  -550 U B
+    20  D5        500  -550 U B
+    21  D6        600  -550 U B
+    22  D7        700  -550 U B
+    23  VCC     -1100   550 D W
+    24  VCC     -1000   550 D W
+''')
+
+PDSP188X_PINS = pins('''
+    1   ~RST     -150   550 D I
+    2   ~FL      -750  -500 U I
+    3   A0       -650  -500 U I
+    4   A1       -550  -500 U I
+    5   A2       -450  -500 U I
+    6   A3       -350  -500 U I
+    7   no_pin   1300   350 L N
+    8   no_pin   1300   300 L N
+    9   no_pin   1300   250 L N
+    10  A4       -250  -500 U I
+    11  CLS        50   550 D I
+    12  CLK       150   550 D B
+    13  ~WR     -1000  -500 U I
+    14  ~CE       -50   550 D I
+    15  VCC     -1100   550 D W
+    16  SGND     1000  -500 U W
+    17  nc       1300   200 L N
+    18  LGND     1100  -500 U W
+    19  ~RD     -1100  -500 U I
+    20  D0          0  -500 U B
+    21  D1        100  -500 U B
+    22  no_pin   1300   150 L N
+    23  no_pin   1300   100 L N
+    24  no_pin   1300    50 L N
+    25  D2        200  -500 U B
+    26  D3        300  -500 U B
+    27  D4        400  -500 U B
+    28  D5        500  -500 U B
+    29  D6        600  -500 U B
+    30  D7        700  -500 U B
+''')
+
+
+SIEMENS_1990 = 'http://www.bitsavers.org/components/siemens/1990_Siemens_Optoelectronics_Data_Book.pdf'
+DL1414_PDF = 'http://www.decadecounter.com/vta/pdf/DL1414.pdf'
+DL2416_PDF = 'http://www.decadecounter.com/vta/pdf/DL2416.pdf'
+HPDL1414_PDF = 'http://pdf.datasheetcatalog.com/datasheet/hp/HPDL-1414.pdf'
+HDSP2XXX_PDF = 'https://docs.broadcom.com/docs/AV02-0629EN'
+
+BODY_4 = Rect(-600, 450, 600, -400, 0, 'f')
+BODY_8 = Rect(-1200, 450, 1200, -400, 0, 'f')
+WINDOW_4 = Rect(-600, 150, 600, -150, 1, 'N')
+WINDOW_8 = Rect(-1200, 150, 1200, -150, 1, 'N')
+
+SYMBOLS = [
+    Symbol('DL1414', 'DL1414',
+           '.112" Red, 4-Digit 17-Segment Alphanumeric Intelligent Display With Memory/Decoder/Driver',
+           DL1414_PDF, Field(600, 500, 'R'), Field(400, 500, 'R'), Field(-250, 600), Field(-250, 600),
+           BODY_4, segments(SEG16 + DECIMAL, 4), DL1414_PINS,
+           [Alias('HPDL-1414', None, HPDL1414_PDF), Alias('DL1414T', None, DL1414_PDF)]),
+    Symbol('DL1416', 'DL1416',
+           '.160" Red, 4-Digit 16-Segment Alphanumeric Intelligent Display With Memory/Decoder/Driver',
+           SIEMENS_1990, Field(550, 500), Field(400, 500, 'R'), Field(-150, 600), Field(-150, 600),
+           Rect(-600, 450, 600, -700, 0, 'f'), segments(SEG16, 4), DL1416_PINS,
+           [Alias('DL1416B', None, SIEMENS_1990), Alias('SP1-16', None, None)]),
+    Symbol('DL1814', 'DL1814',
+           '.112" Red, 8-Digit 17-Segment Alphanumeric Intelligent Display With Memory/Decoder/Driver',
+           SIEMENS_1990, Field(1200, 500, 'R'), Field(1000, 500, 'R'), Field(-850, 600), Field(-850, 600),
+           Rect(-1200, 450, 1200, -700, 0, 'f'), segments(SEG16 + DECIMAL, 8), DL1814_PINS),
+    Symbol('DL2416', 'DL2416',
+           '.160" Red, 4-Digit 16-Segment Plus Decimal Alphanumeric Intelligent Display With Memory/Decoder/Driver',
+           DL2416_PDF, Field(600, 600, 'R'), Field(600, 500, 'R'), Field(-300, 600), Field(-300, 600),
+           BODY_4, segments(SEG16 + DECIMAL, 4), DL2416_PINS,
+           [Alias('DL2416T', None, DL2416_PDF), Alias('HPDL-2416', None, HPDL1414_PDF),
+            Alias('DL2416H', None, DL2416_PDF)]),
+    Symbol('DL3416', 'DL34xx',
+           '.225" Red, 4-Digit 16-Segment Plus Decimal Alphanumeric Intelligent Display With Memory/Decoder/Driver',
+           SIEMENS_1990, Field(600, 600, 'R'), Field(600, 500, 'R', 39), Field(-50, 600), Field(-250, 600),
+           BODY_4, segments(SEG16 + DECIMAL, 4), DL3416_PINS),
+    Symbol('DL3422', 'DL34xx',
+           '.170"/.100" (nom.) Upper And Lower Case 4-Digit 22-Segment Alphanumeric Intelligent Display With Memory/Decoder/Driver',
+           'http://bitsavers.trailing-edge.com/components/litronix/_dataBooks/1982_Litronix_Optoelectronics_Catalog.pdf',
+           Field(600, 600, 'R'), Field(600, 500, 'R'), Field(-50, 600), Field(-250, 600),
+           BODY_4, segments(SEG22, 4), DL3422_PINS),
+    Symbol('DLx1414', 'DL1414',
+           '.145" {}4-Digit, Dot Matrix Alphanumeric Intelligent Display With Memory/Decoder/Driver',
+           'http://pdf.datasheetcatalog.com/datasheet/siemens/DLO1414.pdf',
+           Field(600, 500, 'R'), Field(400, 500, 'R'), Field(-250, 600), Field(-250, 600),
+           BODY_4, [WINDOW_4] + dot_matrix(4, 300), DL1414_PINS,
+           aliases('http://pdf.datasheetcatalog.com/datasheet/siemens/DLO1414.pdf',
+                   ('DLR1414', 'Red,'), ('DLO1414', 'High Efficiency Red,'), ('DLG1414', 'Green,')) +
+           aliases('https://docs.broadcom.com/docs/AV02-3611EN',
+                   ('HDLS-1414', 'Red,'), ('HDLO-1414', 'High Efficiency Red,'), ('HDLA-1414', 'Orange,'),
+                   ('HDLY-1414', 'Yellow,'), ('HDLG-1414', 'Green,'), ('HDLU-1414', 'Low Power Red,'))),
+    Symbol('DLx2416', 'DL2416',
+           '.200" {}4-Digit 5x7 Dot Matrix Alphanumeric Intelligent Display with Memory/Decoder/Driver',
+           'http://pdf.datasheetcatalog.com/datasheet/siemens/DLG2416.pdf',
+           Field(600, 600, 'R'), Field(600, 500, 'R'), Field(-250, 600), Field(-250, 600),
+           BODY_4, [WINDOW_4._replace(unit=0)] + dot_matrix(4, 300, unit=0), DL2416_PINS,
+           aliases('http://pdf.datasheetcatalog.com/datasheet/siemens/DLG2416.pdf',
+                   ('DLG2416', 'Green,'), ('DLO2416', 'High Efficiency Red,'), ('DLR2416', 'Red,')) +
+           aliases('https://docs.broadcom.com/docs/AV02-0662EN',
+                   ('HDLS-2416', 'Red,'), ('HDLO-2416', 'High Efficiency Red,'), ('HDLA-2416', 'Orange,'),
+                   ('HDLG-2416', 'Green,'), ('HDLU-2416', 'Low Power Red,'))),
+    Symbol('DLx3416', 'DL34xx',
+           '.270" {}4-Digit Dot Matrix Alphanumeric Intelligent Display With Memory/Decoder/Driver',
+           'http://pdf.datasheetcatalog.com/datasheet/siemens/DLO3416.pdf',
+           Field(600, 600, 'R'), Field(600, 500, 'R', 31), Field(-50, 600), Field(-250, 600),
+           BODY_4, [WINDOW_4] + dot_matrix(4, 300), DL3416_PINS,
+           aliases('http://pdf.datasheetcatalog.com/datasheet/siemens/DLO3416.pdf',
+                   ('DLR3416', 'Red,'), ('DLO3416', 'High Efficiency Red,'), ('DLG3416', 'Green,')) +
+           aliases('https://docs.broadcom.com/docs/AV02-3642EN',
+                   ('HDLO-3416', 'High Efficiency Red,'), ('HDLA-3416', 'Orange,'),
+                   ('HDLY-3416', 'Yellow,'), ('HDLG-3416', 'Green,'))),
+    Symbol('HDSP-21xx', 'HDSP-21xx', '{}Eight-Character 5mm Smart Alphanumeric Display', HDSP2XXX_PDF,
+           Field(1050, 500, 'R'), Field(850, 500, 'R'), Field(-600, 600), Field(-1000, 600),
+           Rect(-1000, 450, 1050, -400, 0, 'f'),
+           [Rect(-1000, 150, 1050, -150, 1, 'N')] + dot_matrix(8, 250, center=25), HDSP21XX_PINS,
+           aliases(HDSP2XXX_PDF, ('HDSP-2107', 'Deep Red'), ('HDSP-2112', 'Red'), ('HDSP-2110', 'Orange'),
+                   ('HDSP-2111', 'Yellow'), ('HDSP-2113', 'Green'))),
+    Symbol('HDSP-250x', 'HDSP-250x', '{}Eight-Character 7mm Smart Alphanumeric Display', HDSP2XXX_PDF,
+           Field(1200, 500, 'R'), Field(1000, 500, 'R'), Field(-600, 600), Field(-850, 600),
+           BODY_8, [WINDOW_8] + dot_matrix(8, 300), HDSP250X_PINS,
+           aliases(HDSP2XXX_PDF, ('HDSP-2504', 'Deep Red'), ('HDSP-2502', 'Red'), ('HDSP-2500', 'Orange'),
+                   ('HDSP-2501', 'Yellow'), ('HDSP-2503', 'Green'))),
+    Symbol('PD2816', 'PD2816',
+           '.112" Red, 8-Digit, 18-Segment Including Decimal Alphanumeric Programmable Display With Built In CMOS Control Functions',
+           'http://www.bitsavers.org/components/siemens/1985_Siemens_Optoelectronics_Catalog.pdf',
+           Field(1200, 500, 'R'), Field(1000, 500, 'R'), Field(-850, 600), Field(-850, 600),
+           Rect(-1200, 450, 1200, -450, 0, 'f'), segments(SEG16 + DECIMAL + UNDERLINE, 8), PD2816_PINS),
+    Symbol('PDSP188x', 'PDSP188x', '.180" {}8-Character 5x7 Dot Matrix Alphanumeric Programmable Display',
+           'https://www.mouser.com/datasheet/2/311/00036139_0-280291.pdf',
+           Field(1200, 500, 'R'), Field(1000, 500, 'R'), Field(-600, 600), Field(-850, 600),
+           BODY_8, [WINDOW_8] + dot_matrix(8, 300), PDSP188X_PINS,
+           aliases('https://www.mouser.com/datasheet/2/311/00036139_0-280291.pdf',
+                   ('PDSP1880', 'Red,'), ('PDSP1881', 'Yellow,'), ('PDSP1882', 'High Efficiency Red,'),
+                   ('PDSP1883', 'Green,'), ('PDSP1884', 'High Efficiency Green,')) +
+           aliases('https://docs.broadcom.com/docs/AV02-2018EN',
+                   ('HDSP-2534', 'Red,'), ('HDSP-2532', 'High Efficiency Red,'), ('HDSP-2530', 'Orange,'),
+                   ('HDSP-2531', 'Yellow,'), ('HDSP-2533', 'Green,'))),
+]